@@ -5,6 +5,13 @@
 #include "scene.h"
 #include "game_state.h"
 #include "input.h"
+#include "input_record.h"
+#include "frame_pacing.h"
+#include "dynamic_resolution.h"
+#include "shader_manager.h"
+#include "frame_uniforms.h"
+#include "render_snapshot.h"
+#include "job_system.h"
 
 #include <SDL2/SDL.h>
 #include <glad/glad.h>
@@ -15,45 +22,56 @@
 #define VIEWPORT_RATIO (4.0 / 3.0)
 #define VIEWPORT_ASPECT 50.0
 
+// Reactive rendering: frames still drawn after the last change (ImGui settles its layout over a few),
+// and the longest the loop sleeps without events while idle (ms)
+#define APP_REDRAW_FRAMES 3
+#define APP_IDLE_TIMEOUT 250
+
 typedef struct App
 {
     SDL_Window* window;
     SDL_GLContext gl_context;
     bool is_running;
     double uptime;
+    int redraw_frames; // Frames left to render; 0 means the screen is up to date and the loop idles
+    Uint64 frame_start_counter; // Performance counter at the start of update_app, for the frame metrics
     
     Camera camera;
     Scene scene;
     GameState game_state;
     InputState input_state;
+    InputRecorder input_recorder; // --record / --replay sessions (see input_record.h)
+    FramePacer frame_pacer; // Vsync, frame limiter and input latency (see frame_pacing.h)
+    DynamicResolution dynamic_resolution; // Scaled 3D pass of the window (see dynamic_resolution.h)
+
+    // Simulation and rendering: the render code only reads snapshots (see step_app_simulation)
+    RenderSnapshotBuffer snapshots;
+    bool pipelined; // The next step runs on a worker while the main thread draws the last one
+    JobCounter simulation_counter;
+    float simulation_dt;
+    GamePhase simulation_phase;
+    int pending_ui_actions; // Shop and combat buttons of the last drawn frame, applied once the step finished
     
-    GLuint shader_program;
+    ShaderManager shader_manager;
+    int main_shader; // simple.vert + simple.frag, drawn through its variants
+    int shadow_shader; // Depth-only casters of the shadow map, -1 without shadows
+    int particle_shader; // Billboards of the particle system, -1 without particles
+    int health_bar_shader; // World-space HP bars, -1 without them
+    int board_overlay_shader; // Per-tile highlights, -1 without them
+    int combat_text_shader; // Floating damage numbers, -1 without them
+    GLuint frame_uniform_buffer;
     mat4 projection_matrix;
     mat4 view_matrix;
     
-    GLint shader_uloc_projection;
-    GLint shader_uloc_view;
-    GLint shader_uloc_model;
-    GLint shader_uloc_texture1;
-    GLint shader_uloc_color_tint;
-    
     int selected_bench_unit_index;
     
     bool show_help_window;
+    bool show_render_stats_window;
     
     // Lighting
     vec3 light_direction_world;
     vec3 light_color;
     vec3 ambient_light_color;
-
-    
-    GLint shader_uloc_lightDir;
-    GLint shader_uloc_lightColor;
-    GLint shader_uloc_ambientLightColor;
-    GLint shader_uloc_viewPos;
-    GLint shader_uloc_materialDiffuse;
-    GLint shader_uloc_materialSpecular;
-    GLint shader_uloc_materialShininess;
 } App;
 
 /**
@@ -61,6 +79,13 @@ typedef struct App
  */
 void init_app(App* app, int width, int height);
 
+/**
+ * @brief Everything init_app sets up after the window and the GL context: asset pack, shaders,
+ * GL state, game state, camera and scene. Shared with the headless mode (see headless.h).
+ * @return false if the main shader could not be built.
+ */
+bool init_app_resources(App* app, int width, int height);
+
 /**
  * Initialize the OpenGL context.
  */
@@ -76,11 +101,56 @@ void reshape(GLsizei width, GLsizei height);
  */
 void update_app(App* app);
 
+/**
+ * @brief Advances the scene by dt and captures a render snapshot of the result.
+ * Inline, the snapshot is published before returning. Pipelined, the step and the capture run as a
+ * job and the renderer keeps drawing the previous snapshot, so a frame costs max(simulation, render)
+ * instead of their sum and the picture is one step behind. The main thread owns the scene again only
+ * after finish_app_simulation; game_state, the camera and the UI state stay main-thread data throughout.
+ */
+void step_app_simulation(App* app, float dt);
+
+/**
+ * @brief Waits for a pipelined step and publishes its snapshot. Does nothing when none is in flight.
+ */
+void finish_app_simulation(App* app);
+
+/**
+ * @brief Pipelines the simulation when there are job workers and no input recording or replay
+ * (the recorded checksums need the step done before the frame ends).
+ */
+void set_app_pipelined(App* app, bool pipelined);
+
+/**
+ * @brief Recomputes the view and projection matrices for a drawable of the given size.
+ */
+void update_app_matrices(App* app, int width, int height);
+
 /**
  * Render the application.
  */
 void render_app(App* app);
 
+/**
+ * @brief Draws the 3D scene and its overlays (no UI) into the bound framebuffer.
+ */
+void render_app_scene(App* app);
+
+/**
+ * @brief Whether the last update changed anything on screen (input, camera, units, UI, animations in flight).
+ */
+bool should_render_app(const App* app);
+
+/**
+ * @brief Blocks until an event arrives or APP_IDLE_TIMEOUT passes. Called instead of rendering while idle.
+ */
+void wait_for_app_events(App* app);
+
+/**
+ * @brief Releases what init_app_resources created. Needs the GL context still current.
+ */
+void destroy_app_resources(App* app);
+
 /**
  * Destroy the application.
  */
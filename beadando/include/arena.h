@@ -0,0 +1,81 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 16
+
+#define FRAME_ARENA_SIZE (4u << 20)    // Render packets of one drawn frame
+#define ROUND_ARENA_SIZE (1u << 20)    // Data of one combat round (wave spawns, shop rolls)
+#define SCRATCH_ARENA_SIZE (32u << 20) // Loader temporaries; a 1080p capture is 8 MB
+
+/**
+ * Linear allocator over one block reserved up front: allocation bumps an offset, reset drops
+ * everything at once in O(1). Nothing is freed individually, so data whose lifetime ends together
+ * (a frame, a round, a loader call) is allocated from the same arena instead of the heap.
+ * Debug builds (no NDEBUG) keep the high-water mark, printed at shutdown, to size the arenas.
+ * An arena is not thread-safe.
+ */
+typedef struct Arena
+{
+    const char* name;
+    unsigned char* base;
+    size_t capacity;
+    size_t used;
+    size_t peak; // Debug builds only
+} Arena;
+
+/**
+ * Position to rewind to, see begin_scratch.
+ */
+typedef struct ArenaMark
+{
+    size_t used;
+} ArenaMark;
+
+/**
+ * @brief Reserves the block. A failed init leaves an empty arena whose allocations return NULL.
+ */
+bool init_arena(Arena* arena, const char* name, size_t capacity);
+
+void destroy_arena(Arena* arena);
+
+/**
+ * @brief ARENA_ALIGNMENT aligned memory, valid until the arena is reset or rewound past it.
+ * @return NULL if the arena is full; the caller skips the work like on a failed malloc.
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+void reset_arena(Arena* arena);
+
+/**
+ * The arenas of the game, created by init_arenas and used on the main thread only:
+ * - frame: reset by end_arena_frame after every drawn frame
+ * - round: reset when a round is over (PHASE_POST_COMBAT)
+ * - scratch: loader temporaries inside a begin_scratch/end_scratch pair; pairs nest
+ */
+void init_arenas(void);
+void destroy_arenas(void);
+
+Arena* get_frame_arena(void);
+Arena* get_round_arena(void);
+
+ArenaMark begin_scratch(void);
+void* scratch_alloc(size_t size);
+void end_scratch(ArenaMark mark);
+
+/**
+ * @brief Resets the frame arena and records its usage (and the heap allocations, see below) in the frame metrics.
+ * Called right before end_metrics_frame.
+ */
+void end_arena_frame(void);
+
+/**
+ * @brief Heap allocations made by the game's own code since startup, counted in builds linked with
+ * malloc, calloc and realloc wrapped (make ALLOC_CHECK=1). Steady-state frames should not add any.
+ * @return -1 in builds without ALLOC_CHECK.
+ */
+long long get_heap_allocation_count(void);
+
+#endif /* ARENA_H */
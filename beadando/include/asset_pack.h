@@ -0,0 +1,91 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include "file_map.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Asset archive (.pak), written offline by the asset packer (tools/asset_pack.c).
+ *
+ * Layout:
+ *   AssetPackHeader
+ *   AssetPackEntry[entry_count]   sorted by path_hash (binary searched at runtime)
+ *   path strings                  referenced by the entries, not NUL-terminated
+ *   payloads                      each starting on an ASSET_PACK_ALIGNMENT boundary
+ *
+ * Paths are stored exactly as the game asks for them ("assets/models/up.obj", "shaders/simple.vert").
+ * The archive is mapped once; lookups return pointers into the mapping, nothing is copied.
+ * All fields are little-endian.
+ */
+
+#define ASSET_PACK_MAGIC 0x4B415047u /* "GPAK" */
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 64 // Keeps the alignment the cooked containers expect
+
+#define ASSET_PACK_PATH "assets.pak"
+
+typedef struct AssetPackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t entries_offset;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry
+{
+    uint64_t path_hash;   // hash_asset_path of the path
+    uint64_t offset;      // Payload, from the start of the archive
+    uint64_t size;
+    uint64_t path_offset; // Path string, from the start of the archive
+    uint32_t path_length;
+    uint32_t reserved;
+} AssetPackEntry;
+
+/**
+ * Read-only view of an asset, either inside the mounted archive or a mapped loose file.
+ */
+typedef struct AssetData
+{
+    const void* data;
+    size_t size;
+    FileMapping mapping; // Only used for loose files
+} AssetData;
+
+/**
+ * @brief 64-bit FNV-1a hash of an asset path, the key of the archive table of contents.
+ */
+uint64_t hash_asset_path(const char* path);
+
+/**
+ * @brief Maps the archive for the rest of the run. Lookups fall back to loose files without it.
+ * @return true if the archive was found and is valid.
+ */
+bool mount_asset_pack(const char* path);
+
+/**
+ * @brief Unmaps the archive. Pointers returned by open_asset become invalid.
+ */
+void unmount_asset_pack(void);
+
+/**
+ * @brief Whether an archive is mounted (release layout) rather than reading loose files (development).
+ */
+bool is_asset_pack_mounted(void);
+
+/**
+ * @brief Opens an asset: from the mounted archive if it contains the path, otherwise by mapping the loose file.
+ * @return true on success, false if the asset exists in neither.
+ */
+bool open_asset(const char* path, AssetData* asset);
+
+/**
+ * @brief Releases an asset opened with open_asset. Safe to call on a zeroed AssetData.
+ */
+void close_asset(AssetData* asset);
+
+#endif /* ASSET_PACK_H */
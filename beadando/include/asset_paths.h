@@ -0,0 +1,24 @@
+#ifndef ASSET_PATHS_H
+#define ASSET_PATHS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ASSET_DIR "assets/"
+#define COOKED_ASSET_DIR "assets/cooked/"
+
+#define ASSET_PATH_MAX 512
+
+/**
+ * @brief Builds the path of the cooked counterpart of a source asset.
+ * The cooked tree mirrors assets/, only the extension changes:
+ * "assets/textures/grid.png" + ".tex" -> "assets/cooked/textures/grid.tex"
+ * @param source_path Path of the source asset, relative to the working directory.
+ * @param cooked_extension Extension of the cooked file, including the dot.
+ * @param out_path Output buffer.
+ * @param out_size Size of the output buffer.
+ * @return true on success, false if the result does not fit.
+ */
+bool get_cooked_asset_path(const char* source_path, const char* cooked_extension, char* out_path, size_t out_size);
+
+#endif /* ASSET_PATHS_H */
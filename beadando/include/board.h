@@ -5,24 +5,37 @@
 #include <cglm/cglm.h>
 #include <glad/glad.h>
 #include "unit.h"
+#include "instance_buffer.h"
+#include "mesh_pool.h"
 #include <stdbool.h>
 
 struct Scene;
 struct App;
 
+// Overridable at build time, e.g. by the combat stress harness (see tools/stress.c)
+#ifndef BOARD_GRID_WIDTH
 #define BOARD_GRID_WIDTH 8
+#endif
+#ifndef BOARD_GRID_HEIGHT
 #define BOARD_GRID_HEIGHT 8
+#endif
 
 #define BOARD_TILE_SIZE 1.0f
 
 typedef struct {
-    Model model;
-    GLuint texture_id;
+    int mesh; // Handle of the board mesh in the scene mesh pool, -1 if not loaded
+    int texture_layer; // Layer of the board texture in the scene texture array
 } Board;
 
-bool init_board(Board* board, const char* model_path, const char* texture_path);
+/**
+ * @brief Loads the board mesh into the pool (see load_mesh_into_pool).
+ */
+bool init_board(Board* board, MeshPool* mesh_pool, const char* model_path);
 
-void render_board(const Board* board, GLuint shader_program, const struct App* app);
+/**
+ * @brief Fills the instance data (model matrix, tint, texture layer) of the board.
+ */
+void fill_board_instance(const Board* board, InstanceData* instance);
 
 void destroy_board(Board* board);
 
@@ -47,6 +60,13 @@ bool is_tile_on_player_side(int grid_y);
  */
 bool is_tile_occupied(const struct Scene* scene, int grid_x, int grid_y, const Unit** occupying_unit_ptr);
 
+/**
+ * @brief Whether the unit keeps the player from placing a bench unit on its tile.
+ * Only live player units on the board do; enemies can be placed on top of before combat.
+ * The one placement rule, shared by the click handler and the board overlay.
+ */
+bool does_unit_block_placement(const Unit* unit);
+
 bool is_tile_empty_for_player(const struct Scene* scene, int grid_x, int grid_y);
 
 #endif // BOARD_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef BOARD_OVERLAY_H
+#define BOARD_OVERLAY_H
+
+#include "board.h"
+#include "shader_manager.h"
+#include "unit.h"
+
+#include <glad/glad.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BOARD_OVERLAY_TEXTURE_UNIT 2 // After the scene texture array and the shadow map
+
+/**
+ * Highlight bits of a board cell, one byte per cell in the state texture (see board_overlay.frag).
+ */
+typedef enum BoardCellFlag
+{
+    BOARD_CELL_PLACEABLE = 1 << 0,   // The selected bench unit can be placed here
+    BOARD_CELL_ENEMY_RANGE = 1 << 1, // Within attack range of an enemy unit
+    BOARD_CELL_HOVERED = 1 << 2      // Under the mouse cursor
+} BoardCellFlag;
+
+/**
+ * Per-tile highlights of the whole board, drawn as one quad that samples a
+ * BOARD_GRID_WIDTH x BOARD_GRID_HEIGHT integer state texture. The cells are rebuilt and
+ * uploaded only when the selection, the hovered tile or a unit's tile changes, and the
+ * draw costs the same no matter how many tiles are highlighted.
+ */
+typedef struct BoardOverlay
+{
+    uint8_t cells[BOARD_GRID_HEIGHT][BOARD_GRID_WIDTH]; // BoardCellFlag bits, row = grid_y
+    uint64_t state_hash; // Inputs of the current cells
+    bool valid;
+
+    GLuint state_texture;
+    GLuint vao_id; // Empty, the quad comes from gl_VertexID
+} BoardOverlay;
+
+/**
+ * @brief Creates the state texture. Requires an active OpenGL context.
+ */
+bool init_board_overlay(BoardOverlay* overlay);
+
+void destroy_board_overlay(BoardOverlay* overlay);
+
+/**
+ * @brief Rebuilds the cells and uploads them if the placement inputs changed since the last call.
+ * @param units The units to draw, from the render snapshot (see render_snapshot.h).
+ * @param selected_bench_unit_index Unit being placed, or -1.
+ * @param hovering Whether the mouse is over the board (hover_x/hover_y are ignored otherwise).
+ * @return true if the texture was updated.
+ */
+bool update_board_overlay(BoardOverlay* overlay, const Unit* units, int unit_count, int selected_bench_unit_index,
+                          bool hovering, int hover_x, int hover_y);
+
+/**
+ * @brief BoardCellFlag bits of a tile as of the last update, 0 outside the board.
+ */
+uint8_t get_board_overlay_cell(const BoardOverlay* overlay, int grid_x, int grid_y);
+
+/**
+ * @brief Draws the highlights over the board. Call after the opaque pass; blended, depth tested but not written.
+ */
+void render_board_overlay(BoardOverlay* overlay, ShaderManager* shaders, int overlay_shader);
+
+#endif /* BOARD_OVERLAY_H */
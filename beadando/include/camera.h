@@ -52,6 +52,12 @@ void calculate_view_matrix(Camera* camera, mat4 dest);
 // Input handling helpers
 void rotate_camera(Camera* camera, double horizontal, double vertical);
 void zoom_camera(Camera* camera, float amount); // New function for zoom adjustment
+
+/**
+ * @brief Places the camera on its orbit around the target directly (scripted cameras, see headless.c).
+ * Pitch and zoom are clamped like the interactive controls.
+ */
+void set_camera_orbit(Camera* camera, float yaw_degrees, float pitch_degrees, float zoom);
 void set_camera_pan_speed(Camera* camera, float forward_backward, float right_left); // New combined function
 
 // --- Remove old speed setters ---
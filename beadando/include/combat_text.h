@@ -0,0 +1,81 @@
+#ifndef COMBAT_TEXT_H
+#define COMBAT_TEXT_H
+
+#include "sdf_font.h"
+#include "shader_manager.h"
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#include <stdbool.h>
+
+#define MAX_COMBAT_TEXTS 256
+#define COMBAT_TEXT_MAX_LENGTH 8
+#define MAX_COMBAT_TEXT_GLYPHS (MAX_COMBAT_TEXTS * COMBAT_TEXT_MAX_LENGTH)
+
+typedef enum CombatTextStyle {
+    COMBAT_TEXT_DAMAGE = 0, // Damage number of a hit
+    COMBAT_TEXT_KILL,       // Killing blow: larger and red
+    NUM_COMBAT_TEXT_STYLES
+} CombatTextStyle;
+
+/**
+ * One popup rising from where it was spawned.
+ */
+typedef struct CombatText
+{
+    vec3 position;
+    float age;
+    CombatTextStyle style;
+    char text[COMBAT_TEXT_MAX_LENGTH + 1];
+} CombatText;
+
+/**
+ * Vertex of a glyph quad (see combat_text.vert). Billboarding, rising and fading are done in the shader.
+ */
+typedef struct CombatTextVertex
+{
+    vec4 anchor_progress; // xyz: world position of the popup, w: age / lifetime
+    vec4 offset_uv;       // xy: corner offset from the anchor in billboard space (world units), zw: atlas coordinates
+    vec4 color;
+} CombatTextVertex;
+
+/**
+ * Floating damage numbers. Every frame the glyph quads of all live popups are written into
+ * one streamed vertex buffer and drawn with a single call.
+ */
+typedef struct CombatTextSystem
+{
+    CombatText texts[MAX_COMBAT_TEXTS];
+    int count;
+
+    SdfFont font;
+    GLuint vao_id;
+    GLuint vbo_id;
+} CombatTextSystem;
+
+/**
+ * @brief Generates the font atlas and creates the GL buffers. Requires an active OpenGL context.
+ */
+bool init_combat_text(CombatTextSystem* system);
+
+void destroy_combat_text(CombatTextSystem* system);
+
+/**
+ * @brief Shows a number above a position. The oldest popup is replaced when all slots are in use.
+ */
+void spawn_combat_text(CombatTextSystem* system, const vec3 position, int value, CombatTextStyle style);
+
+/**
+ * @brief Ages the popups and removes the expired ones.
+ */
+void update_combat_text(CombatTextSystem* system, float dt);
+
+/**
+ * @brief Draws the popups in one call, on top of the scene. Camera matrices come from the FrameUniforms block.
+ * @param texts The render snapshot's copy of system->texts (see render_snapshot.h).
+ */
+void render_combat_text(CombatTextSystem* system, ShaderManager* shaders, int text_shader,
+                        const CombatText* texts, int text_count);
+
+#endif /* COMBAT_TEXT_H */
@@ -0,0 +1,81 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <SDL2/SDL.h>
+#include <glad/glad.h>
+
+#include <stdbool.h>
+
+#define DYNRES_MIN_SCALE 0.5f       // Of the window size, per axis
+#define DYNRES_MAX_SCALE 1.0f
+#define DYNRES_STEP 0.05f           // Scales are multiples of this, so the size does not change every frame
+#define DYNRES_BUDGET_FRACTION 0.75 // Share of the frame time the 3D pass may take, the rest is UI, swap and update
+#define DYNRES_ADJUST_FRAMES 8      // Rendered frames between two scale changes
+#define DYNRES_QUERY_COUNT 4        // Timer queries in flight; results are read a few frames late instead of stalling
+
+/**
+ * Dynamic resolution of the 3D pass.
+ * The scene is drawn into an offscreen target at a fraction of the window size and scaled up
+ * to the window with a linear blit; ImGui is drawn after that at native resolution.
+ * The GPU time of the pass (GL_TIME_ELAPSED) is tracked as the full-resolution equivalent cost
+ * (fragment cost grows with the pixel count, scale^2): over the budget the scale drops straight
+ * to what fits, under it the scale climbs back one step at a time, so heavy combat gets
+ * smaller frames and the shop phase returns to full quality.
+ * Software rasterizers (llvmpipe, ...) only time the command submission in their queries, the
+ * pixels are filled on worker threads later; there the pass is finished with glFinish and timed
+ * on the CPU instead, which costs nothing as the CPU is the GPU.
+ * At scale 1 the scene is drawn to the window directly and the blit is skipped.
+ */
+typedef struct DynamicResolution
+{
+    GLuint framebuffer;
+    GLuint color_texture;
+    GLuint depth_renderbuffer;
+    int target_width;  // Allocated size, the window's drawable size
+    int target_height;
+
+    float scale;
+    float min_scale;
+    float max_scale;   // min == max: fixed scale, no adjustment
+    int render_width;  // Scaled region of the pass in progress
+    int render_height;
+    bool offscreen;    // The pass in progress draws into the framebuffer
+
+    bool cpu_timing;     // Software renderer, see above
+    Uint64 begin_counter;
+    GLuint queries[DYNRES_QUERY_COUNT];
+    float query_scales[DYNRES_QUERY_COUNT]; // Scale each query was issued at, 0 when free
+    int query_index;
+
+    double full_cost_ms; // Smoothed GPU time of the pass at scale 1, < 0 until the first result
+    double scene_ms;     // Last measured time of the pass
+    int frames_since_adjust;
+} DynamicResolution;
+
+/**
+ * @brief Creates the timer queries. The target is allocated on the first frame. Needs a current GL context.
+ */
+void init_dynamic_resolution(DynamicResolution* resolution);
+
+/**
+ * @brief Fixes the scale, or with 0 lets it float between DYNRES_MIN_SCALE and DYNRES_MAX_SCALE.
+ */
+void set_dynamic_resolution_scale(DynamicResolution* resolution, float fixed_scale);
+
+/**
+ * @brief Binds and clears the scaled target (resized to the window if needed) and starts timing.
+ */
+void begin_scene_resolution(DynamicResolution* resolution, int width, int height);
+
+/**
+ * @brief Stops timing, scales the pass up to the window and rebinds it with a full viewport.
+ * @param budget_ms Frame time the loop aims for; the pass gets DYNRES_BUDGET_FRACTION of it.
+ */
+void end_scene_resolution(DynamicResolution* resolution, int width, int height, double budget_ms);
+
+/**
+ * @brief Deletes the target and the queries.
+ */
+void destroy_dynamic_resolution(DynamicResolution* resolution);
+
+#endif /* DYNAMIC_RESOLUTION_H */
@@ -0,0 +1,36 @@
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+typedef struct FileMapping
+{
+    const void* data;
+    size_t size;
+
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#else
+    int fd;
+#endif
+} FileMapping;
+
+/**
+ * @brief Maps the file read-only into the address space.
+ * @param mapping Mapping to fill. Zeroed on failure.
+ * @param path Path of the file to map.
+ * @return true on success, false if the file cannot be opened or mapped (or is empty).
+ */
+bool map_file(FileMapping* mapping, const char* path);
+
+/**
+ * @brief Releases a mapping created by map_file. Safe to call on a zeroed mapping.
+ */
+void unmap_file(FileMapping* mapping);
+
+#endif /* FILE_MAP_H */
@@ -0,0 +1,78 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include <SDL2/SDL.h>
+
+#include <stdbool.h>
+
+#define PACING_SPIN_MARGIN_MS 2.0     // The limiter sleeps until this close to the deadline, then spins
+#define PACING_MISSED_FRAME_LIMIT 30  // Consecutive frames slower than the refresh before vsync is turned off
+#define PACING_DEFAULT_REFRESH 60
+
+/**
+ * Swap interval values of SDL_GL_SetSwapInterval.
+ */
+typedef enum VsyncMode
+{
+    VSYNC_ADAPTIVE = -1, // Tears instead of waiting a whole refresh when a frame is late
+    VSYNC_OFF = 0,
+    VSYNC_ON = 1
+} VsyncMode;
+
+/**
+ * Frame pacing of the windowed loop.
+ * - An optional frame limiter (target FPS) that sleeps most of the remaining time and spins the rest,
+ *   so the next frame starts on time without burning a core.
+ * - Vsync that falls back on its own (VSYNC_ADAPTIVE requested): adaptive where the driver has it,
+ *   otherwise plain vsync, relaxed to off with the limiter at the refresh rate if frames keep missing
+ *   the refresh (plain vsync halves the rate to 30 FPS then).
+ * - Latency: the loop samples camera input once more just before the view matrix is built
+ *   (mark_input_sampled) and the time from there to the end of the buffer swap is reported
+ *   as the input-to-present estimate (metric "input_latency_ms"; scanout is not included).
+ */
+typedef struct FramePacer
+{
+    int target_fps;        // 0: no limiter, vsync paces the loop
+    VsyncMode requested_vsync;
+    VsyncMode vsync;       // What the driver accepted
+    int refresh_rate;      // Of the display the window is on
+    bool late_input;       // Sample camera rotation again before the view matrix is built
+
+    Uint64 frame_period;   // Performance counter ticks per frame of the limiter, 0 when off
+    Uint64 next_deadline;
+    Uint64 input_sample_counter;
+    int missed_frames;     // Consecutive frames slower than the refresh while vsync is on
+
+    double latency_ms;     // Last input-to-present estimate
+    double wait_ms;        // Time the limiter waited after the last frame
+} FramePacer;
+
+/**
+ * @brief Sets up pacing for the window's display. Needs a current GL context.
+ * @param target_fps Frame limit, 0 for none.
+ */
+void init_frame_pacer(FramePacer* pacer, SDL_Window* window, int target_fps, VsyncMode vsync);
+
+/**
+ * @brief Records when the input the frame is drawn with was sampled.
+ */
+void mark_input_sampled(FramePacer* pacer);
+
+/**
+ * @brief After the buffer swap: updates the latency estimate, relaxes vsync if frames keep missing
+ * the refresh, then waits for the next frame slot when a limit is set.
+ * @param frame_start_counter Performance counter when the frame's update began.
+ */
+void pace_frame(FramePacer* pacer, Uint64 frame_start_counter);
+
+/**
+ * @brief Time one frame may take: the period of the frame limit, or of the display refresh without one.
+ */
+double get_frame_budget_ms(const FramePacer* pacer);
+
+/**
+ * @brief Parses "on", "off" or "adaptive".
+ */
+bool parse_vsync_mode(const char* text, VsyncMode* mode);
+
+#endif /* FRAME_PACING_H */
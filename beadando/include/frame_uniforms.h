@@ -0,0 +1,36 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+/**
+ * Per-frame constants shared by every shader variant, uniform block "FrameUniforms" (std140).
+ * Uploaded once per frame and bound to the SHADER_BLOCK_FRAME binding point, so switching
+ * variants needs no per-program uniform calls. vec3 values are padded to vec4.
+ */
+typedef struct FrameUniforms
+{
+    mat4 projection;
+    mat4 view;
+    vec4 view_position;       // xyz: camera position (world)
+    vec4 light_direction;     // xyz: direction towards the light (world)
+    vec4 light_color;
+    vec4 ambient_light_color;
+    mat4 light_space;         // World -> shadow map clip space (see shadow_map.h)
+    vec4 time;                // x: scene time in seconds (unit animations)
+} FrameUniforms;
+
+/**
+ * @brief Creates the uniform buffer and binds it to the SHADER_BLOCK_FRAME binding point.
+ * Requires an active OpenGL context.
+ * @return The buffer ID.
+ */
+GLuint create_frame_uniform_buffer(void);
+
+/**
+ * @brief Uploads this frame's constants with a single buffer update.
+ */
+void upload_frame_uniforms(GLuint buffer, const FrameUniforms* uniforms);
+
+#endif /* FRAME_UNIFORMS_H */
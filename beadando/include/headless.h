@@ -0,0 +1,54 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdbool.h>
+
+/**
+ * Offscreen benchmark and render regression mode:
+ *   autochess_game --headless [--frames N] [--size WxH] [--timings file.csv] [--metrics file.csv|file.json]
+ *                  [--capture dir] [--capture-every N] [--golden dir] [--tolerance N] [--max-mismatch F]
+ * Creates a GL 3.3 core context through EGL without any window (Mesa llvmpipe works), renders the
+ * real scene into a framebuffer object at a fixed resolution while a scripted camera orbits a
+ * scripted fight, with a fixed time step so every run sees the same frames. It writes per-frame
+ * timings, optionally saves PNG captures and compares them to golden images, then exits.
+ * In builds that count heap allocations (make HEADLESS=1 ALLOC_CHECK=1, see arena.h) every frame after
+ * the warm-up must also run without a single malloc.
+ * Only available in builds with HEADLESS_EGL defined (make HEADLESS=1).
+ */
+
+#define HEADLESS_DEFAULT_FRAMES 600
+#define HEADLESS_DEFAULT_WIDTH 800
+#define HEADLESS_DEFAULT_HEIGHT 600
+#define HEADLESS_DEFAULT_CAPTURE_INTERVAL 60
+#define HEADLESS_DEFAULT_TOLERANCE 8         // Per channel, absorbs rasterizer rounding
+#define HEADLESS_DEFAULT_MAX_MISMATCH 0.001f // Fraction of pixels allowed above the tolerance
+#define HEADLESS_ALLOC_WARMUP_FRAMES 1       // Frames allowed to allocate (first use of lazily built state)
+
+typedef struct HeadlessOptions
+{
+    int frame_count;
+    int width;
+    int height;
+    const char* timings_path; // CSV, one row per frame; NULL to skip
+    const char* metrics_path; // Frame metrics stream (see metrics.h); NULL to skip
+    const char* capture_dir;  // PNG captures (frame_NNNN.png); NULL to skip
+    int capture_interval;     // Capture every Nth frame
+    const char* golden_dir;   // Compare the captured frames against these; NULL to skip
+    int tolerance;
+    float max_mismatch;
+} HeadlessOptions;
+
+/**
+ * @brief Reads the headless options from the command line.
+ * @return true if --headless was given (options filled), false for a normal windowed run.
+ */
+bool parse_headless_options(int argc, char* argv[], HeadlessOptions* options);
+
+/**
+ * @brief Runs the scripted sequence.
+ * @return Process exit code: 0 on success, 1 if setup failed, 2 if an image differs from its golden,
+ *         4 if a frame after the warm-up allocated from the heap.
+ */
+int run_headless(const HeadlessOptions* options);
+
+#endif /* HEADLESS_H */
@@ -0,0 +1,53 @@
+#ifndef HEALTH_BARS_H
+#define HEALTH_BARS_H
+
+#include "shader_manager.h"
+#include "unit.h"
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#include <stdbool.h>
+
+#define HEALTH_BAR_HEIGHT 1.4f // Above the unit's origin, in world units
+
+/**
+ * Per-instance data of one bar (see health_bar.vert).
+ */
+typedef struct HealthBarInstance
+{
+    vec4 position_health; // xyz: world position of the bar centre, w: HP fraction
+    vec4 color;           // rgb: team colour of the HP fill, a: attack charge fraction
+} HealthBarInstance;
+
+/**
+ * World-space HP bars of every unit on the board.
+ * One instance per unit is written into a streamed buffer each frame and all bars
+ * go out in a single instanced quad draw, so the cost does not grow with the draw count.
+ */
+typedef struct HealthBarRenderer
+{
+    int capacity;
+    GLuint vao_id;
+    GLuint instance_vbo_id;
+} HealthBarRenderer;
+
+/**
+ * @brief Creates the GL buffers. Requires an active OpenGL context.
+ * @param capacity Most bars drawn in a frame (the unit limit).
+ */
+bool init_health_bars(HealthBarRenderer* bars, int capacity);
+
+/**
+ * @brief Frees the staging array and deletes the GL objects.
+ */
+void destroy_health_bars(HealthBarRenderer* bars);
+
+/**
+ * @brief Draws the bars of the living board units. Call after the opaque pass;
+ * bars are blended and drawn on top of the scene. Camera matrices come from the FrameUniforms block.
+ */
+void render_health_bars(HealthBarRenderer* bars, ShaderManager* shaders, int bar_shader,
+                        const Unit* units, int unit_count);
+
+#endif /* HEALTH_BARS_H */
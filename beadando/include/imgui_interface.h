@@ -5,6 +5,7 @@
 // ensuring they are C-compatible.
 #include <SDL2/SDL.h> // For SDL_Window, SDL_Event
 #include "game_state.h"
+#include "render_stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -88,7 +89,10 @@ void ImGui_DrawPlayerStatsWindowWrapper(const GameState* gs, bool mouse_is_over_
  */
 int ImGui_DrawShopWindowWrapper(GameState* gs); // Pass non-const for gold deduction later
 
-void ImGui_DrawBenchWindowWrapper(const struct Scene* scene, int* selected_bench_index_ptr, GamePhase current_phase);
+/**
+ * @brief Draws the bench. The units come from the render snapshot (see render_snapshot.h).
+ */
+void ImGui_DrawBenchWindowWrapper(const struct Unit* units, int unit_count, int* selected_bench_index_ptr, GamePhase current_phase);
 
 /**
  * @brief Draws the Combat Info ImGui window (e.g., "Combat In Progress", progress bar).
@@ -117,6 +121,13 @@ bool ImGui_DrawGameOverWindowWrapper(const GameState* gs);
  */
 void ImGui_DrawHelpWindowWrapper(bool* p_open);
 
+/**
+ * @brief Draws the render statistics window (draw calls, instances, binds of the last 3D pass).
+ * @param stats Counters of the current frame.
+ * @param p_open Pointer to a boolean that controls the window's visibility.
+ */
+void ImGui_DrawRenderStatsWindowWrapper(const RenderStats* stats, bool* p_open);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -15,6 +15,8 @@ typedef struct InputState {
     // Mouse
     int mouse_screen_x;
     int mouse_screen_y;
+    int mouse_delta_x;          // Relative motion this frame (camera rotation in relative mouse mode)
+    int mouse_delta_y;
     bool left_mouse_pressed;    // True if pressed THIS frame
     bool left_mouse_down;       // True if currently held down
     bool left_mouse_released;   // True if released THIS frame
@@ -32,6 +34,8 @@ typedef struct InputState {
     // Keyboard (for specific actions, continuous movement handled by GetKeyboardState directly)
     bool quit_requested;
 
+    int event_count; // SDL events polled this frame, any of them may change what is on screen
+
     // Camera Panning intent (derived from keyboard state)
     float pan_forward_backward_intent; // -1.0 (S), 0.0, 1.0 (W)
     float pan_right_left_intent;     // -1.0 (A), 0.0, 1.0 (D)
@@ -41,6 +45,7 @@ typedef struct InputState {
     bool imgui_wants_keyboard;
     
     bool f1_pressed_this_frame;
+    bool f3_pressed_this_frame;
 
     bool plus_key_pressed;
     bool minus_key_pressed;
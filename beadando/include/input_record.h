@@ -0,0 +1,144 @@
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include "file_map.h"
+#include "input.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Input recording (.inrec), for repeatable play sessions:
+ *   autochess_game --record session.inrec   writes every frame's input, dt and UI decisions
+ *   autochess_game --replay session.inrec   feeds them back instead of the live input and wall clock
+ *
+ * Layout:
+ *   InputRecordHeader
+ *   InputFrame[]   one per frame, until the end of the file
+ *
+ * Each frame also stores a checksum of the simulation state after its tick; the replay compares
+ * it and reports the first frame that diverged. All fields are little-endian.
+ */
+
+#define INPUT_RECORD_MAGIC 0x43524E49u /* "INRC" */
+#define INPUT_RECORD_VERSION 1
+
+typedef struct InputRecordHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frame_size; // sizeof(InputFrame), rejects recordings of a different layout
+    uint32_t reserved;
+} InputRecordHeader;
+
+typedef enum InputFrameFlag
+{
+    INPUT_FRAME_LEFT_PRESSED = 1 << 0,
+    INPUT_FRAME_LEFT_DOWN = 1 << 1,
+    INPUT_FRAME_LEFT_RELEASED = 1 << 2,
+    INPUT_FRAME_RIGHT_PRESSED = 1 << 3,
+    INPUT_FRAME_RIGHT_DOWN = 1 << 4,
+    INPUT_FRAME_RIGHT_RELEASED = 1 << 5,
+    INPUT_FRAME_OVER_BOARD = 1 << 6,
+    INPUT_FRAME_QUIT = 1 << 7,
+    INPUT_FRAME_F1 = 1 << 8,
+    INPUT_FRAME_F3 = 1 << 9,
+    INPUT_FRAME_PLUS = 1 << 10,
+    INPUT_FRAME_MINUS = 1 << 11,
+    INPUT_FRAME_IMGUI_MOUSE = 1 << 12,
+    INPUT_FRAME_IMGUI_KEYBOARD = 1 << 13
+} InputFrameFlag;
+
+/**
+ * Everything one frame of the game reads from the outside world. 48 bytes, no padding.
+ */
+typedef struct InputFrame
+{
+    double dt;                 // Clamped frame time the tick ran with
+    uint64_t checksum;         // Simulation state after the tick
+    int32_t ui_actions;        // ACTION_FLAG_* returned by the shop window
+    float mouse_wheel_delta_y;
+    float pan_forward_backward_intent;
+    float pan_right_left_intent;
+    int16_t mouse_x;
+    int16_t mouse_y;
+    int16_t mouse_delta_x;
+    int16_t mouse_delta_y;
+    int16_t selected_bench_unit_index; // After the bench window of the frame
+    int8_t hovered_grid_x;
+    int8_t hovered_grid_y;
+    uint32_t flags;            // InputFrameFlag bits
+} InputFrame;
+
+typedef enum InputRecordMode
+{
+    INPUT_RECORD_OFF,
+    INPUT_RECORD_RECORDING,
+    INPUT_RECORD_REPLAYING
+} InputRecordMode;
+
+typedef struct InputRecorder
+{
+    InputRecordMode mode;
+    InputFrame frame; // Frame being recorded, or the one being replayed
+    int frame_index;
+
+    FILE* file;          // Recording
+    FileMapping mapping; // Replay
+    const InputFrame* frames;
+    int frame_count;
+
+    int divergent_frames;
+    int first_divergent_frame; // -1 while the replay matches
+    uint64_t start_counter;    // Performance counter at the first frame, for the summary
+} InputRecorder;
+
+/**
+ * @brief Starts in INPUT_RECORD_OFF: the game runs on live input.
+ */
+void init_input_recorder(InputRecorder* recorder);
+
+/**
+ * @brief Starts writing every frame to the file.
+ * @return false if the file cannot be created.
+ */
+bool start_input_recording(InputRecorder* recorder, const char* path);
+
+/**
+ * @brief Starts feeding the frames of a recording back.
+ * @return false if the file is missing or was recorded with a different frame layout.
+ */
+bool start_input_replay(InputRecorder* recorder, const char* path);
+
+/**
+ * @brief Beginning of a frame, after the live input was polled.
+ * Recording stores the input and dt. Replaying overwrites the input with the recorded frame
+ * (a live quit request still ends the run) and requests quit once the recording is used up.
+ * @return The dt the frame runs with.
+ */
+double begin_input_frame(InputRecorder* recorder, InputState* input_state, double dt);
+
+/**
+ * @brief Stores (recording) or verifies (replaying) the simulation checksum of the frame.
+ */
+void check_input_frame_state(InputRecorder* recorder, uint64_t checksum);
+
+/**
+ * @brief Stores or replays the UI decisions of the frame.
+ * @param selected_bench_unit_index Set to the recorded selection when replaying.
+ * @return The shop actions to apply: the live ones, or the recorded ones when replaying.
+ */
+int apply_input_frame_ui(InputRecorder* recorder, int ui_actions, int* selected_bench_unit_index);
+
+/**
+ * @brief End of a frame: writes the recorded frame, or moves to the next replayed one.
+ */
+void end_input_frame(InputRecorder* recorder);
+
+/**
+ * @brief Closes the file and prints the session summary (frame count, average frame time, divergence).
+ */
+void stop_input_recorder(InputRecorder* recorder);
+
+#endif /* INPUT_RECORD_H */
@@ -0,0 +1,77 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+#include <stdbool.h>
+
+// Here rather than in scene.h so the instance buffer can be sized from it (unit.h includes this header)
+#ifndef MAX_UNITS
+#define MAX_UNITS 50 // Overridable at build time like the board size (see board.h)
+#endif
+
+#define MAX_INSTANCES (1 + MAX_UNITS + 1) // Board + MAX_UNITS units + placement ghost
+
+// Vertex attribute locations of the per-instance data (see simple.vert)
+#define INSTANCE_ATTRIB_MODEL 3 // mat4, uses locations 3-6
+#define INSTANCE_ATTRIB_TINT 7
+#define INSTANCE_ATTRIB_LAYER 8
+#define INSTANCE_ATTRIB_ANIMATION 9
+
+/**
+ * Per-instance data of one drawn object.
+ */
+typedef struct InstanceData
+{
+    mat4 model;
+    vec4 color_tint;
+    float texture_layer; // Layer in the scene texture array
+    float animation;       // UnitAnimation, 0 for objects that are not animated (see unit.h)
+    float animation_start; // Scene time the animation started
+    float padding;
+} InstanceData;
+
+/**
+ * CPU staging array and the GL buffer the instances are streamed into every frame.
+ */
+typedef struct InstanceBuffer
+{
+    GLuint vbo_id;
+    InstanceData instances[MAX_INSTANCES];
+    int count;
+    bool overflow_reported; // The full-buffer warning is printed once, not on every dropped push
+} InstanceBuffer;
+
+/**
+ * @brief Creates the GL buffer. Requires an active OpenGL context.
+ */
+void init_instance_buffer(InstanceBuffer* buffer);
+
+/**
+ * @brief Deletes the GL buffer.
+ */
+void destroy_instance_buffer(InstanceBuffer* buffer);
+
+/**
+ * @brief Drops the instances of the previous frame.
+ */
+void clear_instances(InstanceBuffer* buffer);
+
+/**
+ * @brief Appends an instance.
+ * @return Pointer to the new instance to fill, or NULL if the buffer is full (reported once).
+ */
+InstanceData* push_instance(InstanceBuffer* buffer);
+
+/**
+ * @brief Uploads all pushed instances with a single buffer update.
+ */
+void upload_instances(const InstanceBuffer* buffer);
+
+/**
+ * @brief Points the instance attributes of the currently bound VAO at first_instance.
+ * (GL 3.3 has no base instance parameter, so batches are selected by attribute offset.)
+ */
+void bind_instance_attributes(const InstanceBuffer* buffer, int first_instance);
+
+#endif /* INSTANCE_BUFFER_H */
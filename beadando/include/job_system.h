@@ -0,0 +1,90 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <SDL2/SDL.h>
+
+#include <stdbool.h>
+
+#define MAX_JOB_WORKERS 16
+#define JOB_DEQUE_CAPACITY 1024     // Per thread, a power of two; a push into a full deque runs the job inline
+#define MAX_PENDING_JOBS 256        // Jobs submitted with a dependency that has not finished yet
+#define MAX_MAIN_THREAD_JOBS 256
+#define MAX_PARALLEL_FOR_BATCHES 64 // Per parallel_for call; the batch size grows to stay under it
+
+typedef void (*JobFunction)(void* data);
+typedef void (*ParallelForFunction)(int begin, int end, void* data);
+
+/**
+ * Number of unfinished jobs tied to it. Zero-initialize, submit jobs with it, then wait on it.
+ * Also usable as a dependency: a job submitted with run_job_after starts once it reaches zero.
+ */
+typedef struct JobCounter
+{
+    SDL_atomic_t pending;
+} JobCounter;
+
+/**
+ * Work-stealing job scheduler shared by the whole game.
+ * - Every worker thread, and the main thread, owns a deque: it pushes and pops its own jobs at the
+ *   bottom (newest first, cache-warm), idle threads steal the oldest ones from the top of the others.
+ *   Each deque is guarded by a spin lock; jobs are short and contention is rare.
+ * - A thread waiting on a counter runs jobs meanwhile, so waiting inside a job does not deadlock the pool.
+ * - GL calls must stay on the thread of the context: run_main_thread_job queues work that the main
+ *   thread runs in run_main_thread_jobs (once per update) or while it waits on a counter.
+ * Without workers (one core, or before init_job_system) every job runs inline when submitted.
+ * Jobs must not share mutable state without their own synchronization; the metrics registry is
+ * main-thread only.
+ */
+
+/**
+ * @brief Starts the workers.
+ * @param worker_count Threads besides the main thread; 0 or less: one per remaining core.
+ */
+void init_job_system(int worker_count);
+
+/**
+ * @brief Stops and joins the workers. Jobs still queued are run on the calling thread first.
+ */
+void shutdown_job_system(void);
+
+/**
+ * @brief Threads that run jobs: the workers plus the main thread.
+ */
+int get_job_thread_count(void);
+
+/**
+ * @brief Queues a job.
+ * @param counter Incremented now and decremented when the job finished, may be NULL.
+ */
+void run_job(JobFunction function, void* data, JobCounter* counter);
+
+/**
+ * @brief Queues a job that starts only after every job of dependency has finished.
+ */
+void run_job_after(JobFunction function, void* data, JobCounter* dependency, JobCounter* counter);
+
+/**
+ * @brief Queues a job for the main thread (GL uploads and other context work).
+ */
+void run_main_thread_job(JobFunction function, void* data, JobCounter* counter);
+
+/**
+ * @brief Runs the queued main-thread jobs. Main thread only.
+ * @return Number of jobs run.
+ */
+int run_main_thread_jobs(void);
+
+bool is_job_counter_done(JobCounter* counter);
+
+/**
+ * @brief Blocks until the counter reaches zero, running other jobs meanwhile.
+ */
+void wait_for_job_counter(JobCounter* counter);
+
+/**
+ * @brief Calls function on [0, count) split into batches of at least batch_size items, spread over
+ * the pool, and returns when every batch has finished. The caller runs batches too.
+ */
+void parallel_for(int count, int batch_size, ParallelForFunction function, void* data);
+
+#endif /* JOB_SYSTEM_H */
@@ -0,0 +1,37 @@
+#ifndef MESH_CONTAINER_H
+#define MESH_CONTAINER_H
+
+#include <stdint.h>
+
+/*
+ * Cooked mesh container (.mesh), written offline by the asset cooker.
+ *
+ * Layout:
+ *   MeshContainerHeader
+ *   VertexData[vertex_count]   at vertex_offset (see obj/model.h)
+ *   uint32_t[index_count]      at index_offset
+ *
+ * Normals are always present (generated when the OBJ had none) and identical
+ * vertices are welded, so the arrays go straight into the mesh pool.
+ * Both arrays start on a MESH_CONTAINER_ALIGNMENT boundary. All fields are little-endian.
+ */
+
+#define MESH_CONTAINER_MAGIC 0x48534D47u /* "GMSH" */
+#define MESH_CONTAINER_VERSION 1
+#define MESH_CONTAINER_ALIGNMENT 16
+
+typedef struct MeshContainerHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t vertex_stride; // sizeof(VertexData) at cook time
+    uint32_t reserved;
+    float bounds_min[3];
+    float bounds_max[3];
+    uint64_t vertex_offset; // From the start of the file
+    uint64_t index_offset;
+} MeshContainerHeader;
+
+#endif /* MESH_CONTAINER_H */
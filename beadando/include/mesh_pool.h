@@ -0,0 +1,98 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+#include <obj/model.h>
+#include "instance_buffer.h"
+
+#include <glad/glad.h>
+#include <stdbool.h>
+
+#define MAX_POOL_MESHES 16
+#define MAX_POOL_DRAWS 16 // Draw batches submitted in one draw_mesh_pool call
+
+#define MESH_POOL_INITIAL_VERTICES 16384
+#define MESH_POOL_INITIAL_INDICES 16384
+
+/**
+ * Location of one mesh inside the shared buffers.
+ */
+typedef struct PoolMesh
+{
+    GLint base_vertex;   // Added to every index of the mesh
+    GLuint first_index;  // Offset into the index buffer, in indices
+    GLsizei index_count;
+    float bounds_min[3]; // Model space AABB
+    float bounds_max[3];
+} PoolMesh;
+
+/**
+ * Every mesh of the scene sub-allocated into one vertex buffer and one index buffer
+ * under a single VAO, so switching between meshes needs no VAO or buffer binds.
+ */
+typedef struct MeshPool
+{
+    GLuint vao_id;
+    GLuint vbo_id;
+    GLuint ibo_id;
+    GLuint indirect_buffer_id; // 0 if glMultiDrawElementsIndirect is not available
+
+    GLsizei vertex_capacity;
+    GLsizei vertex_count;
+    GLsizei index_capacity;
+    GLsizei index_count;
+
+    PoolMesh meshes[MAX_POOL_MESHES];
+    int mesh_count;
+} MeshPool;
+
+/**
+ * One instanced draw: instance_count instances of a mesh, starting at first_instance
+ * in the instance buffer.
+ */
+typedef struct MeshDraw
+{
+    int mesh;
+    int first_instance;
+    int instance_count;
+} MeshDraw;
+
+/**
+ * @brief Creates the shared VAO and buffers. Requires an active OpenGL context.
+ * Uses the indirect path when the context is GL 4.3+.
+ * @return true on success.
+ */
+bool init_mesh_pool(MeshPool* pool);
+
+/**
+ * @brief Deletes the VAO and buffers.
+ */
+void destroy_mesh_pool(MeshPool* pool);
+
+/**
+ * @brief Appends a mesh to the shared buffers (they grow when full).
+ * @param bounds_min,bounds_max Precomputed bounds, or NULL to compute them from the vertices.
+ * @return The mesh handle, or -1 on failure.
+ */
+int add_mesh_to_pool(MeshPool* pool, const VertexData* vertices, GLsizei vertex_count, const GLuint* indices, GLsizei index_count,
+                     const float* bounds_min, const float* bounds_max);
+
+/**
+ * @brief Flattens a loaded model (see build_model_vertex_data) and appends it to the pool.
+ * @return The mesh handle, or -1 on failure.
+ */
+int add_model_to_pool(MeshPool* pool, const Model* model);
+
+/**
+ * @brief Loads a mesh into the pool, preferring the cooked container
+ * (assets/models/up.obj -> assets/cooked/models/up.mesh) and falling back to parsing the OBJ.
+ * @return The mesh handle, or -1 on failure.
+ */
+int load_mesh_into_pool(MeshPool* pool, const char* model_path);
+
+/**
+ * @brief Draws the batches with one VAO bind: a single glMultiDrawElementsIndirect when available,
+ * otherwise one glDrawElementsInstancedBaseVertex per batch. Batches are drawn in order.
+ */
+void draw_mesh_pool(const MeshPool* pool, const InstanceBuffer* instances, const MeshDraw* draws, int draw_count);
+
+#endif /* MESH_POOL_H */
@@ -0,0 +1,103 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_METRICS 32
+#define MAX_METRIC_NAME 32
+#define METRICS_WINDOW_FRAMES 256 // Rolling window the percentiles are computed over
+
+/**
+ * Counters are summed over a frame and start from zero on the next one (draw calls, units simulated).
+ * Gauges keep the last value set (particles alive, totals since startup).
+ */
+typedef enum MetricKind
+{
+    METRIC_COUNTER,
+    METRIC_GAUGE
+} MetricKind;
+
+/**
+ * Always registered by the registry itself: the frame time passed to end_metrics_frame.
+ */
+#define METRIC_FRAME_TIME 0
+
+typedef struct MetricSummary
+{
+    double last; // Value of the last finished frame
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+    int samples; // Frames in the window
+} MetricSummary;
+
+/**
+ * @brief Registers a named metric, or returns the existing one of that name.
+ * Subsystems register theirs once during initialization and keep the handle.
+ * @return Handle of the metric, or -1 if the registry is full.
+ */
+int register_metric(const char* name, MetricKind kind);
+
+/**
+ * @brief Handle of a registered metric, -1 if none has that name.
+ */
+int find_metric(const char* name);
+
+const char* get_metric_name(int metric);
+
+/**
+ * Updates of the frame being recorded. Invalid handles (-1) are ignored.
+ */
+void add_metric(int metric, double value);
+void set_metric(int metric, double value);
+
+/**
+ * @brief Value of the frame being recorded.
+ */
+double get_metric_value(int metric);
+
+/**
+ * @brief Closes the frame: pushes every metric into the rolling window, streams the row if a
+ * stream is open, and resets the counters.
+ * @param frame_ms Time the frame took, stored as METRIC_FRAME_TIME.
+ */
+void end_metrics_frame(double frame_ms);
+
+/**
+ * @brief Statistics of a metric over the rolling window.
+ * @return false if the handle is invalid or no frame finished yet.
+ */
+bool get_metric_summary(int metric, MetricSummary* summary);
+
+/**
+ * @brief Mean, nearest-rank percentiles and max of any series, the same way as get_metric_summary.
+ * Sorts values in place; last is the final value before sorting.
+ * @return false for an empty series.
+ */
+bool summarize_samples(float* values, int count, MetricSummary* summary);
+
+/**
+ * @brief Streams every finished frame to a file: CSV (one row per frame) or, for a ".json"
+ * path, a JSON object with the metric names, the frame rows and, written on close, a "summary"
+ * (mean and max over the whole stream) and the percentiles of the last METRICS_WINDOW_FRAMES frames.
+ * Metrics registered after the first streamed frame are not part of the stream.
+ * @return false if the file cannot be created.
+ */
+bool open_metrics_stream(const char* path);
+
+/**
+ * @brief Finishes and closes the stream. Safe to call without one.
+ */
+void close_metrics_stream(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
@@ -2,12 +2,19 @@
 #define OBJ_DRAW_H
 
 #include "model.h"
+#include "instance_buffer.h"
 
 /**
  * Draw the model.
  */
 void draw_model(const Model* model);
 
+/**
+ * Draw count instances of the model, taking the per-instance data
+ * from the instance buffer starting at first_instance.
+ */
+void draw_model_instanced(const Model* model, const InstanceBuffer* instances, int first_instance, int count);
+
 /**
  * Draw the triangles of the model.
  */
@@ -3,22 +3,22 @@
 
 #include "model.h"
 
-#include <stdio.h>
+#include <stddef.h>
 
 /**
- * Load OBJ model from file.
+ * Load OBJ model from file (asset pack entry or loose file, see open_asset).
  */
 int load_model(Model* model, const char* filename);
 
 /**
- * Count the elements in the model and set counts in the structure.
+ * Count the elements in the OBJ text and set counts in the structure.
  */
-void count_elements(Model* model, FILE* file);
+void count_elements(Model* model, const char* data, size_t size);
 
 /**
- * Read the elements of the model and fill the structure with values.
+ * Read the elements of the OBJ text and fill the structure with values.
  */
-int read_elements(Model* model, FILE* file);
+int read_elements(Model* model, const char* data, size_t size);
 
 /**
  * Determine the type of the element which is stored in a line of the OBJ file.
@@ -58,6 +58,7 @@ typedef struct Model
     TextureVertex* texture_vertices;
     Vertex* normals;
     Triangle* triangles;
+    void* storage; // One block behind the four arrays above (see allocate_model)
 
     GLuint vao_id;
     GLuint vbo_id;
@@ -65,6 +66,16 @@ typedef struct Model
     GLsizei index_count;
 } Model;
 
+/**
+ * Interleaved vertex as it is uploaded to the GPU (attribute locations 0-2)
+ */
+typedef struct VertexData
+{
+    float position[3];
+    float normal[3];
+    float tex_coord[2];
+} VertexData;
+
 /**
  * Types of the considered elements
  */
@@ -82,7 +93,7 @@ typedef enum {
 void init_model(Model* model);
 
 /**
- * Allocate model.
+ * Allocate model: the four arrays share one block, released by free_model.
  */
 int allocate_model(Model* model);
 
@@ -91,6 +102,27 @@ int allocate_model(Model* model);
  */
 void free_model(Model* model);
 
+/**
+ * Flattens the loaded OBJ data into interleaved vertices and a matching index list.
+ * Faces without normals get flat face normals.
+ * The caller owns both arrays and releases them with free().
+ * @param vertex_data Receives the vertex array (index_count elements).
+ * @param index_data Receives the index array.
+ * @param index_count Receives the number of indices (3 per triangle).
+ * @return TRUE on success, FALSE if the model is empty or has invalid face indices.
+ */
+int build_model_vertex_data(const Model* model, VertexData** vertex_data, GLuint** index_data, GLsizei* index_count);
+
+/**
+ * Unit normal of the triangle abc (counter-clockwise winding), up for degenerate triangles.
+ */
+void compute_triangle_normal(const float a[3], const float b[3], const float c[3], float normal[3]);
+
+/**
+ * Axis-aligned bounding box of the vertex positions.
+ */
+void compute_vertex_bounds(const VertexData* vertices, GLsizei vertex_count, float bounds_min[3], float bounds_max[3]);
+
 /**
  * Creates and configures the VAO and VBOs for the loaded model data.
  * Must be called after load_model and before drawing.
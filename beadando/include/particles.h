@@ -0,0 +1,99 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "shader_manager.h"
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#include <stdbool.h>
+
+#define MAX_PARTICLES_PER_POOL 32768
+
+typedef enum ParticleType {
+    PARTICLE_HIT_SPARK = 0, // Short, fast sparks where an attack lands
+    PARTICLE_DEATH_BURST,   // Large slow burst when a unit dies
+    NUM_PARTICLE_TYPES
+} ParticleType;
+
+/**
+ * Fixed-capacity pool of one particle type, structure of arrays.
+ * Every array is allocated once at init; live particles are packed in [0, count) and
+ * dead ones are swap-removed, so the integration loops stay branch-free and vectorizable.
+ */
+typedef struct ParticlePool
+{
+    float* position_x;
+    float* position_y;
+    float* position_z;
+    float* velocity_x;
+    float* velocity_y;
+    float* velocity_z;
+    float* age;
+    float* lifetime;
+    float* size;
+    int count;
+} ParticlePool;
+
+/**
+ * Per-instance data of one billboard, built from the pools every frame (see particle.vert).
+ */
+typedef struct ParticleInstance
+{
+    vec4 position_size; // xyz: world position, w: half size
+    vec4 color;
+} ParticleInstance;
+
+typedef struct ParticleSystem
+{
+    ParticlePool pools[NUM_PARTICLE_TYPES];
+    unsigned int random_state;
+
+    GLuint vao_id;
+    GLuint instance_vbo_id;
+} ParticleSystem;
+
+/**
+ * @brief Allocates the pools and creates the GL buffers. Requires an active OpenGL context.
+ * @return false if the allocation failed (particles are then disabled).
+ */
+bool init_particle_system(ParticleSystem* system);
+
+/**
+ * @brief Frees the pools and deletes the GL objects.
+ */
+void destroy_particle_system(ParticleSystem* system);
+
+/**
+ * @brief Emits a burst of particles of a type around a position. Excess particles are dropped when the pool is full.
+ */
+void emit_particles(ParticleSystem* system, ParticleType type, const vec3 position, int count);
+
+/**
+ * @brief Integrates every live particle and swap-removes the expired ones.
+ */
+void update_particle_system(ParticleSystem* system, float dt);
+
+#define MAX_PARTICLE_INSTANCES (NUM_PARTICLE_TYPES * MAX_PARTICLES_PER_POOL)
+
+/**
+ * @brief Interleaves the pools into billboard instances, fading color and alpha with the age.
+ * No GL: runs where the render snapshot is captured (see render_snapshot.h).
+ * @param instances Room for get_particle_count instances, at most MAX_PARTICLE_INSTANCES.
+ * @return The number of instances written.
+ */
+int build_particle_instances(const ParticleSystem* system, ParticleInstance* instances);
+
+/**
+ * @brief Draws the instances as camera-facing billboards in one instanced draw.
+ * Additive blending, depth tested but not written. Camera matrices come from the FrameUniforms block.
+ */
+void render_particle_system(ParticleSystem* system, ShaderManager* shaders, int particle_shader,
+                            const ParticleInstance* instances, int instance_count);
+
+/**
+ * @brief Number of live particles over all pools.
+ */
+int get_particle_count(const ParticleSystem* system);
+
+#endif /* PARTICLES_H */
@@ -0,0 +1,82 @@
+#ifndef POINT_LIGHTS_H
+#define POINT_LIGHTS_H
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#include <stdbool.h>
+
+// Keep in sync with simple.frag (PointLightUniforms)
+#define MAX_POINT_LIGHTS 256
+#define LIGHT_GRID_SIZE 8 // Cells per side, spread over the whole board
+#define LIGHT_GRID_CELLS (LIGHT_GRID_SIZE * LIGHT_GRID_SIZE)
+#define MAX_LIGHT_INDICES 1536 // Light references over all cells
+#define MAX_LIGHTS_PER_CELL 16 // Bounds the per-fragment cost in a crowded cell
+
+/**
+ * Short-lived point light (attack hits, deaths). Fades out linearly over its lifetime.
+ */
+typedef struct PointLight
+{
+    vec3 position;
+    float radius; // No contribution beyond this distance
+    vec3 color;
+    float intensity; // Current, derived from the age
+    float age;
+    float lifetime;
+} PointLight;
+
+/**
+ * GPU side, uniform block "PointLightUniforms" (std140), rebuilt every frame by bin_point_lights.
+ * Every board cell stores a range of lightIndices; a fragment only shades the lights of its cell.
+ * About 15 KB, under the 16 KB block size every GL 3.3 driver guarantees.
+ */
+typedef struct PointLightUniforms
+{
+    int light_count;
+    int index_count;
+    int padding[2];
+    vec4 grid;                                 // xy: world xz of the grid origin, zw: cell size
+    vec4 lights[MAX_POINT_LIGHTS * 2];         // [2i]: position, radius; [2i + 1]: color * intensity
+    int cells[LIGHT_GRID_CELLS][4];            // x: first index, y: light count
+    int indices[MAX_LIGHT_INDICES / 4][4];     // Light indices, packed four per ivec4
+} PointLightUniforms;
+
+typedef struct PointLightList
+{
+    PointLight lights[MAX_POINT_LIGHTS];
+    int count;
+
+    PointLightUniforms uniforms; // Staging copy of the block
+    GLuint uniform_buffer;
+} PointLightList;
+
+/**
+ * @brief Creates the uniform buffer and binds it to the SHADER_BLOCK_POINT_LIGHTS binding point.
+ * Requires an active OpenGL context.
+ */
+void init_point_lights(PointLightList* list);
+
+/**
+ * @brief Deletes the uniform buffer and drops every light.
+ */
+void destroy_point_lights(PointLightList* list);
+
+/**
+ * @brief Adds a light. When the list is full the oldest light is replaced.
+ */
+void spawn_point_light(PointLightList* list, const vec3 position, const vec3 color, float radius, float lifetime);
+
+/**
+ * @brief Ages the lights, fades them and removes the expired ones.
+ */
+void update_point_lights(PointLightList* list, float dt);
+
+/**
+ * @brief Culls the lights into the board cells and uploads the compact lists.
+ * @param lights The lights to draw, the render snapshot's copy of list->lights (see render_snapshot.h).
+ * @return The number of light references binned (0 means the lit pass can skip point lights).
+ */
+int bin_point_lights(PointLightList* list, const PointLight* lights, int light_count);
+
+#endif /* POINT_LIGHTS_H */
@@ -0,0 +1,82 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include "scene.h"
+#include "arena.h"
+
+#include <stdint.h>
+
+#define RENDER_SNAPSHOT_COUNT 3 // Latest published, read by the renderer, written by the simulation
+
+/**
+ * Everything the renderer and the UI read of the simulation, copied at the end of a simulation step.
+ * Immutable once published: the render code draws from it while the next step runs on a worker.
+ * The units keep their pointers into the live scene (current_target_ptr); they must not be followed.
+ */
+typedef struct RenderSnapshot
+{
+    uint64_t sequence; // Simulation step it was captured after, 0 for a slot never written
+    float time;        // Scene time, drives the animations in the shaders
+
+    Unit units[MAX_UNITS]; // Bench and board, for the overlay, the health bars and the bench window
+    int unit_count;
+
+    InstanceData unit_instances[MAX_UNITS]; // Visible board units, grouped by type
+    int unit_first[NUM_UNIT_TYPES];
+    int unit_instance_count[NUM_UNIT_TYPES];
+
+    PointLight point_lights[MAX_POINT_LIGHTS];
+    int point_light_count;
+
+    CombatText combat_texts[MAX_COMBAT_TEXTS];
+    int combat_text_count;
+
+    ParticleInstance* particles; // In the arena
+    int particle_count;
+
+    Arena arena; // Variable-sized parts, reset on every capture so capturing never touches the heap
+} RenderSnapshot;
+
+/**
+ * Triple buffer of snapshots between the simulation and the renderer.
+ * The slots are handed out on the main thread only; a capture itself may run on any thread.
+ */
+typedef struct RenderSnapshotBuffer
+{
+    RenderSnapshot* snapshots; // RENDER_SNAPSHOT_COUNT, one allocation
+    int latest;  // Newest published slot, -1 before the first publish
+    int reading; // Slot the renderer acquired, -1 if none
+    int writing; // Slot being captured, -1 if none
+    uint64_t sequence;
+} RenderSnapshotBuffer;
+
+/**
+ * @brief Allocates the snapshots and their arenas.
+ */
+bool init_render_snapshots(RenderSnapshotBuffer* buffer);
+
+void destroy_render_snapshots(RenderSnapshotBuffer* buffer);
+
+/**
+ * @brief Reserves the slot neither published nor being read. Main thread.
+ */
+RenderSnapshot* begin_snapshot_write(RenderSnapshotBuffer* buffer);
+
+/**
+ * @brief Copies the render state of the scene into the snapshot and builds the unit and particle instances.
+ * Refreshes the instance caches of the live units, so it runs on the thread that owns the scene at the time.
+ */
+void capture_render_snapshot(RenderSnapshot* snapshot, Scene* scene);
+
+/**
+ * @brief Makes the slot reserved by begin_snapshot_write the latest one. Main thread, after the capture finished.
+ */
+void publish_snapshot(RenderSnapshotBuffer* buffer);
+
+/**
+ * @brief The latest snapshot, kept from being overwritten until the next call. Main thread.
+ * @return NULL before the first publish.
+ */
+const RenderSnapshot* acquire_render_snapshot(RenderSnapshotBuffer* buffer);
+
+#endif /* RENDER_SNAPSHOT_H */
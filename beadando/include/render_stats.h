@@ -0,0 +1,56 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Per-frame counters of the 3D pass. They live in the metrics registry (see metrics.h) under the
+ * names in render_stats.c and reset when the frame ends; this struct is a snapshot of them.
+ */
+typedef struct RenderStats {
+    int draw_calls;
+    int indirect_commands; // Draws issued through one multi-draw call
+    int instances;
+    int triangles;
+    int texture_binds;
+    int vao_binds;
+    int uniform_uploads; // Uniform setters and uniform buffer updates
+    int shadow_layers_rendered; // 0 when the cached shadow map was reused
+    int point_lights;
+    int point_light_references; // Light indices over all cells, what the fragments actually loop over
+    int particles;
+
+    // Since startup, kept across frames
+    long long shadow_cache_lookups;
+    long long shadow_cache_hits;
+} RenderStats;
+
+/**
+ * @brief Registers the counters in the metrics registry. Call once before the first frame.
+ */
+void init_render_stats(void);
+
+void count_draw_call(int instance_count, int triangles_per_instance);
+void count_indirect_command(int instance_count, int triangles_per_instance);
+void count_texture_bind(void);
+void count_vao_bind(void);
+void count_uniform_upload(void);
+void count_shadow_cache_lookup(bool hit);
+void count_shadow_layer_render(void);
+void count_point_lights(int light_count, int reference_count);
+void count_particles(int particle_count);
+
+/**
+ * @brief Returns the counters of the frame being recorded (until end_metrics_frame).
+ */
+const RenderStats* get_render_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_STATS_H
@@ -7,10 +7,17 @@
 #include <obj/model.h>
 #include "utils.h"
 #include "unit.h"
-#include "board.h"
+#include "instance_buffer.h"
+#include "mesh_pool.h"
+#include "shader_manager.h"
+#include "shadow_map.h"
+#include "point_lights.h"
+#include "particles.h"
+#include "health_bars.h"
+#include "board_overlay.h"
+#include "combat_text.h"
 
-#define MAX_UNITS 50
-#define BENCH_SIZE 8
+#define BENCH_SIZE 8 // MAX_UNITS is in instance_buffer.h, which sizes the draw from it
 
 struct App;
 
@@ -19,12 +26,22 @@ typedef struct Scene
     Board board;
     Material material;
     
-    Model unit_models[NUM_UNIT_TYPES];
-    GLuint unit_textures[NUM_UNIT_TYPES];
-    GLuint unit_vaos[NUM_UNIT_TYPES];
-    
-    GLsizei unit_index_counts[NUM_UNIT_TYPES];
+    int unit_meshes[NUM_UNIT_TYPES]; // Mesh pool handles, -1 if the model failed to load
+    MeshPool mesh_pool; // Board and unit meshes under one VAO
+
+    GLuint texture_array; // Board and unit textures, one layer each
+    int unit_texture_layers[NUM_UNIT_TYPES];
+    InstanceBuffer instance_buffer;
+    ShadowMap shadow_map;
+    bool shadows_enabled; // false if the shadow map could not be created
+    PointLightList point_lights; // Transient lights of hits and deaths
+    ParticleSystem particles; // Hit sparks and death bursts
+    HealthBarRenderer health_bars;
+    BoardOverlay board_overlay; // Placement, range and hover highlights
+    CombatTextSystem combat_text; // Floating damage numbers
     
+    float time; // Simulation time in seconds, drives the unit animations
+
     Unit units[MAX_UNITS];
     int unit_count;
 } Scene;
@@ -45,15 +62,29 @@ void set_lighting();
 void set_material(const Material* material);
 
 /**
- * Update the scene.
+ * Update the scene. Runs on a job worker when the app is pipelined (see step_app_simulation),
+ * so it must not touch the GL context or the metrics registry.
  */
 void update_scene(Scene* scene, float dt, GamePhase current_phase);
 
+/**
+ * @brief Whether transient effects are still playing (particles, combat text, point lights, death animations).
+ * The ambient idle bob does not count; it simply pauses while the app idles.
+ */
+bool is_scene_animating(const Scene* scene);
+
 /**
  * Render the scene objects.
+ * Every object is an instance in scene->instance_buffer: the texture array and the mesh pool
+ * are bound once and all batches (board, unit types) go out through draw_mesh_pool with the lit
+ * variant of the shader; the placement ghost follows with the unlit variant.
+ * The cached shadow map is refreshed first with depth_shader (only when casters or the light moved).
+ * Units and lights come from the snapshot; of the scene only the GPU resources and the board are used.
  */
 struct InputState;
-void render_scene(const Scene* scene, GLuint shader_program, const struct App* app, int selected_bench_unit_index);
+struct RenderSnapshot;
+void render_scene(Scene* scene, const struct RenderSnapshot* snapshot, ShaderManager* shaders, int shader, int depth_shader,
+                  const struct App* app, int selected_bench_unit_index);
 
 /**
  * Draw the origin of the world coordinate system.
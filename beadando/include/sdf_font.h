@@ -0,0 +1,43 @@
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#include <stdbool.h>
+
+// Atlas layout, in texels
+#define SDF_FONT_CELL_SIZE 32   // Each glyph cell is square, the distance field fills the margin
+#define SDF_FONT_PIXEL_SIZE 3   // One pixel of the built-in bitmap font
+#define SDF_FONT_INK_HEIGHT 21  // 7 font pixels
+#define SDF_FONT_ADVANCE 18     // 5 font pixels plus one pixel of spacing
+#define SDF_FONT_SPREAD 4       // Distance covered by the field on each side of an edge
+
+#define SDF_FONT_TEXTURE_UNIT 3 // After the scene texture array, the shadow map and the board overlay
+
+/**
+ * Signed distance field atlas of a small built-in bitmap font (digits and a few signs),
+ * generated at load time. The texel value is 0.5 on the glyph outline and grows inside,
+ * so the glyphs stay sharp at any size with one bilinear sample.
+ */
+typedef struct SdfFont
+{
+    GLuint texture; // GL_R8, one row of cells
+    int glyph_cells[128]; // Cell of each ASCII character, -1 if the font lacks it
+    int cell_count;
+} SdfFont;
+
+/**
+ * @brief Rasterizes the distance field and uploads the atlas. Requires an active OpenGL context.
+ */
+bool init_sdf_font(SdfFont* font);
+
+void destroy_sdf_font(SdfFont* font);
+
+/**
+ * @brief Texture coordinates of a character's cell (x0, y0, x1, y1).
+ * @return false if the font has no glyph for it.
+ */
+bool get_sdf_glyph(const SdfFont* font, char character, vec4 uv_rect);
+
+#endif /* SDF_FONT_H */
@@ -6,7 +6,7 @@
 /**
  * @brief Loads, compiles, and links vertex and fragment shaders into a shader program.
  *
- * Reads shader source code from files, compiles them, checks for errors,
+ * Reads shader source code from the asset pack (or the loose files), compiles them, checks for errors,
  * links them into a program, checks for linking errors, and cleans up.
  *
  * @param vertex_path Path to the vertex shader source file.
@@ -15,4 +15,13 @@
  */
 GLuint load_shaders(const char* vertex_path, const char* fragment_path);
 
+/**
+ * @brief Compiles and links a program from in-memory sources (need not be NUL-terminated).
+ * Marks the program binary as retrievable where the driver supports it (GL 4.1).
+ * @param defines Lines inserted after the #version line of both stages ("#define UNLIT 1\n"), or NULL.
+ * @return The ID of the linked shader program, or 0 if an error occurred (details go to stderr).
+ */
+GLuint link_shader_program(const char* vertex_source, GLint vertex_length,
+                           const char* fragment_source, GLint fragment_length, const char* defines);
+
 #endif // SHADER_H
\ No newline at end of file
@@ -0,0 +1,162 @@
+#ifndef SHADER_MANAGER_H
+#define SHADER_MANAGER_H
+
+#include "asset_paths.h"
+
+#include <glad/glad.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_SHADERS 8
+#define MAX_SHADER_VARIANTS 8
+#define MAX_SHADER_WATCHES 4
+
+// Driver specific program binaries, never packed or committed
+#define SHADER_CACHE_DIR "shader_cache"
+#define SHADER_CACHE_MAGIC 0x48434853u /* "SHCH" */
+#define SHADER_CACHE_VERSION 1
+
+// How often the loose sources are checked where inotify is not available (ms)
+#define SHADER_POLL_INTERVAL 500
+
+/**
+ * Header of a cached program binary (shader_cache/<key>.bin), followed by the binary itself.
+ */
+typedef struct ShaderCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;          // Hash of both sources, the feature defines and the driver strings
+    uint32_t binary_format;
+    uint32_t binary_length;
+} ShaderCacheHeader;
+
+/**
+ * Feature bits of a shader variant. Each set bit is compiled in as "#define <NAME> 1"
+ * (names in shader_manager.c), so one source file serves every variant.
+ */
+typedef enum ShaderFeature
+{
+    SHADER_FEATURE_UNLIT = 1 << 0,  // Texture and tint only (placement ghost, overlays)
+    SHADER_FEATURE_SHADOWS = 1 << 1,     // Samples the shadow map (see shadow_map.h)
+    SHADER_FEATURE_POINT_LIGHTS = 1 << 2 // Shades the binned point lights of the fragment's cell (see point_lights.h)
+} ShaderFeature;
+
+#define SHADER_FEATURE_BITS 3
+
+/**
+ * Plain uniforms the render code sets, resolved once per variant when it is built.
+ * Names in shader_manager.c; a variant that optimized a uniform out stores -1 and setting it is a no-op.
+ */
+typedef enum ShaderUniform
+{
+    UNIFORM_TEXTURE,
+    UNIFORM_MATERIAL_DIFFUSE,
+    UNIFORM_MATERIAL_SPECULAR,
+    UNIFORM_MATERIAL_SHININESS,
+    UNIFORM_SHADOW_MAP,
+    UNIFORM_BOARD_STATE,
+    UNIFORM_FONT_ATLAS,
+    SHADER_UNIFORM_COUNT
+} ShaderUniform;
+
+/**
+ * Uniform blocks. Every variant binds a block to the binding point equal to its ID,
+ * so a buffer bound there with glBindBufferBase serves all programs.
+ */
+typedef enum ShaderBlock
+{
+    SHADER_BLOCK_FRAME,        // FrameUniforms (see frame_uniforms.h)
+    SHADER_BLOCK_POINT_LIGHTS, // PointLightUniforms (see point_lights.h)
+    SHADER_BLOCK_COUNT
+} ShaderBlock;
+
+/**
+ * One compiled permutation with its reflected lookup table.
+ */
+typedef struct ShaderVariant
+{
+    uint32_t features;
+    GLuint program; // 0 if the variant failed to build (retried on the next reload)
+    GLint uniform_locations[SHADER_UNIFORM_COUNT];
+    uint32_t active_blocks; // Bit per ShaderBlock
+} ShaderVariant;
+
+typedef struct ManagedShader
+{
+    char vertex_path[ASSET_PATH_MAX];
+    char fragment_path[ASSET_PATH_MAX];
+    long long vertex_mtime;   // Only used when polling
+    long long fragment_mtime;
+    bool needs_reload;
+
+    ShaderVariant variants[MAX_SHADER_VARIANTS]; // Built on first use
+    int variant_count;
+} ManagedShader;
+
+/**
+ * Owns the shaders of the game and their variants.
+ * Linked programs are stored with glGetProgramBinary and loaded from the cache on later launches.
+ * In development (no asset pack mounted) the source files are watched and every variant of a
+ * changed shader is rebuilt and swapped live.
+ */
+typedef struct ShaderManager
+{
+    ManagedShader shaders[MAX_SHADERS];
+    int shader_count;
+
+    bool binary_cache_enabled;
+    char driver_id[512]; // GL_VENDOR, GL_RENDERER and GL_VERSION, part of the cache key
+
+    bool watching;
+    int watch_fd; // inotify instance, -1 when polling modification times
+    int watch_descriptors[MAX_SHADER_WATCHES];
+    char watch_directories[MAX_SHADER_WATCHES][ASSET_PATH_MAX];
+    int watch_count;
+    uint32_t last_poll_ticks;
+} ShaderManager;
+
+/**
+ * @brief Initializes the manager. Needs a current GL context.
+ * @param watch_files Rebuild shaders when their source files change.
+ */
+void init_shader_manager(ShaderManager* manager, bool watch_files);
+
+/**
+ * @brief Registers a vertex/fragment shader pair and builds its base variant (no features).
+ * @return Handle of the shader, or -1 on failure.
+ */
+int load_shader(ShaderManager* manager, const char* vertex_path, const char* fragment_path);
+
+/**
+ * @brief Returns the variant of a shader with the given ShaderFeature bits, building it on first use.
+ * @return The variant, or NULL if it does not build.
+ */
+const ShaderVariant* get_shader_variant(ShaderManager* manager, int shader, uint32_t features);
+
+/**
+ * @brief get_shader_variant, then makes the variant the current program.
+ */
+const ShaderVariant* use_shader_variant(ShaderManager* manager, int shader, uint32_t features);
+
+/**
+ * Uniform setters for the current program. Uniforms missing from the variant are skipped.
+ */
+void set_shader_int(const ShaderVariant* variant, ShaderUniform uniform, int value);
+void set_shader_float(const ShaderVariant* variant, ShaderUniform uniform, float value);
+void set_shader_vec3(const ShaderVariant* variant, ShaderUniform uniform, const float* value);
+
+/**
+ * @brief Rebuilds every variant of the shaders whose sources changed since the last call.
+ * A variant that fails to compile keeps running its previous program.
+ * @return true if any program was replaced.
+ */
+bool update_shader_manager(ShaderManager* manager);
+
+/**
+ * @brief Deletes every program and stops watching.
+ */
+void destroy_shader_manager(ShaderManager* manager);
+
+#endif /* SHADER_MANAGER_H */
@@ -0,0 +1,66 @@
+#ifndef SHADOW_MAP_H
+#define SHADOW_MAP_H
+
+#include "instance_buffer.h"
+#include "mesh_pool.h"
+#include "shader_manager.h"
+
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SHADOW_MAP_SIZE 2048
+#define SHADOW_TEXTURE_UNIT 1 // Unit 0 is the scene texture array
+
+/**
+ * Cached shadow map of the directional light, in two layers:
+ *   static layer - depth of the board, re-rendered only when the light changes (+/- keys)
+ *   shadow layer - copy of the static layer plus the units, re-rendered only when a caster
+ *                  moved or the static layer changed
+ * The lit pass samples the shadow layer. On a frame where nothing moved no shadow work is done.
+ */
+typedef struct ShadowMap
+{
+    GLuint static_texture;
+    GLuint static_framebuffer;
+    GLuint shadow_texture;
+    GLuint shadow_framebuffer;
+
+    bool static_valid;
+    bool shadow_valid;
+    vec3 light_direction; // Light of the cached layers
+    uint64_t caster_hash; // Caster transforms of the cached shadow layer
+} ShadowMap;
+
+/**
+ * @brief Creates the depth textures and framebuffers. Requires an active OpenGL context.
+ * @return false if the framebuffers are incomplete; shadows are then left off.
+ */
+bool init_shadow_map(ShadowMap* shadow_map);
+
+/**
+ * @brief Deletes the GL objects.
+ */
+void destroy_shadow_map(ShadowMap* shadow_map);
+
+/**
+ * @brief Orthographic light-space matrix covering the board, looking along -light_direction.
+ */
+void compute_shadow_light_matrix(const vec3 light_direction, mat4 out_light_space);
+
+/**
+ * @brief Brings the cached layers up to date and binds the result to SHADOW_TEXTURE_UNIT.
+ * Casters are drawn with the depth-only variant of depth_shader, their light-space matrix comes
+ * from the FrameUniforms block. The caster instances must be uploaded already.
+ * @param static_draws Batches of the static layer (the board).
+ * @param dynamic_draws Batches of the units; their instances are hashed to detect movement.
+ * @return true if the shadow layer is usable (the lit pass may sample it).
+ */
+bool update_shadow_map(ShadowMap* shadow_map, ShaderManager* shaders, int depth_shader, const vec3 light_direction,
+                       const MeshPool* pool, const InstanceBuffer* instances,
+                       const MeshDraw* static_draws, int static_draw_count,
+                       const MeshDraw* dynamic_draws, int dynamic_draw_count);
+
+#endif /* SHADOW_MAP_H */
@@ -4,15 +4,67 @@
 // Use GLAD's types instead of GL/gl.h
 #include <glad/glad.h>
 
+#include "asset_pack.h"
+#include "texture_container.h"
+
+#include <stdbool.h>
+
+#define TEXTURE_ARRAY_LAYER_SIZE 256
+
 // Pixel definition remains the same if used internally by loader,
 // but stb_image handles pixel data directly. Let's remove it for now.
 // typedef GLubyte Pixel[3];
 
+/**
+ * Cooked texture container mapped into memory (see texture_container.h),
+ * either inside the asset pack or as a loose file.
+ */
+typedef struct TextureContainer
+{
+    AssetData asset;
+    const TextureContainerHeader* header;
+    const TextureContainerLevel* levels;
+} TextureContainer;
+
 /**
  * Load texture from file and returns with the texture name (OpenGL ID).
+ * Uses the cooked container (assets/cooked/...tex) when it exists,
+ * otherwise decodes the source image and generates the mipmaps on the GPU.
  * Returns 0 on failure.
  * Takes const char* for filename safety.
  */
 GLuint load_texture(const char* filename);
 
+/**
+ * @brief Builds one GL_TEXTURE_2D_ARRAY holding the given images, one layer each.
+ * Every layer is TEXTURE_ARRAY_LAYER_SIZE squared: cooked RGBA8 containers with a matching
+ * level are copied as-is (with their mips), anything else is decoded and resampled.
+ * @param filenames Source image paths (the cooked containers are looked up like in load_texture).
+ * @param layer_count Number of paths / layers.
+ * @return The texture name, or 0 on failure.
+ */
+GLuint load_texture_array(const char* const* filenames, int layer_count);
+
+/**
+ * @brief Maps a cooked texture container and validates its header and level table.
+ * @return true on success. On failure the container is left closed.
+ */
+bool open_texture_container(TextureContainer* container, const char* path);
+
+/**
+ * @brief Returns the payload of a mip level (pointer into the mapping).
+ */
+const void* get_texture_container_level(const TextureContainer* container, int level);
+
+/**
+ * @brief Unmaps the container.
+ */
+void close_texture_container(TextureContainer* container);
+
+/**
+ * @brief Creates a GL_TEXTURE_2D from a mapped container, uploading it level by level.
+ * @return The texture name, or 0 if the payload format is not supported by the context.
+ */
+GLuint upload_texture_container(const TextureContainer* container);
+
 #endif /* TEXTURE_H */
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef TEXTURE_CONTAINER_H
+#define TEXTURE_CONTAINER_H
+
+#include <stdint.h>
+
+/*
+ * Cooked texture container (.tex), written offline by the texture cooker.
+ *
+ * Layout:
+ *   TextureContainerHeader
+ *   TextureContainerLevel[level_count]   (level 0 = full resolution)
+ *   payload, every level starting on a TEXTURE_CONTAINER_ALIGNMENT boundary
+ *
+ * The payload is stored exactly as glTexImage2D / glCompressedTexImage2D expects it,
+ * so the runtime only maps the file and hands the level pointers to GL.
+ * All fields are little-endian.
+ */
+
+#define TEXTURE_CONTAINER_MAGIC 0x58455447u /* "GTEX" */
+#define TEXTURE_CONTAINER_VERSION 1
+#define TEXTURE_CONTAINER_MAX_LEVELS 16
+#define TEXTURE_CONTAINER_ALIGNMENT 16
+
+#define TEXTURE_CONTAINER_FLAG_COMPRESSED (1u << 0)
+#define TEXTURE_CONTAINER_FLAG_HAS_ALPHA  (1u << 1)
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+typedef struct TextureContainerHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t level_count;
+    uint32_t flags;
+    uint32_t gl_internal_format; // e.g. GL_RGBA8 or GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    uint32_t gl_format;          // e.g. GL_RGBA, 0 for compressed payloads
+    uint32_t gl_type;            // e.g. GL_UNSIGNED_BYTE, 0 for compressed payloads
+    uint32_t reserved;
+} TextureContainerHeader;
+
+typedef struct TextureContainerLevel
+{
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset; // From the start of the file
+    uint64_t size;   // In bytes
+} TextureContainerLevel;
+
+#endif /* TEXTURE_CONTAINER_H */
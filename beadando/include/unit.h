@@ -10,6 +10,7 @@ extern "C" {
 #endif
 
 #include "game_state.h"
+#include "instance_buffer.h"
 
 
 
@@ -35,6 +36,20 @@ typedef enum UnitState {
     UNIT_STATE_DEAD       // (For later)
 } UnitState;
 
+/**
+ * Procedural animations, evaluated in simple.vert from the type and start time in the instance record.
+ * The idle bob runs whenever no other animation is playing; durations are in the shader.
+ */
+typedef enum UnitAnimation {
+    UNIT_ANIM_NONE = 0, // Not animated (board, placement ghost)
+    UNIT_ANIM_IDLE,
+    UNIT_ANIM_ATTACK,   // Lunge along the facing direction
+    UNIT_ANIM_HIT,      // Flash and recoil
+    UNIT_ANIM_DEATH     // Shrink into the board
+} UnitAnimation;
+
+#define UNIT_DEATH_DURATION 0.6f // Dead units stay drawn this long (matches simple.vert)
+
 // --- Unit Data Structure ---
 typedef struct Unit {
     int id;
@@ -68,6 +83,16 @@ typedef struct Unit {
     bool is_attacking_visual_active; // Flag for the "attack" animation
     float attack_visual_timer;       // Timer for how long the visual stays active
     bool is_alive;
+
+    // Animation
+    UnitAnimation animation;
+    float animation_start; // Scene time the animation started
+
+    // Instance record, rebuilt only when the transform or the animation changes (see fill_unit_instance)
+    InstanceData instance;
+    vec3 instance_position;
+    vec3 instance_facing;
+    bool instance_valid;
 } Unit;
 
 /**
@@ -83,16 +108,21 @@ typedef struct Unit {
 void init_unit(Unit* unit, UnitType type, int grid_x, int grid_y, bool is_player, UnitLocation initial_location);
 
 /**
- * @brief Renders a single unit.
- * Assumes the correct shader program is already in use.
- * Assumes View and Projection uniforms are set.
- * Needs access to Scene to get type-specific resources (VAO, texture).
+ * @brief Fills the instance data of a unit (model matrix, tint, texture layer, animation).
+ * The unit is drawn later in one instanced batch per unit type (see render_scene).
+ * The record is cached in the unit and only rebuilt when its position, facing or animation changed;
+ * the per-frame motion is done by the vertex shader.
+ * Needs access to Scene to get type-specific resources (texture layer).
  * @param unit Pointer to the unit to render.
  * @param scene Pointer to the main scene containing unit resources.
- * @param shader_program ID of the shader program.
- * @param model_uloc Uniform location for the 'model' matrix.
+ * @param instance Instance record to fill.
+ */
+void fill_unit_instance(Unit* unit, const struct Scene* scene, InstanceData* instance);
+
+/**
+ * @brief Starts a procedural animation at the given scene time.
  */
-void render_unit(const Unit* unit, const struct Scene* scene, GLuint shader_program, const struct App* app);
+void start_unit_animation(Unit* unit, UnitAnimation animation, float time);
 
 /**
  * @brief Updates a unit's state (e.g., animation, movement - for later).
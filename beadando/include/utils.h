@@ -4,6 +4,9 @@
 #include <cglm/cglm.h>
 #include <glad/glad.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
  
  typedef struct Material
  {
@@ -16,4 +19,19 @@
 void _check_gl_error(const char *file, int line, const char* operation_name);
 #define check_gl_error(op_name) _check_gl_error(__FILE__, __LINE__, op_name)
 
+/**
+ * @brief Checks whether the current GL context advertises the given extension.
+ * Requires a current context (uses glGetStringi).
+ */
+bool has_gl_extension(const char* name);
+
+#define FNV1A64_OFFSET_BASIS 14695981039346656037ull
+
+/**
+ * @brief 64-bit FNV-1a over raw bytes, continuing from seed (FNV1A64_OFFSET_BASIS for a new hash).
+ * The engine's one content hash: cache keys, the replay checksum and the asset pack table.
+ * Hash fields one by one, never padded structs.
+ */
+uint64_t hash_fnv1a64(uint64_t seed, const void* data, size_t size);
+
 #endif // UTILS_H
\ No newline at end of file
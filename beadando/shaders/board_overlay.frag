@@ -0,0 +1,38 @@
+#version 330 core
+
+in vec2 GridPos;
+
+uniform usampler2D boardState;
+
+out vec4 FragColor;
+
+// BoardCellFlag
+const uint CELL_PLACEABLE = 1u;
+const uint CELL_ENEMY_RANGE = 2u;
+const uint CELL_HOVERED = 4u;
+
+const float EDGE_WIDTH = 0.06; // In tiles
+
+void main()
+{
+    ivec2 cell = clamp(ivec2(floor(GridPos)), ivec2(0), textureSize(boardState, 0) - 1);
+    uint flags = texelFetch(boardState, cell, 0).r;
+    if (flags == 0u) discard;
+
+    vec2 local = fract(GridPos);
+    bool edge = any(lessThan(local, vec2(EDGE_WIDTH))) || any(greaterThan(local, vec2(1.0 - EDGE_WIDTH)));
+
+    vec4 color = vec4(0.0);
+    if ((flags & CELL_ENEMY_RANGE) != 0u) color = vec4(1.0, 0.25, 0.2, 0.22);
+    if ((flags & CELL_PLACEABLE) != 0u) color = mix(color, vec4(0.3, 1.0, 0.4, 0.3), 0.7);
+    if ((flags & CELL_HOVERED) != 0u) {
+        // Green outline where the selected unit can go, white otherwise
+        vec3 outline = (flags & CELL_PLACEABLE) != 0u ? vec3(0.5, 1.0, 0.5) : vec3(1.0);
+        if (edge) color = vec4(outline, 0.9);
+        else color.a = max(color.a, 0.12);
+    } else if (edge) {
+        color.a *= 1.6;
+    }
+    if (color.a <= 0.0) discard;
+    FragColor = color;
+}
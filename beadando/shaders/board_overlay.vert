@@ -0,0 +1,28 @@
+#version 330 core
+
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
+
+uniform usampler2D boardState; // One texel per tile (see board_overlay.h)
+
+const float TILE_SIZE = 1.0;      // BOARD_TILE_SIZE
+const float OVERLAY_HEIGHT = 0.01; // Just above the board surface
+
+out vec2 GridPos; // In tiles
+
+void main()
+{
+    // One quad over the whole board, the grid size comes from the state texture
+    vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));
+    GridPos = corner * vec2(textureSize(boardState, 0));
+    gl_Position = projection * view * vec4(GridPos.x * TILE_SIZE, OVERLAY_HEIGHT, GridPos.y * TILE_SIZE, 1.0);
+}
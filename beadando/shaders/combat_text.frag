@@ -0,0 +1,23 @@
+#version 330 core
+
+in vec2 TexCoord;
+in vec4 Color;
+
+uniform sampler2D fontAtlas; // Signed distance field, 0.5 on the outline (see sdf_font.h)
+
+out vec4 FragColor;
+
+const float OUTLINE = 0.15; // Field range of the dark outline outside the glyph
+
+void main()
+{
+    float field = texture(fontAtlas, TexCoord).r;
+    float width = max(fwidth(field), 0.001); // One screen pixel of antialiasing at any size
+
+    float fill = smoothstep(0.5 - width, 0.5 + width, field);
+    float shape = smoothstep(0.5 - OUTLINE - width, 0.5 - OUTLINE + width, field);
+    if (shape <= 0.0) discard;
+
+    vec3 color = mix(vec3(0.05), Color.rgb, fill);
+    FragColor = vec4(color, Color.a * shape);
+}
@@ -0,0 +1,42 @@
+#version 330 core
+
+// Glyph quad vertex (see combat_text.h)
+layout (location = 0) in vec4 aAnchorProgress; // xyz: world position of the popup, w: age / lifetime
+layout (location = 1) in vec4 aOffsetUV;       // xy: offset in billboard space, zw: atlas coordinates
+layout (location = 2) in vec4 aColor;
+
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
+
+const float RISE = 0.6;      // World units over the lifetime
+const float POP_TIME = 0.12; // Fraction of the lifetime spent growing in
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main()
+{
+    float progress = aAnchorProgress.w;
+
+    // Pop in slightly oversized, then settle; fade out over the last part of the lifetime
+    float pop = progress < POP_TIME ? mix(1.4, 1.0, progress / POP_TIME) : 1.0;
+    float fade = 1.0 - smoothstep(0.6, 1.0, progress);
+
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec2 offset = aOffsetUV.xy * pop;
+    vec3 world = aAnchorProgress.xyz + vec3(0.0, RISE * progress, 0.0) + right * offset.x + up * offset.y;
+
+    gl_Position = projection * view * vec4(world, 1.0);
+    TexCoord = aOffsetUV.zw;
+    Color = vec4(aColor.rgb, aColor.a * fade);
+}
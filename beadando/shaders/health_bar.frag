@@ -0,0 +1,25 @@
+#version 330 core
+
+in vec2 BarUV;
+flat in float Health;
+flat in float Charge;
+flat in vec3 TeamColor;
+
+out vec4 FragColor;
+
+const vec2 BORDER = vec2(0.02, 0.12); // In bar UV, roughly equal thickness on both axes
+const float CHARGE_SPLIT = 0.3;       // Bottom part of the bar shows the attack charge
+
+void main()
+{
+    vec4 color = vec4(0.05, 0.05, 0.05, 0.85); // Frame and empty part
+    vec2 inner = (BarUV - BORDER) / (1.0 - 2.0 * BORDER);
+    if (all(greaterThanEqual(inner, vec2(0.0))) && all(lessThanEqual(inner, vec2(1.0)))) {
+        if (inner.y >= CHARGE_SPLIT + BORDER.y) {
+            if (inner.x <= Health) color = vec4(TeamColor, 1.0);
+        } else if (inner.y < CHARGE_SPLIT) {
+            if (inner.x <= Charge) color = vec4(0.3, 0.55, 1.0, 1.0);
+        }
+    }
+    FragColor = color;
+}
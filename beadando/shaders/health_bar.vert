@@ -0,0 +1,42 @@
+#version 330 core
+
+// Per-instance bar (see health_bars.h), the quad corners come from gl_VertexID
+layout (location = 0) in vec4 aPositionHealth; // xyz: world position of the bar centre, w: HP fraction
+layout (location = 1) in vec4 aColor;          // rgb: team colour, a: attack charge fraction
+
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
+
+const vec2 BAR_HALF_SIZE = vec2(0.4, 0.07);
+
+out vec2 BarUV;
+flat out float Health;
+flat out float Charge;
+flat out vec3 TeamColor;
+
+void main()
+{
+    // Triangle strip: (0,0), (1,0), (0,1), (1,1)
+    vec2 uv = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));
+
+    // Facing the camera: its right and up are the first two rows of the view matrix
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec2 offset = (uv * 2.0 - 1.0) * BAR_HALF_SIZE;
+    vec3 world = aPositionHealth.xyz + right * offset.x + up * offset.y;
+
+    gl_Position = projection * view * vec4(world, 1.0);
+    BarUV = uv;
+    Health = aPositionHealth.w;
+    Charge = aColor.a;
+    TeamColor = aColor.rgb;
+}
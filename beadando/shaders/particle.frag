@@ -0,0 +1,14 @@
+#version 330 core
+
+in vec2 Corner;
+in vec4 Color;
+
+out vec4 FragColor;
+
+void main()
+{
+    // Soft round sprite
+    float falloff = 1.0 - dot(Corner, Corner);
+    if (falloff <= 0.0) discard;
+    FragColor = vec4(Color.rgb, Color.a * falloff * falloff);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+
+// Per-instance billboard (see particles.h), the quad corners come from gl_VertexID
+layout (location = 0) in vec4 aPositionSize; // xyz: world position, w: half size
+layout (location = 1) in vec4 aColor;
+
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
+
+out vec2 Corner;
+out vec4 Color;
+
+void main()
+{
+    // Triangle strip: (-1,-1), (1,-1), (-1,1), (1,1)
+    vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1)) * 2.0 - 1.0;
+
+    // Camera right and up are the first two rows of the view matrix
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 world = aPositionSize.xyz + (right * corner.x + up * corner.y) * aPositionSize.w;
+
+    gl_Position = projection * view * vec4(world, 1.0);
+    Corner = corner;
+    Color = aColor;
+}
@@ -0,0 +1,22 @@
+#version 330 core
+
+// Depth-only pass of the shadow map casters (see shadow_map.c)
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aModel; // Per-instance, locations 3-6 (see instance_buffer.h)
+
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
+
+void main()
+{
+    gl_Position = lightSpace * aModel * vec4(aPos, 1.0);
+}
@@ -3,39 +3,120 @@
 in vec3 FragPos_world;
 in vec3 FragNormal_world;
 in vec2 TexCoord;
+in vec4 ColorTint;
+flat in float TextureLayer;
 
 out vec4 FragColor;
 
-uniform sampler2D texture1;         // Name: texture1
-uniform vec4 uColorTint;          // Name: uColorTint
+uniform sampler2DArray texture1;    // Name: texture1
 
-uniform vec3 lightDir_world;      // Name: lightDir_world
-uniform vec3 lightColor;          // Name: lightColor
-uniform vec3 ambientLightColor;   // Name: ambientLightColor
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
 
 uniform vec3 materialDiffuseColor; // Name: materialDiffuseColor
 uniform vec3 materialSpecularColor;// Name: materialSpecularColor
 uniform float materialShininess;   // Name: materialShininess
 
-uniform vec3 viewPos_world;       // Name: viewPos_world
+#ifdef POINT_LIGHTS
+// Keep in sync with point_lights.h
+#define MAX_POINT_LIGHTS 256
+#define LIGHT_GRID_SIZE 8
+#define LIGHT_GRID_CELLS (LIGHT_GRID_SIZE * LIGHT_GRID_SIZE)
+#define MAX_LIGHT_INDICES 1536
+
+// Point lights binned into board cells on the CPU every frame
+layout (std140) uniform PointLightUniforms {
+    ivec4 pointLightCounts;                      // x: lights, y: indices
+    vec4 lightGrid;                              // xy: world xz of the grid origin, zw: cell size
+    vec4 pointLights[MAX_POINT_LIGHTS * 2];      // [2i]: position, radius; [2i + 1]: color * intensity
+    ivec4 lightCells[LIGHT_GRID_CELLS];          // x: first index, y: light count
+    ivec4 lightIndices[MAX_LIGHT_INDICES / 4];
+};
+
+// Diffuse light of the point lights in the fragment's cell only
+vec3 pointLighting(vec3 normal)
+{
+    ivec2 cell = ivec2(floor((FragPos_world.xz - lightGrid.xy) / lightGrid.zw));
+    if (any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, ivec2(LIGHT_GRID_SIZE)))) return vec3(0.0);
+
+    ivec4 range = lightCells[cell.y * LIGHT_GRID_SIZE + cell.x];
+    vec3 result = vec3(0.0);
+    for (int i = 0; i < range.y; ++i) {
+        int slot = range.x + i;
+        int index = lightIndices[slot / 4][slot % 4];
+        vec4 positionRadius = pointLights[2 * index];
+        vec3 toLight = positionRadius.xyz - FragPos_world;
+        float lightDistance = length(toLight);
+        if (lightDistance >= positionRadius.w) continue;
+
+        float falloff = 1.0 - lightDistance / positionRadius.w;
+        float diff = max(dot(normal, toLight / max(lightDistance, 0.0001)), 0.0);
+        result += diff * falloff * falloff * pointLights[2 * index + 1].rgb;
+    }
+    return result * materialDiffuseColor;
+}
+#endif
+
+#ifdef SHADOWS
+uniform sampler2DShadow shadowMap; // Name: shadowMap
+
+// Fraction of the light reaching the fragment: 3x3 taps, each a hardware 2x2 comparison
+float shadowVisibility(vec3 normal, vec3 lightDirection)
+{
+    vec4 lightClip = lightSpace * vec4(FragPos_world, 1.0);
+    vec3 coords = lightClip.xyz / lightClip.w * 0.5 + 0.5;
+    if (coords.z > 1.0) return 1.0;
+
+    float bias = max(0.002 * (1.0 - dot(normal, lightDirection)), 0.0005);
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+    float visibility = 0.0;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            visibility += texture(shadowMap, vec3(coords.xy + vec2(x, y) * texel, coords.z - bias));
+        }
+    }
+    return visibility / 9.0;
+}
+#endif
 
 void main()
 {
-    vec4 texColor = texture(texture1, TexCoord) * uColorTint; // Uses texture1, uColorTint
+    vec4 texColor = texture(texture1, vec3(TexCoord, TextureLayer)) * ColorTint; // Uses texture1, per-instance tint and layer
 
+#ifdef UNLIT
+    FragColor = texColor;
+#else
     vec3 norm = normalize(FragNormal_world);
-    vec3 lightDirection = normalize(lightDir_world);         // Uses lightDir_world
+    vec3 lightDirection = normalize(lightDir_world.xyz);     // Uses lightDir_world
 
-    vec3 ambient = ambientLightColor * materialDiffuseColor; // Uses ambientLightColor, materialDiffuseColor
+    vec3 ambient = ambientLightColor.rgb * materialDiffuseColor; // Uses ambientLightColor, materialDiffuseColor
 
     float diff = max(dot(norm, lightDirection), 0.0);
-    vec3 diffuse = diff * lightColor * materialDiffuseColor; // Uses lightColor, materialDiffuseColor
+    vec3 diffuse = diff * lightColor.rgb * materialDiffuseColor; // Uses lightColor, materialDiffuseColor
 
-    vec3 viewDir = normalize(viewPos_world - FragPos_world); // Uses viewPos_world
+    vec3 viewDir = normalize(viewPos_world.xyz - FragPos_world); // Uses viewPos_world
     vec3 reflectDir = reflect(-lightDirection, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), materialShininess); // Uses materialShininess
-    vec3 specular = spec * lightColor * materialSpecularColor; // Uses lightColor, materialSpecularColor
+    vec3 specular = spec * lightColor.rgb * materialSpecularColor; // Uses lightColor, materialSpecularColor
 
-    vec3 lightingResult = ambient + diffuse + specular;
+#ifdef SHADOWS
+    float visibility = shadowVisibility(norm, lightDirection);
+#else
+    float visibility = 1.0;
+#endif
+    vec3 lightingResult = ambient + (diffuse + specular) * visibility;
+#ifdef POINT_LIGHTS
+    lightingResult += pointLighting(norm);
+#endif
     FragColor = vec4(lightingResult * texColor.rgb, texColor.a);
+#endif
 }
\ No newline at end of file
@@ -4,27 +4,83 @@ layout (location = 0) in vec3 aPos;      // Vertex position (model space)
 layout (location = 1) in vec3 aNormal;   // Vertex normal (model space)
 layout (location = 2) in vec2 aTexCoord; // Texture coordinate
 
+// Per-instance attributes (see instance_buffer.h)
+layout (location = 3) in mat4 aModel;        // Model transformation matrix, locations 3-6
+layout (location = 7) in vec4 aColorTint;    // Color tint (ghost preview, highlights)
+layout (location = 8) in float aTextureLayer; // Layer in the scene texture array
+layout (location = 9) in vec2 aAnimation;     // x: UnitAnimation, y: start time (scene seconds)
+
 // Outputs to Fragment Shader
 out vec3 FragPos_world;   // Vertex position in world space
 out vec3 FragNormal_world; // Normal in world space
 out vec2 TexCoord;
+out vec4 ColorTint;
+flat out float TextureLayer;
+
+// Per-frame constants (see frame_uniforms.h), shared by every variant
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 viewPos_world;
+    vec4 lightDir_world;
+    vec4 lightColor;
+    vec4 ambientLightColor;
+    mat4 lightSpace;
+    vec4 sceneTime; // x: seconds
+};
+
+// UnitAnimation (see unit.h)
+const int ANIM_NONE = 0;
+const int ANIM_ATTACK = 2;
+const int ANIM_HIT = 3;
+const int ANIM_DEATH = 4;
+
+const float ATTACK_DURATION = 0.3;
+const float HIT_DURATION = 0.25;
+const float DEATH_DURATION = 0.6; // UNIT_DEATH_DURATION
 
-// Uniforms (values set from C++ code)
-uniform mat4 model;      // Model transformation matrix
-uniform mat4 view;       // View transformation matrix
-uniform mat4 projection; // Projection transformation matrix
+// Procedural unit animation in model space, where +Z is the facing direction
+vec3 animatePosition(vec3 position, inout vec4 tint)
+{
+    int animation = int(aAnimation.x + 0.5);
+    if (animation == ANIM_NONE) return position;
+    float t = sceneTime.x - aAnimation.y;
+
+    // Idle bob, phased by the board position so neighbours do not move in lockstep
+    float phase = dot(aModel[3].xz, vec2(1.7, 2.3));
+    vec3 offset = vec3(0.0, 0.04 * (sin(sceneTime.x * 2.5 + phase) + 1.0), 0.0);
+    float scale = 1.0;
+
+    if (animation == ANIM_ATTACK && t < ATTACK_DURATION) {
+        offset.z += 0.35 * sin(3.14159265 * t / ATTACK_DURATION); // Lunge towards the target
+    } else if (animation == ANIM_HIT && t < HIT_DURATION) {
+        float strength = 1.0 - t / HIT_DURATION;
+        offset.z -= 0.1 * strength; // Recoil
+        tint.rgb += vec3(strength); // White flash
+    } else if (animation == ANIM_DEATH) {
+        float progress = clamp(t / DEATH_DURATION, 0.0, 1.0);
+        scale = 1.0 - progress;
+        offset = vec3(0.0, -0.3 * progress, 0.0);
+        tint.rgb *= 1.0 - 0.5 * progress;
+    }
+    return position * scale + offset;
+}
 
 void main()
 {
-    FragPos_world = vec3(model * vec4(aPos, 1.0));
+    vec4 tint = aColorTint;
+    vec3 position = animatePosition(aPos, tint);
+    FragPos_world = vec3(aModel * vec4(position, 1.0));
 
-    FragNormal_world = normalize(mat3(transpose(inverse(model))) * aNormal);
+    FragNormal_world = normalize(mat3(transpose(inverse(aModel))) * aNormal);
     if (length(FragNormal_world) < 0.001) {
         FragNormal_world = vec3(0.0, 1.0, 0.0); // Default to up if it's zero
     }
     // Calculate final position in clip space
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * vec4(FragPos_world, 1.0);
 
-    // Pass texture coordinate to fragment shader
+    // Pass texture coordinate and instance data to fragment shader
     TexCoord = aTexCoord;
+    ColorTint = tint;
+    TextureLayer = aTextureLayer;
 }
\ No newline at end of file
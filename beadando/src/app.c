@@ -8,12 +8,20 @@
 #include <stdio.h>
 
 #include "shader.h"
+#include "shader_manager.h"
 #include "scene.h"
 #include "imgui_interface.h" // Include the C wrapper header
 #include "board.h"
 #include "input.h"
+#include "input_record.h"
 #include "game_state.h"
 #include "unit.h"
+#include "render_stats.h"
+#include "asset_pack.h"
+#include "metrics.h"
+#include "job_system.h"
+#include "arena.h"
+#include "utils.h"
 
 #define ACTION_FLAG_NONE           0
 #define ACTION_FLAG_REFRESH_SHOP   (1 << 0)
@@ -21,60 +29,10 @@
 #define ACTION_FLAG_BUY_UNIT_TYPE_1     (1 << 2)
 #define ACTION_FLAG_START_COMBAT   (1 << 10)
 
-void cache_shader_uniform_locations(App* app) {
-    if (app->shader_program == 0) {
-        printf("[ERROR] cache_shader_uniform_locations: shader_program is 0!\n");
-        return;
-    }
-    printf("DEBUG: cache_shader_uniform_locations - Using program %u\n", app->shader_program);
-    glUseProgram(app->shader_program);
-    check_gl_error("glUseProgram in cache_uniforms");
-
-    app->shader_uloc_projection = glGetUniformLocation(app->shader_program, "projection");
-    check_gl_error("glGetUniformLocation for projection");
-    app->shader_uloc_view = glGetUniformLocation(app->shader_program, "view");
-    check_gl_error("glGetUniformLocation for view");
-    app->shader_uloc_model = glGetUniformLocation(app->shader_program, "model");
-    check_gl_error("glGetUniformLocation for model");
-    app->shader_uloc_texture1 = glGetUniformLocation(app->shader_program, "texture1");
-    check_gl_error("glGetUniformLocation for texture1");
-    app->shader_uloc_color_tint = glGetUniformLocation(app->shader_program, "uColorTint");
-    check_gl_error("glGetUniformLocation for uColorTint");
-    app->shader_uloc_lightDir = glGetUniformLocation(app->shader_program, "lightDir_world");
-    check_gl_error("glGetUniformLocation for lightDir_world");
-    app->shader_uloc_lightColor = glGetUniformLocation(app->shader_program, "lightColor");
-    check_gl_error("glGetUniformLocation for lightColor");
-    app->shader_uloc_ambientLightColor = glGetUniformLocation(app->shader_program, "ambientLightColor");
-    check_gl_error("glGetUniformLocation for ambientLightColor");
-    app->shader_uloc_viewPos = glGetUniformLocation(app->shader_program, "viewPos_world");
-    check_gl_error("glGetUniformLocation for viewPos_world");
-    app->shader_uloc_materialDiffuse = glGetUniformLocation(app->shader_program, "materialDiffuseColor");
-    check_gl_error("glGetUniformLocation for materialDiffuseColor");
-    app->shader_uloc_materialSpecular = glGetUniformLocation(app->shader_program, "materialSpecularColor");
-    check_gl_error("glGetUniformLocation for materialSpecularColor");
-    app->shader_uloc_materialShininess = glGetUniformLocation(app->shader_program, "materialShininess");
-    check_gl_error("glGetUniformLocation for materialShininess");
-
-    printf("[INFO] Cached shader lighting uniforms: LightDir=%d, LightColor=%d, Ambient=%d, ViewPos=%d, MatDiff=%d, MatSpec=%d, MatShine=%d\n",
-           app->shader_uloc_lightDir, app->shader_uloc_lightColor, app->shader_uloc_ambientLightColor,
-           app->shader_uloc_viewPos, app->shader_uloc_materialDiffuse, app->shader_uloc_materialSpecular,
-           app->shader_uloc_materialShininess);
-
-    printf("[INFO] Cached shader uniform locations: Proj=%d, View=%d, Model=%d, Tex1=%d, Tint=%d\n",
-           app->shader_uloc_projection, app->shader_uloc_view, app->shader_uloc_model,
-           app->shader_uloc_texture1, app->shader_uloc_color_tint);
-    
-    if (app->shader_uloc_color_tint != -1) {
-        printf("DEBUG: cache_shader_uniform_locations - Attempting to set uColorTint (loc %d) immediately.\n", app->shader_uloc_color_tint);
-        glUniform4f(app->shader_uloc_color_tint, 0.5f, 0.5f, 0.5f, 0.5f); // Use different values for test
-        check_gl_error("TEST Set uColorTint immediately in cache_uniforms");
-    } else {
-        printf("[WARN] uColorTint uniform not found in shader program %u during cache!\n", app->shader_program);
-    }
-
-    glUseProgram(0);
-    check_gl_error("glUseProgram(0) in cache_uniforms");
-}
+// Frame phases in the metrics registry (frame_ms is the whole frame, see metrics.h)
+static int update_time_metric = -1;
+static int render_time_metric = -1;
+static int units_simulated_metric = -1;
 
 void init_app(App* app, int width, int height)
 {
@@ -84,21 +42,6 @@ void init_app(App* app, int width, int height)
 
     app->is_running = false;
     app->uptime = 0.0; // Initialize uptime
-    app->selected_bench_unit_index = -1;
-    app->show_help_window = false;
-
-    // --- Initialize Lighting Properties ---
-    printf("DEBUG: init_app - Initializing Lighting...\n");
-    // Directional light pointing from above-right-front towards origin
-    glm_vec3_copy((vec3){0.5f, 1.0f, 0.7f}, app->light_direction_world); // Direction *towards* light source
-    glm_vec3_normalize(app->light_direction_world); // Ensure it's normalized
-    glm_vec3_copy((vec3){1.0f, 1.0f, 1.0f}, app->light_color);        // Bright white light
-    glm_vec3_copy((vec3){0.25f, 0.25f, 0.3f}, app->ambient_light_color); // Dim ambient
-
-    // --- Initialize input_state ---
-    memset(&app->input_state, 0, sizeof(InputState));
-    app->input_state.hovered_grid_x = -1;
-    app->input_state.hovered_grid_y = -1;
 
     // --- SDL Init ---
     error_code = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_EVENTS); // Init only necessary subsystems
@@ -164,31 +107,28 @@ void init_app(App* app, int width, int height)
         return;
     }
 
-    // --- VSync --- (0 = off, 1 = on, -1 = adaptive)
-    if (SDL_GL_SetSwapInterval(1) < 0) {
-         printf("[WARN] Unable to set VSync: %s\n", SDL_GetError());
-    }
+    // --- VSync and frame limiter --- (adaptive where supported, main.c applies --fps / --vsync)
+    init_frame_pacer(&app->frame_pacer, app->window, 0, VSYNC_ADAPTIVE);
 
-    // --- Shaders ---
-    app->shader_program = load_shaders("shaders/simple.vert", "shaders/simple.frag");
-    if (app->shader_program == 0) {
+    // --- Shaders, scene and game state ---
+    if (!init_app_resources(app, width, height)) {
         printf("[ERROR] Failed to load shaders. Exiting.\n");
-        // Perform cleanup similar to other init failures
         SDL_GL_DeleteContext(app->gl_context);
         IMG_Quit();
         SDL_DestroyWindow(app->window);
         SDL_Quit();
         return;
     }
-    cache_shader_uniform_locations(app);
-    
+    init_dynamic_resolution(&app->dynamic_resolution);
+
     // --- Dear ImGui ---
     printf("DEBUG: init_app - Initializing ImGui...\n");
     
     // Initialize ImGui using the C wrapper
     if (!ImGui_InitWrapper(app->window, app->gl_context)) {
         printf("[ERROR] Failed to initialize ImGui. Exiting.\n");
-        glDeleteProgram(app->shader_program);
+        destroy_dynamic_resolution(&app->dynamic_resolution);
+        destroy_app_resources(app);
         SDL_GL_DeleteContext(app->gl_context);
         IMG_Quit();
         SDL_DestroyWindow(app->window);
@@ -197,6 +137,90 @@ void init_app(App* app, int width, int height)
     }
     printf("DEBUG: init_app - ImGui Initialized.\n");
 
+    app->is_running = true;
+    app->redraw_frames = APP_REDRAW_FRAMES;
+    
+    printf("DEBUG: init_app - END\n");
+}
+
+bool init_app_resources(App* app, int width, int height)
+{
+    app->selected_bench_unit_index = -1;
+    app->show_help_window = false;
+    app->show_render_stats_window = false;
+
+    // --- Metrics (the render counters first, so they lead the streamed columns) ---
+    init_render_stats();
+    update_time_metric = register_metric("update_ms", METRIC_GAUGE);
+    render_time_metric = register_metric("render_ms", METRIC_GAUGE);
+    units_simulated_metric = register_metric("units_simulated", METRIC_COUNTER);
+
+    // --- Frame, round and scratch arenas (see arena.h) ---
+    init_arenas();
+
+    // --- Worker threads, before anything loads (see job_system.h) ---
+    init_job_system(0);
+
+    // --- Render snapshots; the simulation runs inline until set_app_pipelined ---
+    app->pipelined = false;
+    app->simulation_counter = (JobCounter){{0}};
+    app->pending_ui_actions = ACTION_FLAG_NONE;
+    if (!init_render_snapshots(&app->snapshots)) {
+        shutdown_job_system();
+        destroy_arenas();
+        return false;
+    }
+
+    // --- Initialize Lighting Properties ---
+    printf("DEBUG: init_app - Initializing Lighting...\n");
+    // Directional light pointing from above-right-front towards origin
+    glm_vec3_copy((vec3){0.5f, 1.0f, 0.7f}, app->light_direction_world); // Direction *towards* light source
+    glm_vec3_normalize(app->light_direction_world); // Ensure it's normalized
+    glm_vec3_copy((vec3){1.0f, 1.0f, 1.0f}, app->light_color);        // Bright white light
+    glm_vec3_copy((vec3){0.25f, 0.25f, 0.3f}, app->ambient_light_color); // Dim ambient
+
+    // --- Initialize input_state ---
+    memset(&app->input_state, 0, sizeof(InputState));
+    app->input_state.hovered_grid_x = -1;
+    app->input_state.hovered_grid_y = -1;
+    init_input_recorder(&app->input_recorder);
+
+    // --- Asset pack (falls back to the loose files when missing) ---
+    mount_asset_pack(ASSET_PACK_PATH);
+
+    // --- Shaders (hot reloaded from the loose files in development) ---
+    init_shader_manager(&app->shader_manager, !is_asset_pack_mounted());
+    app->main_shader = load_shader(&app->shader_manager, "shaders/simple.vert", "shaders/simple.frag");
+    if (app->main_shader < 0) {
+        destroy_shader_manager(&app->shader_manager);
+        unmount_asset_pack();
+        shutdown_job_system();
+        destroy_render_snapshots(&app->snapshots);
+        destroy_arenas();
+        return false;
+    }
+    app->shadow_shader = load_shader(&app->shader_manager, "shaders/shadow.vert", "shaders/shadow.frag");
+    if (app->shadow_shader < 0) {
+        printf("[WARN] Shadow shader failed to load, rendering without shadows.\n");
+    }
+    app->particle_shader = load_shader(&app->shader_manager, "shaders/particle.vert", "shaders/particle.frag");
+    if (app->particle_shader < 0) {
+        printf("[WARN] Particle shader failed to load, rendering without particles.\n");
+    }
+    app->health_bar_shader = load_shader(&app->shader_manager, "shaders/health_bar.vert", "shaders/health_bar.frag");
+    if (app->health_bar_shader < 0) {
+        printf("[WARN] Health bar shader failed to load, rendering without HP bars.\n");
+    }
+    app->board_overlay_shader = load_shader(&app->shader_manager, "shaders/board_overlay.vert", "shaders/board_overlay.frag");
+    if (app->board_overlay_shader < 0) {
+        printf("[WARN] Board overlay shader failed to load, rendering without tile highlights.\n");
+    }
+    app->combat_text_shader = load_shader(&app->shader_manager, "shaders/combat_text.vert", "shaders/combat_text.frag");
+    if (app->combat_text_shader < 0) {
+        printf("[WARN] Combat text shader failed to load, rendering without damage numbers.\n");
+    }
+    app->frame_uniform_buffer = create_frame_uniform_buffer();
+    
     // --- Core GL State ---
     init_opengl();
     reshape(width, height); // Set initial viewport
@@ -220,18 +244,15 @@ void init_app(App* app, int width, int height)
     };
     init_camera(&(app->camera), board_center); // Pass initial target
     init_scene(&(app->scene));
-    printf("DEBUG: init_app - Checking VAO ID immediately after init_scene: %u\n", app->scene.board.model.vao_id);
-    if(app->scene.board.model.vao_id == 0) {
-        printf("[CRITICAL ERROR] VAO ID is 0 immediately after init_scene.\n");
+    printf("DEBUG: init_app - Checking mesh pool VAO immediately after init_scene: %u\n", app->scene.mesh_pool.vao_id);
+    if(app->scene.mesh_pool.vao_id == 0 || app->scene.board.mesh < 0) {
+        printf("[CRITICAL ERROR] Board mesh is missing immediately after init_scene.\n");
     }
 
     // --- Matrices ---
     glm_mat4_identity(app->projection_matrix);
     glm_mat4_identity(app->view_matrix);
-    
-    app->is_running = true;
-    
-    printf("DEBUG: init_app - END\n");
+    return true;
 }
 
 void init_opengl()
@@ -282,8 +303,8 @@ void process_game_input_and_logic(App* app) {
     }
 
     if (is_camera_rotating_with_mouse) {
-        int mouse_dx, mouse_dy;
-        SDL_GetRelativeMouseState(&mouse_dx, &mouse_dy); // Get motion since last call
+        int mouse_dx = app->input_state.mouse_delta_x; // Motion since the last frame
+        int mouse_dy = app->input_state.mouse_delta_y;
 
         if (ignore_first_mouse_delta_after_capture) {
             // printf("DEBUG: Ignoring first mouse delta: dx=%d, dy=%d\n", mouse_dx, mouse_dy);
@@ -318,7 +339,7 @@ void process_game_input_and_logic(App* app) {
                     printf("DEBUG: Mouse is over board at (%d, %d)\n", app->input_state.hovered_grid_x, app->input_state.hovered_grid_y);
 
                     bool on_player_side = is_tile_on_player_side(app->input_state.hovered_grid_y);
-                    bool tile_empty = !is_tile_occupied(&app->scene, app->input_state.hovered_grid_x, app->input_state.hovered_grid_y, NULL);
+                    bool tile_empty = is_tile_empty_for_player(&app->scene, app->input_state.hovered_grid_x, app->input_state.hovered_grid_y);
 
                     printf("DEBUG: Placing at (%d, %d). Player side: %s, Tile empty: %s\n",
                            app->input_state.hovered_grid_x, app->input_state.hovered_grid_y,
@@ -376,6 +397,10 @@ void process_game_input_and_logic(App* app) {
         printf("DEBUG: F1 pressed. Show help: %s\n", app->show_help_window ? "Yes" : "No");
     }
 
+    if (app->input_state.f3_pressed_this_frame && !app->input_state.imgui_wants_keyboard) {
+        app->show_render_stats_window = !app->show_render_stats_window;
+    }
+
     // --- Light Adjustment Example ---
     // Assuming these flags are set in InputState by InputManager_PollAndProcess for SDL_SCANCODE_KP_PLUS / MINUS
     if (app->input_state.plus_key_pressed && !app->input_state.imgui_wants_keyboard) {
@@ -394,10 +419,175 @@ void process_game_input_and_logic(App* app) {
     // --- Other general key presses for single actions ---
 }
 
+/**
+ * Checksum of everything the simulation owns after a tick, compared by input replays.
+ * Hashed field by field so struct padding never enters it.
+ */
+static uint64_t hash_simulation_state(const App* app)
+{
+    const GameState* game = &app->game_state;
+    uint64_t hash = FNV1A64_OFFSET_BASIS;
+    hash = hash_fnv1a64(hash, &game->current_phase, sizeof(game->current_phase));
+    hash = hash_fnv1a64(hash, &game->player_hp, sizeof(game->player_hp));
+    hash = hash_fnv1a64(hash, &game->player_gold, sizeof(game->player_gold));
+    hash = hash_fnv1a64(hash, &game->current_wave, sizeof(game->current_wave));
+    hash = hash_fnv1a64(hash, &game->combat_phase_timer, sizeof(game->combat_phase_timer));
+    hash = hash_fnv1a64(hash, &app->selected_bench_unit_index, sizeof(app->selected_bench_unit_index));
+    hash = hash_fnv1a64(hash, app->camera.position, sizeof(vec3));
+    hash = hash_fnv1a64(hash, &app->scene.unit_count, sizeof(app->scene.unit_count));
+
+    for (int i = 0; i < app->scene.unit_count; ++i) {
+        const Unit* unit = &app->scene.units[i];
+        hash = hash_fnv1a64(hash, &unit->type, sizeof(unit->type));
+        hash = hash_fnv1a64(hash, &unit->location, sizeof(unit->location));
+        hash = hash_fnv1a64(hash, &unit->grid_x, sizeof(unit->grid_x));
+        hash = hash_fnv1a64(hash, &unit->grid_y, sizeof(unit->grid_y));
+        hash = hash_fnv1a64(hash, unit->world_pos, sizeof(vec3));
+        hash = hash_fnv1a64(hash, &unit->current_hp, sizeof(unit->current_hp));
+        hash = hash_fnv1a64(hash, &unit->current_combat_state, sizeof(unit->current_combat_state));
+        hash = hash_fnv1a64(hash, &unit->attack_cooldown_timer, sizeof(unit->attack_cooldown_timer));
+        hash = hash_fnv1a64(hash, &unit->is_alive, sizeof(unit->is_alive));
+    }
+    return hash;
+}
+
+/**
+ * Shop and combat buttons of a drawn frame. They add units, so with a pipelined simulation they wait
+ * for the step in flight to finish (see finish_app_simulation).
+ */
+static void apply_ui_actions(App* app, int shop_actions)
+{
+    // These actions should only be processed if they could have been triggered (e.g., in Prepare Phase)
+    if (app->game_state.current_phase == PHASE_PREPARE && shop_actions != ACTION_FLAG_NONE) {
+        printf("DEBUG: Shop action flags received: %d\n", shop_actions);
+
+        // Handle Start Combat action
+        if (shop_actions & ACTION_FLAG_START_COMBAT) {
+            printf("Action: Start Combat triggered!\n");
+
+            // --- Spawn AI Wave ---
+            printf("DEBUG: Spawning AI wave %d...\n", app->game_state.current_wave);
+            // For now, spawn simple fixed AI wave.
+            // Ensure player units are not overwritten if MAX_UNITS is tight.
+            // This assumes add_unit_to_bench finds slots in the combined units array.
+            // Better: add_unit_to_board_directly function or use a different list for active combatants.
+
+            // Example: Spawn 2 AI units (make sure MAX_UNITS allows this)
+            // These will be added to scene.units and their location set to LOC_BOARD
+            // We need a robust way to add them to the board, let's modify init_unit to handle this.
+            // And ensure existing AI from previous rounds are cleared.
+            // Clearing AI is now done in PHASE_POST_COMBAT logic.
+
+            if (app->scene.unit_count < MAX_UNITS) {
+                init_unit(&app->scene.units[app->scene.unit_count++], UNIT_MELEE_TANK, 3, BOARD_GRID_HEIGHT - 2, false, LOC_BOARD);
+            }
+            if (app->scene.unit_count < MAX_UNITS) {
+                init_unit(&app->scene.units[app->scene.unit_count++], UNIT_RANGED_ARCHER, 4, BOARD_GRID_HEIGHT - 2, false, LOC_BOARD);
+            }
+            printf("DEBUG: AI units spawned. Total units: %d\n", app->scene.unit_count);
+
+            app->game_state.current_phase = PHASE_COMBAT;
+            app->game_state.combat_phase_timer = 0.0f;
+            app->selected_bench_unit_index = -1;
+        }
+
+        // --- Handle Buy actions using new flags ---
+        if (shop_actions & ACTION_FLAG_BUY_UNIT_TYPE_0) { // Buy Tank
+            int cost = get_unit_cost(UNIT_MELEE_TANK); // Get cost
+            printf("Action: Attempting to buy Tank (Cost: %d, Current Gold: %d)...\n", cost, app->game_state.player_gold);
+            if (app->game_state.player_gold >= cost) { // Check gold
+                if (add_unit_to_bench(&app->scene, UNIT_MELEE_TANK)) {
+                    app->game_state.player_gold -= cost; // Deduct gold
+                    printf("Purchase successful! Gold remaining: %d\n", app->game_state.player_gold);
+                } else {
+                    printf("Action Failed: Bench is full or max units reached for Tank!\n");
+                    // No gold deducted if add_unit_to_bench fails
+                }
+            } else {
+                printf("Action Failed: Not enough gold for Tank!\n");
+            }
+        }
+        if (shop_actions & ACTION_FLAG_BUY_UNIT_TYPE_1) { // Buy Archer
+            int cost = get_unit_cost(UNIT_RANGED_ARCHER); // Get cost
+            printf("Action: Attempting to buy Archer (Cost: %d, Current Gold: %d)...\n", cost, app->game_state.player_gold);
+            if (app->game_state.player_gold >= cost) { // Check gold
+                if (add_unit_to_bench(&app->scene, UNIT_RANGED_ARCHER)) {
+                    app->game_state.player_gold -= cost; // Deduct gold
+                    printf("Purchase successful! Gold remaining: %d\n", app->game_state.player_gold);
+                } else {
+                    printf("Action Failed: Bench is full or max units reached for Archer!\n");
+                }
+            } else {
+                printf("Action Failed: Not enough gold for Archer!\n");
+            }
+        }
+        // Add more unit type buy handlers if shop expands
+
+        // Handle Refresh action
+        if (shop_actions & ACTION_FLAG_REFRESH_SHOP) {
+            int cost = 1; // Example refresh cost
+            printf("Action: Attempting Refresh Shop (Cost: %d, Current Gold: %d)...\n", cost, app->game_state.player_gold);
+            if (app->game_state.player_gold >= cost) { // Check gold
+                app->game_state.player_gold -= cost; // Deduct gold
+                printf("Refresh successful! Gold remaining: %d\n", app->game_state.player_gold);
+                // TODO: Implement logic to change shop offerings
+            } else {
+                printf("Action Failed: Not enough gold to refresh shop!\n");
+            }
+        }
+    }
+}
+
+static void simulate_scene_job(void* data)
+{
+    App* app = (App*)data;
+    update_scene(&app->scene, app->simulation_dt, app->simulation_phase);
+    if (app->snapshots.writing >= 0) {
+        capture_render_snapshot(&app->snapshots.snapshots[app->snapshots.writing], &app->scene);
+    }
+}
+
+void step_app_simulation(App* app, float dt)
+{
+    add_metric(units_simulated_metric, app->scene.unit_count);
+    app->simulation_dt = dt;
+    app->simulation_phase = app->game_state.current_phase;
+    begin_snapshot_write(&app->snapshots);
+    if (app->pipelined) {
+        run_job(simulate_scene_job, app, &app->simulation_counter);
+        return;
+    }
+    simulate_scene_job(app);
+    publish_snapshot(&app->snapshots);
+}
+
+void finish_app_simulation(App* app)
+{
+    wait_for_job_counter(&app->simulation_counter);
+    publish_snapshot(&app->snapshots);
+}
+
+void set_app_pipelined(App* app, bool pipelined)
+{
+    finish_app_simulation(app);
+    app->pipelined = pipelined && get_job_thread_count() > 1 && app->input_recorder.mode == INPUT_RECORD_OFF;
+    if (pipelined && !app->pipelined) {
+        printf("[INFO] Simulation runs inline (no job workers, or input is recorded or replayed).\n");
+    }
+}
+
 void update_app(App* app) {
     static Uint64 last_counter = 0;
     Uint64 current_counter = SDL_GetPerformanceCounter();
     double elapsed_time = 0.0;
+    app->frame_start_counter = current_counter;
+
+    // --- The step started last frame hands the scene back, with the UI actions drawn meanwhile ---
+    finish_app_simulation(app);
+    if (app->pending_ui_actions != ACTION_FLAG_NONE) {
+        apply_ui_actions(app, app->pending_ui_actions);
+        app->pending_ui_actions = ACTION_FLAG_NONE;
+    }
 
     if (last_counter != 0) {
         elapsed_time = (double)(current_counter - last_counter) / SDL_GetPerformanceFrequency();
@@ -405,10 +595,11 @@ void update_app(App* app) {
     last_counter = current_counter;
 
     if (elapsed_time > 0.1) elapsed_time = 0.1; // Clamp dt
-    app->uptime += elapsed_time;
 
     // --- Process Input and Game Logic ---
     InputManager_PollAndProcess(app, &app->input_state);
+    elapsed_time = begin_input_frame(&app->input_recorder, &app->input_state, elapsed_time); // Recorded input and dt when replaying
+    app->uptime += elapsed_time;
 
     if (app->input_state.quit_requested) {
         app->is_running = false;
@@ -417,6 +608,12 @@ void update_app(App* app) {
 
     process_game_input_and_logic(app); // Handle actions based on polled input
 
+    // --- GL work queued by the job workers ---
+    run_main_thread_jobs();
+
+    // --- Shader hot reload (variants keep their reflected uniform tables up to date) ---
+    bool shaders_reloaded = update_shader_manager(&app->shader_manager);
+
     // --- Game Phase Logic ---
     if (app->game_state.player_hp <= 0 && app->game_state.current_phase != PHASE_GAME_OVER) {
         printf("DEBUG: Player HP <= 0. GAME OVER.\n");
@@ -531,6 +728,7 @@ void update_app(App* app) {
                 }
                 app->scene.unit_count = new_unit_count;
                 printf("DEBUG: Active player units for next round: %d\n", app->scene.unit_count);
+                reset_arena(get_round_arena()); // Everything allocated for the finished round
 
 
                 app->game_state.current_phase = PHASE_PREPARE;
@@ -544,86 +742,131 @@ void update_app(App* app) {
 
     // --- Update Game Systems ---
     update_camera(&(app->camera), elapsed_time);
-    update_scene(&(app->scene), (float)elapsed_time, app->game_state.current_phase);
-    
+    bool scene_animating = is_scene_animating(&app->scene); // Read before a pipelined step takes the scene
+    step_app_simulation(app, (float)elapsed_time);
+    if (!app->pipelined) {
+        check_input_frame_state(&app->input_recorder, hash_simulation_state(app));
+    }
 
     // --- Update Matrices ---
-    calculate_view_matrix(&app->camera, app->view_matrix);
     int width, height;
     SDL_GL_GetDrawableSize(app->window, &width, &height);
+    update_app_matrices(app, width, height);
+
+    set_metric(update_time_metric, (double)(SDL_GetPerformanceCounter() - current_counter) * 1000.0 / SDL_GetPerformanceFrequency());
+
+    // --- Reactive rendering: anything that changes the picture keeps the loop drawing ---
+    const InputState* input = &app->input_state;
+    bool dirty = input->event_count > 0 ||
+                 input->left_mouse_down || input->right_mouse_down || // Dragging, camera rotation
+                 input->pan_forward_backward_intent != 0.0f || input->pan_right_left_intent != 0.0f ||
+                 app->game_state.current_phase == PHASE_COMBAT ||
+                 shaders_reloaded ||
+                 scene_animating ||
+                 app->input_recorder.mode != INPUT_RECORD_OFF; // UI decisions are recorded per drawn frame
+    if (dirty) {
+        app->redraw_frames = APP_REDRAW_FRAMES;
+    }
+}
+
+void update_app_matrices(App* app, int width, int height)
+{
+    calculate_view_matrix(&app->camera, app->view_matrix);
     if (height == 0) height = 1;
     float aspect = (float)width / (float)height;
     glm_perspective(glm_rad(VIEWPORT_ASPECT), aspect, 0.1f, 100.0f, app->projection_matrix);
 }
 
-void render_app(App* app)
+bool should_render_app(const App* app)
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    check_gl_error("glClear - render_app start");
-
-    ImGui_NewFrameWrapper();
-
-    if (app->shader_program != 0) {
-        // printf("DEBUG: render_app - Using program %u for 3D scene.\n", app->shader_program);
-        glUseProgram(app->shader_program);
-        check_gl_error("render_app - AFTER glUseProgram for 3D scene");
-
-        GLint active_program_check1 = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &active_program_check1);
-        // printf("DEBUG: render_app - Active program after explicit use: %d (Expected: %u)\n", active_program_check1, app->shader_program);
-        if (active_program_check1 != app->shader_program) {
-            printf("CRITICAL ERROR: Shader program %u is NOT active after glUseProgram!\n", app->shader_program);
-        }
-
-        // Set View, Projection matrices
-        if (app->shader_uloc_projection != -1) glUniformMatrix4fv(app->shader_uloc_projection, 1, GL_FALSE, (const GLfloat*)app->projection_matrix);
-        check_gl_error("render_app - Proj Uniform");
-        if (app->shader_uloc_view != -1) glUniformMatrix4fv(app->shader_uloc_view, 1, GL_FALSE, (const GLfloat*)app->view_matrix);
-        check_gl_error("render_app - View Uniform");
-
-        // Set Texture Sampler
-        if (app->shader_uloc_texture1 != -1) glUniform1i(app->shader_uloc_texture1, 0);
-        check_gl_error("render_app - Tex1 Uniform");
+    return app->redraw_frames > 0;
+}
 
-        // printf("DEBUG: render_app - Setting lightDir_world. Location: %d\n", app->shader_uloc_lightDir);
-        if (app->shader_uloc_lightDir != -1) {
-            glUniform3fv(app->shader_uloc_lightDir, 1, app->light_direction_world);
-            check_gl_error("render_app - glUniform3fv for lightDir_world"); // Check this one specifically
-        }
+void wait_for_app_events(App* app)
+{
+    // The event stays queued for the next update; the timeout keeps the shader file polling alive
+    int timeout = app->shader_manager.watching ? SHADER_POLL_INTERVAL : APP_IDLE_TIMEOUT;
+    SDL_WaitEventTimeout(NULL, timeout);
+}
 
-        // printf("DEBUG: render_app - Setting lightColor. Location: %d\n", app->shader_uloc_lightColor);
-        if (app->shader_uloc_lightColor != -1) {
-            glUniform3fv(app->shader_uloc_lightColor, 1, app->light_color);
-            check_gl_error("render_app - glUniform3fv for lightColor"); // Error starts here or after
-        }
+void render_app_scene(App* app)
+{
+    // Units, lights and effects as of the last finished step, never the live scene
+    const RenderSnapshot* snapshot = acquire_render_snapshot(&app->snapshots);
+    if (!snapshot) return;
+
+    // --- Per-frame constants, one upload for every shader variant ---
+    FrameUniforms frame_uniforms;
+    glm_mat4_copy(app->projection_matrix, frame_uniforms.projection);
+    glm_mat4_copy(app->view_matrix, frame_uniforms.view);
+    glm_vec4(app->camera.position, 1.0f, frame_uniforms.view_position);
+    glm_vec4(app->light_direction_world, 0.0f, frame_uniforms.light_direction);
+    glm_vec4(app->light_color, 1.0f, frame_uniforms.light_color);
+    glm_vec4(app->ambient_light_color, 1.0f, frame_uniforms.ambient_light_color);
+    compute_shadow_light_matrix(app->light_direction_world, frame_uniforms.light_space);
+    glm_vec4((vec3){snapshot->time, 0.0f, 0.0f}, 0.0f, frame_uniforms.time);
+    upload_frame_uniforms(app->frame_uniform_buffer, &frame_uniforms);
+    check_gl_error("render_app - frame uniforms");
+
+    update_board_overlay(&app->scene.board_overlay, snapshot->units, snapshot->unit_count, app->selected_bench_unit_index,
+                         app->input_state.is_mouse_over_board, app->input_state.hovered_grid_x, app->input_state.hovered_grid_y);
+    render_scene(&(app->scene), snapshot, &app->shader_manager, app->main_shader, app->shadow_shader,
+                 app, app->selected_bench_unit_index);
+    check_gl_error("render_app - after render_scene");
+    if (app->board_overlay_shader >= 0) {
+        render_board_overlay(&app->scene.board_overlay, &app->shader_manager, app->board_overlay_shader);
+    }
+    if (app->particle_shader >= 0) {
+        render_particle_system(&app->scene.particles, &app->shader_manager, app->particle_shader,
+                               snapshot->particles, snapshot->particle_count);
+    }
+    if (app->health_bar_shader >= 0) {
+        render_health_bars(&app->scene.health_bars, &app->shader_manager, app->health_bar_shader,
+                           snapshot->units, snapshot->unit_count);
+    }
+    if (app->combat_text_shader >= 0) {
+        render_combat_text(&app->scene.combat_text, &app->shader_manager, app->combat_text_shader,
+                           snapshot->combat_texts, snapshot->combat_text_count);
+    }
+}
 
-        // printf("DEBUG: render_app - Setting ambientLightColor. Location: %d\n", app->shader_uloc_ambientLightColor);
-        if (app->shader_uloc_ambientLightColor != -1) {
-            glUniform3fv(app->shader_uloc_ambientLightColor, 1, app->ambient_light_color);
-            check_gl_error("render_app - glUniform3fv for ambientLightColor");
+/**
+ * Reads the mouse once more right before the frame is drawn, so camera rotation is not a whole
+ * update behind. Skipped while replaying or recording: the camera must follow the recorded deltas only.
+ */
+static void sample_late_camera_input(App* app)
+{
+    if (app->frame_pacer.late_input && app->input_recorder.mode == INPUT_RECORD_OFF &&
+        SDL_GetRelativeMouseMode() && !app->input_state.right_mouse_pressed) { // The first delta after capture is ignored
+        int mouse_dx, mouse_dy;
+        SDL_PumpEvents();
+        SDL_GetRelativeMouseState(&mouse_dx, &mouse_dy); // Consumed here, the next poll only gets newer motion
+        if (mouse_dx != 0 || mouse_dy != 0) {
+            rotate_camera(&app->camera, (double)mouse_dx, (double)mouse_dy);
+            int width, height;
+            SDL_GL_GetDrawableSize(app->window, &width, &height);
+            update_app_matrices(app, width, height);
         }
+    }
+    mark_input_sampled(&app->frame_pacer);
+}
 
-        // printf("DEBUG: render_app - Setting viewPos_world. Location: %d\n", app->shader_uloc_viewPos);
-        if (app->shader_uloc_viewPos != -1) {
-            glUniform3fv(app->shader_uloc_viewPos, 1, app->camera.position);
-            check_gl_error("render_app - glUniform3fv for viewPos_world");
-        }
+void render_app(App* app)
+{
+    Uint64 render_start_counter = SDL_GetPerformanceCounter();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    check_gl_error("glClear - render_app start");
 
-        // Default color tint
-        if (app->shader_uloc_color_tint != -1) {
-            glUniform4f(app->shader_uloc_color_tint, 1.0f, 1.0f, 1.0f, 1.0f);
-        }
-        check_gl_error("render_app - Set default color tint");
+    ImGui_NewFrameWrapper();
 
-        render_scene(&(app->scene), app->shader_program, app, app->selected_bench_unit_index);
-        check_gl_error("render_app - after render_scene");
+    sample_late_camera_input(app);
 
-    } else {
-        printf("[ERROR] render_app: Invalid shader program ID! Cannot render 3D scene.\n");
-    }
-    
-    render_scene(&(app->scene), app->shader_program, app, app->selected_bench_unit_index);
-    check_gl_error("after render_scene");
+    // --- 3D pass at the dynamic resolution, UI on top at native resolution ---
+    int width, height;
+    SDL_GL_GetDrawableSize(app->window, &width, &height);
+    begin_scene_resolution(&app->dynamic_resolution, width, height);
+    render_app_scene(app);
+    end_scene_resolution(&app->dynamic_resolution, width, height, get_frame_budget_ms(&app->frame_pacer));
 
     // --- Draw ImGui Game UI ---
     ImGui_DrawPlayerStatsWindowWrapper(
@@ -638,7 +881,11 @@ void render_app(App* app)
 
     if (app->game_state.current_phase == PHASE_PREPARE) {
         shop_actions = ImGui_DrawShopWindowWrapper(&app->game_state);
-        ImGui_DrawBenchWindowWrapper(&app->scene, &app->selected_bench_unit_index, app->game_state.current_phase);
+        const RenderSnapshot* snapshot = acquire_render_snapshot(&app->snapshots);
+        if (snapshot) {
+            ImGui_DrawBenchWindowWrapper(snapshot->units, snapshot->unit_count, &app->selected_bench_unit_index,
+                                         app->game_state.current_phase);
+        }
     } else if (app->game_state.current_phase == PHASE_COMBAT) {
         ImGui_DrawCombatInfoWindowWrapper(&app->game_state);
     } else if (app->game_state.current_phase == PHASE_POST_COMBAT) {
@@ -656,86 +903,17 @@ void render_app(App* app)
     if (app->show_help_window) {
         ImGui_DrawHelpWindowWrapper(&app->show_help_window);
     }
-    
-    // --- Handle UI Actions (Primarily Shop and Start Combat) ---
-    // These actions should only be processed if they could have been triggered (e.g., in Prepare Phase)
-    if (app->game_state.current_phase == PHASE_PREPARE && shop_actions != ACTION_FLAG_NONE) {
-        printf("DEBUG: Shop action flags received: %d\n", shop_actions);
-
-        // Handle Start Combat action
-        if (shop_actions & ACTION_FLAG_START_COMBAT) {
-            printf("Action: Start Combat triggered!\n");
-
-            // --- Spawn AI Wave ---
-            printf("DEBUG: Spawning AI wave %d...\n", app->game_state.current_wave);
-            // For now, spawn simple fixed AI wave.
-            // Ensure player units are not overwritten if MAX_UNITS is tight.
-            // This assumes add_unit_to_bench finds slots in the combined units array.
-            // Better: add_unit_to_board_directly function or use a different list for active combatants.
-
-            // Example: Spawn 2 AI units (make sure MAX_UNITS allows this)
-            // These will be added to scene.units and their location set to LOC_BOARD
-            // We need a robust way to add them to the board, let's modify init_unit to handle this.
-            // And ensure existing AI from previous rounds are cleared.
-            // Clearing AI is now done in PHASE_POST_COMBAT logic.
-
-            if (app->scene.unit_count < MAX_UNITS) {
-                init_unit(&app->scene.units[app->scene.unit_count++], UNIT_MELEE_TANK, 3, BOARD_GRID_HEIGHT - 2, false, LOC_BOARD);
-            }
-            if (app->scene.unit_count < MAX_UNITS) {
-                init_unit(&app->scene.units[app->scene.unit_count++], UNIT_RANGED_ARCHER, 4, BOARD_GRID_HEIGHT - 2, false, LOC_BOARD);
-            }
-            printf("DEBUG: AI units spawned. Total units: %d\n", app->scene.unit_count);
-
-            app->game_state.current_phase = PHASE_COMBAT;
-            app->game_state.combat_phase_timer = 0.0f;
-            app->selected_bench_unit_index = -1;
-        }
 
-        // --- Handle Buy actions using new flags ---
-        if (shop_actions & ACTION_FLAG_BUY_UNIT_TYPE_0) { // Buy Tank
-            int cost = get_unit_cost(UNIT_MELEE_TANK); // Get cost
-            printf("Action: Attempting to buy Tank (Cost: %d, Current Gold: %d)...\n", cost, app->game_state.player_gold);
-            if (app->game_state.player_gold >= cost) { // Check gold
-                if (add_unit_to_bench(&app->scene, UNIT_MELEE_TANK)) {
-                    app->game_state.player_gold -= cost; // Deduct gold
-                    printf("Purchase successful! Gold remaining: %d\n", app->game_state.player_gold);
-                } else {
-                    printf("Action Failed: Bench is full or max units reached for Tank!\n");
-                    // No gold deducted if add_unit_to_bench fails
-                }
-            } else {
-                printf("Action Failed: Not enough gold for Tank!\n");
-            }
-        }
-        if (shop_actions & ACTION_FLAG_BUY_UNIT_TYPE_1) { // Buy Archer
-            int cost = get_unit_cost(UNIT_RANGED_ARCHER); // Get cost
-            printf("Action: Attempting to buy Archer (Cost: %d, Current Gold: %d)...\n", cost, app->game_state.player_gold);
-            if (app->game_state.player_gold >= cost) { // Check gold
-                if (add_unit_to_bench(&app->scene, UNIT_RANGED_ARCHER)) {
-                    app->game_state.player_gold -= cost; // Deduct gold
-                    printf("Purchase successful! Gold remaining: %d\n", app->game_state.player_gold);
-                } else {
-                    printf("Action Failed: Bench is full or max units reached for Archer!\n");
-                }
-            } else {
-                printf("Action Failed: Not enough gold for Archer!\n");
-            }
-        }
-        // Add more unit type buy handlers if shop expands
+    if (app->show_render_stats_window) {
+        ImGui_DrawRenderStatsWindowWrapper(get_render_stats(), &app->show_render_stats_window);
+    }
+    
+    shop_actions = apply_input_frame_ui(&app->input_recorder, shop_actions, &app->selected_bench_unit_index);
 
-        // Handle Refresh action
-        if (shop_actions & ACTION_FLAG_REFRESH_SHOP) {
-            int cost = 1; // Example refresh cost
-            printf("Action: Attempting Refresh Shop (Cost: %d, Current Gold: %d)...\n", cost, app->game_state.player_gold);
-            if (app->game_state.player_gold >= cost) { // Check gold
-                app->game_state.player_gold -= cost; // Deduct gold
-                printf("Refresh successful! Gold remaining: %d\n", app->game_state.player_gold);
-                // TODO: Implement logic to change shop offerings
-            } else {
-                printf("Action Failed: Not enough gold to refresh shop!\n");
-            }
-        }
+    if (app->pipelined) {
+        app->pending_ui_actions |= shop_actions; // The step in flight owns the units, applied in the next update
+    } else {
+        apply_ui_actions(app, shop_actions);
     }
 
 
@@ -746,6 +924,37 @@ void render_app(App* app)
     check_gl_error("ImGui_RenderDrawDataWrapper");
 
     SDL_GL_SwapWindow(app->window);
+    if (app->redraw_frames > 0) app->redraw_frames--;
+    end_input_frame(&app->input_recorder);
+    Uint64 swap_end_counter = SDL_GetPerformanceCounter();
+    pace_frame(&app->frame_pacer, app->frame_start_counter);
+
+    // Only drawn frames are closed: counters of skipped updates land in the next drawn one
+    Uint64 frame_end_counter = SDL_GetPerformanceCounter();
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    set_metric(render_time_metric, (double)(swap_end_counter - render_start_counter) * 1000.0 / frequency);
+    end_arena_frame();
+    end_metrics_frame((double)(frame_end_counter - app->frame_start_counter) * 1000.0 / frequency);
+}
+
+void destroy_app_resources(App* app)
+{
+    finish_app_simulation(app);
+    shutdown_job_system(); // Jobs may still use the resources below
+    close_metrics_stream();
+    destroy_render_snapshots(&app->snapshots);
+
+    // Delete shader programs
+    destroy_shader_manager(&app->shader_manager);
+    if (app->frame_uniform_buffer != 0) {
+        glDeleteBuffers(1, &app->frame_uniform_buffer);
+        app->frame_uniform_buffer = 0;
+    }
+
+    // Destroy scene resources
+    destroy_scene(&app->scene);
+    unmount_asset_pack();
+    destroy_arenas();
 }
 
 void destroy_app(App* app)
@@ -757,13 +966,10 @@ void destroy_app(App* app)
     ImGui_ShutdownWrapper();
     printf("DEBUG: destroy_app - ImGui shutdown complete.\n");
 
-    // Delete shader program
-    if (app->shader_program != 0) {
-        glDeleteProgram(app->shader_program);
-    }
+    stop_input_recorder(&app->input_recorder);
 
-    // Destroy scene resources
-    destroy_scene(&app->scene);
+    destroy_dynamic_resolution(&app->dynamic_resolution);
+    destroy_app_resources(app);
 
     // SDL cleanup
     printf("DEBUG: destroy_app - Calling SDL cleanup...\n");
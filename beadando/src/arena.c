@@ -0,0 +1,158 @@
+#include "arena.h"
+#include "metrics.h"
+
+#include <SDL2/SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static Arena frame_arena;
+static Arena round_arena;
+static Arena scratch_arena;
+static int frame_arena_metric = -1;
+
+#ifdef ALLOC_CHECK
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc: the game's objects call these,
+// shared libraries (SDL, the GL driver) keep calling the C library directly
+static SDL_atomic_t heap_allocations;
+static long long counted_heap_allocations = 0;
+static int heap_allocations_metric = -1;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+    SDL_AtomicAdd(&heap_allocations, 1);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    SDL_AtomicAdd(&heap_allocations, 1);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size)
+{
+    SDL_AtomicAdd(&heap_allocations, 1);
+    return __real_realloc(pointer, size);
+}
+#endif
+
+bool init_arena(Arena* arena, const char* name, size_t capacity)
+{
+    if (!arena) return false;
+    memset(arena, 0, sizeof(Arena));
+    arena->name = name;
+    arena->base = (unsigned char*)malloc(capacity);
+    if (!arena->base) {
+        fprintf(stderr, "[ERROR] Cannot reserve the %s arena (%lu bytes)\n", name, (unsigned long)capacity);
+        return false;
+    }
+    arena->capacity = capacity;
+    return true;
+}
+
+void destroy_arena(Arena* arena)
+{
+    if (!arena) return;
+    free(arena->base);
+    memset(arena, 0, sizeof(Arena));
+}
+
+void* arena_alloc(Arena* arena, size_t size)
+{
+    if (!arena || !arena->base) return NULL;
+    size_t offset = (arena->used + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (offset > arena->capacity || size > arena->capacity - offset) {
+        fprintf(stderr, "[WARN] The %s arena is full (%lu of %lu bytes used, %lu requested)\n", arena->name,
+                (unsigned long)arena->used, (unsigned long)arena->capacity, (unsigned long)size);
+        return NULL;
+    }
+    arena->used = offset + size;
+#ifndef NDEBUG
+    if (arena->used > arena->peak) arena->peak = arena->used;
+#endif
+    return arena->base + offset;
+}
+
+void reset_arena(Arena* arena)
+{
+    if (arena) arena->used = 0;
+}
+
+void init_arenas(void)
+{
+    init_arena(&frame_arena, "frame", FRAME_ARENA_SIZE);
+    init_arena(&round_arena, "round", ROUND_ARENA_SIZE);
+    init_arena(&scratch_arena, "scratch", SCRATCH_ARENA_SIZE);
+    frame_arena_metric = register_metric("frame_arena_kb", METRIC_GAUGE);
+#ifdef ALLOC_CHECK
+    heap_allocations_metric = register_metric("heap_allocs", METRIC_COUNTER);
+    counted_heap_allocations = SDL_AtomicGet(&heap_allocations);
+#endif
+}
+
+void destroy_arenas(void)
+{
+#ifndef NDEBUG
+    const Arena* arenas[] = {&frame_arena, &round_arena, &scratch_arena};
+    for (int i = 0; i < 3; ++i) {
+        if (!arenas[i]->base) continue;
+        printf("[INFO] Peak usage of the %s arena: %lu of %lu KB\n", arenas[i]->name,
+               (unsigned long)(arenas[i]->peak / 1024), (unsigned long)(arenas[i]->capacity / 1024));
+    }
+#endif
+    destroy_arena(&frame_arena);
+    destroy_arena(&round_arena);
+    destroy_arena(&scratch_arena);
+}
+
+Arena* get_frame_arena(void)
+{
+    return &frame_arena;
+}
+
+Arena* get_round_arena(void)
+{
+    return &round_arena;
+}
+
+ArenaMark begin_scratch(void)
+{
+    ArenaMark mark = {scratch_arena.used};
+    return mark;
+}
+
+void* scratch_alloc(size_t size)
+{
+    return arena_alloc(&scratch_arena, size);
+}
+
+void end_scratch(ArenaMark mark)
+{
+    scratch_arena.used = mark.used;
+}
+
+void end_arena_frame(void)
+{
+    set_metric(frame_arena_metric, (double)frame_arena.used / 1024.0);
+    reset_arena(&frame_arena);
+#ifdef ALLOC_CHECK
+    long long count = SDL_AtomicGet(&heap_allocations);
+    add_metric(heap_allocations_metric, (double)(count - counted_heap_allocations));
+    counted_heap_allocations = count;
+#endif
+}
+
+long long get_heap_allocation_count(void)
+{
+#ifdef ALLOC_CHECK
+    return SDL_AtomicGet(&heap_allocations);
+#else
+    return -1;
+#endif
+}
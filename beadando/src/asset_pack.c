@@ -0,0 +1,124 @@
+#include "asset_pack.h"
+#include "metrics.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static FileMapping pack_mapping;
+static const AssetPackEntry* pack_entries = NULL;
+static uint32_t pack_entry_count = 0;
+static int asset_opens_metric = -1;
+static int asset_bytes_metric = -1;
+
+uint64_t hash_asset_path(const char* path)
+{
+    return hash_fnv1a64(FNV1A64_OFFSET_BASIS, path, strlen(path));
+}
+
+bool mount_asset_pack(const char* path)
+{
+    asset_opens_metric = register_metric("asset_opens", METRIC_COUNTER);
+    asset_bytes_metric = register_metric("asset_bytes", METRIC_COUNTER);
+    unmount_asset_pack();
+    if (!map_file(&pack_mapping, path)) {
+        printf("[INFO] No asset pack at '%s', using loose files.\n", path);
+        return false;
+    }
+
+    const unsigned char* base = (const unsigned char*)pack_mapping.data;
+    const AssetPackHeader* header = (const AssetPackHeader*)base;
+    if (pack_mapping.size < sizeof(AssetPackHeader) ||
+        header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION ||
+        header->entries_offset + (uint64_t)header->entry_count * sizeof(AssetPackEntry) > pack_mapping.size) {
+        fprintf(stderr, "[ERROR] Asset pack '%s' is invalid (rebuild it), using loose files.\n", path);
+        unmap_file(&pack_mapping);
+        return false;
+    }
+
+    // Validate every entry once so lookups can trust the table
+    const AssetPackEntry* entries = (const AssetPackEntry*)(base + header->entries_offset);
+    for (uint32_t i = 0; i < header->entry_count; ++i) {
+        if (entries[i].offset + entries[i].size > pack_mapping.size ||
+            entries[i].path_offset + entries[i].path_length > pack_mapping.size ||
+            (i > 0 && entries[i - 1].path_hash > entries[i].path_hash)) {
+            fprintf(stderr, "[ERROR] Asset pack '%s' has a corrupt entry %u, using loose files.\n", path, i);
+            unmap_file(&pack_mapping);
+            return false;
+        }
+    }
+
+    pack_entries = entries;
+    pack_entry_count = header->entry_count;
+    printf("[INFO] Mounted asset pack '%s' (%u assets, %lu bytes)\n", path, pack_entry_count, (unsigned long)pack_mapping.size);
+    return true;
+}
+
+void unmount_asset_pack(void)
+{
+    unmap_file(&pack_mapping);
+    pack_entries = NULL;
+    pack_entry_count = 0;
+}
+
+bool is_asset_pack_mounted(void)
+{
+    return pack_entries != NULL;
+}
+
+static const AssetPackEntry* find_pack_entry(const char* path)
+{
+    if (!pack_entries) return NULL;
+
+    uint64_t hash = hash_asset_path(path);
+    uint32_t low = 0;
+    uint32_t high = pack_entry_count;
+    while (low < high) { // Lower bound of the hash
+        uint32_t middle = low + (high - low) / 2;
+        if (pack_entries[middle].path_hash < hash) low = middle + 1;
+        else high = middle;
+    }
+
+    // Compare the stored path to rule out hash collisions
+    size_t length = strlen(path);
+    const unsigned char* base = (const unsigned char*)pack_mapping.data;
+    for (uint32_t i = low; i < pack_entry_count && pack_entries[i].path_hash == hash; ++i) {
+        if (pack_entries[i].path_length == length &&
+            memcmp(base + pack_entries[i].path_offset, path, length) == 0) {
+            return &pack_entries[i];
+        }
+    }
+    return NULL;
+}
+
+bool open_asset(const char* path, AssetData* asset)
+{
+    if (!path || !asset) return false;
+    memset(asset, 0, sizeof(AssetData));
+
+    const AssetPackEntry* entry = find_pack_entry(path);
+    if (entry) {
+        asset->data = (const unsigned char*)pack_mapping.data + entry->offset;
+        asset->size = (size_t)entry->size;
+        add_metric(asset_opens_metric, 1.0);
+        add_metric(asset_bytes_metric, (double)asset->size);
+        return true;
+    }
+
+    // Development: loose file next to the executable
+    if (!map_file(&asset->mapping, path)) {
+        return false;
+    }
+    asset->data = asset->mapping.data;
+    asset->size = asset->mapping.size;
+    add_metric(asset_opens_metric, 1.0);
+    add_metric(asset_bytes_metric, (double)asset->size);
+    return true;
+}
+
+void close_asset(AssetData* asset)
+{
+    if (!asset) return;
+    unmap_file(&asset->mapping);
+    memset(asset, 0, sizeof(AssetData));
+}
@@ -0,0 +1,28 @@
+#include "asset_paths.h"
+
+#include <stdio.h>
+#include <string.h>
+
+bool get_cooked_asset_path(const char* source_path, const char* cooked_extension, char* out_path, size_t out_size)
+{
+    if (!source_path || !cooked_extension || !out_path || out_size == 0) return false;
+
+    // Strip the assets/ prefix so the cooked tree mirrors the source tree
+    const char* relative_path = source_path;
+    size_t asset_dir_length = strlen(ASSET_DIR);
+    if (strncmp(source_path, ASSET_DIR, asset_dir_length) == 0) {
+        relative_path = source_path + asset_dir_length;
+    }
+
+    // Drop the source extension (only if the last dot belongs to the file name)
+    size_t stem_length = strlen(relative_path);
+    const char* last_dot = strrchr(relative_path, '.');
+    const char* last_slash = strrchr(relative_path, '/');
+    if (last_dot && (!last_slash || last_dot > last_slash)) {
+        stem_length = (size_t)(last_dot - relative_path);
+    }
+
+    int written = snprintf(out_path, out_size, "%s%.*s%s",
+                           COOKED_ASSET_DIR, (int)stem_length, relative_path, cooked_extension);
+    return written > 0 && (size_t)written < out_size;
+}
@@ -0,0 +1,148 @@
+#include "board_overlay.h"
+#include "unit.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Everything the cells depend on: the selection, the hovered tile and the tile, side, type and
+ * attack range of every board unit.
+ */
+static uint64_t hash_overlay_inputs(const Unit* units, int unit_count, int selected_bench_unit_index, bool hovering, int hover_x, int hover_y)
+{
+    uint64_t hash = FNV1A64_OFFSET_BASIS;
+    int hover[3] = {hovering, hovering ? hover_x : 0, hovering ? hover_y : 0};
+    hash = hash_fnv1a64(hash, &selected_bench_unit_index, sizeof(int));
+    hash = hash_fnv1a64(hash, hover, sizeof(hover));
+    for (int i = 0; i < unit_count; ++i) {
+        const Unit* unit = &units[i];
+        if (unit->location != LOC_BOARD || !unit->is_alive) continue;
+        int key[4] = {unit->grid_x, unit->grid_y, unit->is_player_unit, (int)unit->type};
+        hash = hash_fnv1a64(hash, key, sizeof(key));
+        hash = hash_fnv1a64(hash, &unit->attack_range, sizeof(float)); // Extent of the enemy range cells
+    }
+    return hash;
+}
+
+static void build_cells(BoardOverlay* overlay, const Unit* units, int unit_count, int selected_bench_unit_index,
+                        bool hovering, int hover_x, int hover_y)
+{
+    memset(overlay->cells, 0, sizeof(overlay->cells));
+
+    // Same rule as placing the unit on click (is_tile_empty_for_player, see does_unit_block_placement)
+    bool placing = selected_bench_unit_index >= 0 && selected_bench_unit_index < unit_count &&
+                   units[selected_bench_unit_index].location == LOC_BENCH;
+    if (placing) {
+        for (int y = 0; y < BOARD_GRID_HEIGHT; ++y) {
+            if (!is_tile_on_player_side(y)) continue;
+            for (int x = 0; x < BOARD_GRID_WIDTH; ++x) overlay->cells[y][x] |= BOARD_CELL_PLACEABLE;
+        }
+    }
+
+    for (int i = 0; i < unit_count; ++i) {
+        const Unit* unit = &units[i];
+        if (unit->location != LOC_BOARD || !unit->is_alive) continue;
+        if (does_unit_block_placement(unit) && unit->grid_x >= 0 && unit->grid_x < BOARD_GRID_WIDTH &&
+            unit->grid_y >= 0 && unit->grid_y < BOARD_GRID_HEIGHT) {
+            overlay->cells[unit->grid_y][unit->grid_x] &= (uint8_t)~BOARD_CELL_PLACEABLE;
+        }
+        if (unit->is_player_unit) continue;
+
+        // Tile centres within the enemy's attack range
+        vec3 unit_pos;
+        grid_to_world_pos(unit->grid_x, unit->grid_y, unit_pos);
+        float range_sq = unit->attack_range * unit->attack_range;
+        for (int y = 0; y < BOARD_GRID_HEIGHT; ++y) {
+            for (int x = 0; x < BOARD_GRID_WIDTH; ++x) {
+                if (x == unit->grid_x && y == unit->grid_y) continue;
+                vec3 tile_pos;
+                grid_to_world_pos(x, y, tile_pos);
+                if (glm_vec3_distance2(unit_pos, tile_pos) <= range_sq) overlay->cells[y][x] |= BOARD_CELL_ENEMY_RANGE;
+            }
+        }
+    }
+
+    if (hovering && hover_x >= 0 && hover_x < BOARD_GRID_WIDTH && hover_y >= 0 && hover_y < BOARD_GRID_HEIGHT) {
+        overlay->cells[hover_y][hover_x] |= BOARD_CELL_HOVERED;
+    }
+}
+
+bool init_board_overlay(BoardOverlay* overlay)
+{
+    if (!overlay) return false;
+    memset(overlay, 0, sizeof(BoardOverlay));
+
+    glGenTextures(1, &overlay->state_texture);
+    glBindTexture(GL_TEXTURE_2D, overlay->state_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, BOARD_GRID_WIDTH, BOARD_GRID_HEIGHT, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // Integer textures cannot be filtered
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &overlay->vao_id);
+    check_gl_error("init_board_overlay");
+    return overlay->state_texture != 0 && overlay->vao_id != 0;
+}
+
+void destroy_board_overlay(BoardOverlay* overlay)
+{
+    if (!overlay) return;
+    if (overlay->state_texture != 0) glDeleteTextures(1, &overlay->state_texture);
+    if (overlay->vao_id != 0) glDeleteVertexArrays(1, &overlay->vao_id);
+    memset(overlay, 0, sizeof(BoardOverlay));
+}
+
+bool update_board_overlay(BoardOverlay* overlay, const Unit* units, int unit_count, int selected_bench_unit_index,
+                          bool hovering, int hover_x, int hover_y)
+{
+    if (!overlay || !units) return false;
+
+    uint64_t state_hash = hash_overlay_inputs(units, unit_count, selected_bench_unit_index, hovering, hover_x, hover_y);
+    if (overlay->valid && state_hash == overlay->state_hash) return false;
+
+    build_cells(overlay, units, unit_count, selected_bench_unit_index, hovering, hover_x, hover_y);
+    overlay->state_hash = state_hash;
+    overlay->valid = true;
+
+    if (overlay->state_texture == 0) return false;
+    glBindTexture(GL_TEXTURE_2D, overlay->state_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, BOARD_GRID_WIDTH, BOARD_GRID_HEIGHT, GL_RED_INTEGER, GL_UNSIGNED_BYTE, overlay->cells);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    check_gl_error("update_board_overlay");
+    return true;
+}
+
+uint8_t get_board_overlay_cell(const BoardOverlay* overlay, int grid_x, int grid_y)
+{
+    if (!overlay || grid_x < 0 || grid_x >= BOARD_GRID_WIDTH || grid_y < 0 || grid_y >= BOARD_GRID_HEIGHT) return 0;
+    return overlay->cells[grid_y][grid_x];
+}
+
+void render_board_overlay(BoardOverlay* overlay, ShaderManager* shaders, int overlay_shader)
+{
+    if (!overlay || overlay->state_texture == 0 || overlay->vao_id == 0) return;
+
+    const ShaderVariant* variant = use_shader_variant(shaders, overlay_shader, 0);
+    if (!variant) return;
+
+    glActiveTexture(GL_TEXTURE0 + BOARD_OVERLAY_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, overlay->state_texture);
+    count_texture_bind();
+    glActiveTexture(GL_TEXTURE0);
+    set_shader_int(variant, UNIFORM_BOARD_STATE, BOARD_OVERLAY_TEXTURE_UNIT);
+
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(overlay->vao_id);
+    count_vao_bind();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    count_draw_call(1, 2);
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    check_gl_error("render_board_overlay");
+}
@@ -143,6 +143,15 @@ void rotate_camera(Camera* camera, double horizontal, double vertical) {
     calculate_camera_position(camera);
 }
 
+void set_camera_orbit(Camera* camera, float yaw_degrees, float pitch_degrees, float zoom) {
+    if (!camera) return;
+    camera->rotation[1] = fmodf(yaw_degrees, 360.0f);
+    if (camera->rotation[1] < 0.0f) camera->rotation[1] += 360.0f;
+    camera->rotation[0] = glm_clamp(pitch_degrees, CAMERA_PITCH_MIN, CAMERA_PITCH_MAX);
+    camera->zoom_level = glm_clamp(zoom, camera->min_zoom, camera->max_zoom);
+    calculate_camera_position(camera);
+}
+
 void zoom_camera(Camera* camera, float amount) {
     if (!camera) return;
     camera->zoom_level -= amount * CAMERA_ZOOM_SENSITIVITY; // Subtract amount to zoom in
@@ -0,0 +1,172 @@
+#include "combat_text.h"
+#include "arena.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Look of a popup style.
+ */
+typedef struct CombatTextStyleInfo
+{
+    float height; // Ink height in world units
+    float lifetime;
+    vec4 color;
+} CombatTextStyleInfo;
+
+static const CombatTextStyleInfo combat_text_styles[NUM_COMBAT_TEXT_STYLES] = {
+    [COMBAT_TEXT_DAMAGE] = {0.22f, 0.9f, {1.0f, 0.95f, 0.6f, 1.0f}},
+    [COMBAT_TEXT_KILL] = {0.36f, 1.3f, {1.0f, 0.25f, 0.15f, 1.0f}}
+};
+
+bool init_combat_text(CombatTextSystem* system)
+{
+    if (!system) return false;
+    memset(system, 0, sizeof(CombatTextSystem));
+
+    if (!init_sdf_font(&system->font)) {
+        fprintf(stderr, "ERROR: init_combat_text - Failed to create the font atlas\n");
+        return false;
+    }
+    glGenVertexArrays(1, &system->vao_id);
+    glGenBuffers(1, &system->vbo_id);
+    glBindVertexArray(system->vao_id);
+    glBindBuffer(GL_ARRAY_BUFFER, system->vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)MAX_COMBAT_TEXT_GLYPHS * 6 * sizeof(CombatTextVertex), NULL, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(CombatTextVertex), (void*)offsetof(CombatTextVertex, anchor_progress));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(CombatTextVertex), (void*)offsetof(CombatTextVertex, offset_uv));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(CombatTextVertex), (void*)offsetof(CombatTextVertex, color));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("init_combat_text");
+    return true;
+}
+
+void destroy_combat_text(CombatTextSystem* system)
+{
+    if (!system) return;
+    destroy_sdf_font(&system->font);
+    if (system->vbo_id != 0) glDeleteBuffers(1, &system->vbo_id);
+    if (system->vao_id != 0) glDeleteVertexArrays(1, &system->vao_id);
+    system->vbo_id = 0;
+    system->vao_id = 0;
+    system->count = 0;
+}
+
+void spawn_combat_text(CombatTextSystem* system, const vec3 position, int value, CombatTextStyle style)
+{
+    if (!system || style < 0 || style >= NUM_COMBAT_TEXT_STYLES) return;
+
+    CombatText* text;
+    if (system->count < MAX_COMBAT_TEXTS) {
+        text = &system->texts[system->count++];
+    } else {
+        // Replace the oldest
+        text = &system->texts[0];
+        for (int i = 1; i < system->count; ++i) {
+            if (system->texts[i].age > text->age) text = &system->texts[i];
+        }
+    }
+    glm_vec3_copy((float*)position, text->position);
+    text->age = 0.0f;
+    text->style = style;
+    snprintf(text->text, sizeof(text->text), style == COMBAT_TEXT_KILL ? "%d!" : "%d", value);
+}
+
+void update_combat_text(CombatTextSystem* system, float dt)
+{
+    if (!system) return;
+    for (int i = 0; i < system->count;) {
+        CombatText* text = &system->texts[i];
+        text->age += dt;
+        if (text->age < combat_text_styles[text->style].lifetime) {
+            ++i;
+            continue;
+        }
+        *text = system->texts[--system->count]; // Swap-remove
+    }
+}
+
+/**
+ * Appends the two triangles of a glyph. x0..x1, y0..y1 is the cell in billboard space.
+ */
+static CombatTextVertex* write_glyph(CombatTextVertex* out, const vec4 anchor, const vec4 color,
+                                     float x0, float y0, float x1, float y1, const vec4 uv)
+{
+    const float corners[6][4] = {
+        {x0, y0, uv[0], uv[1]}, {x1, y0, uv[2], uv[1]}, {x1, y1, uv[2], uv[3]},
+        {x0, y0, uv[0], uv[1]}, {x1, y1, uv[2], uv[3]}, {x0, y1, uv[0], uv[3]}
+    };
+    for (int i = 0; i < 6; ++i) {
+        glm_vec4_copy((float*)anchor, out->anchor_progress);
+        glm_vec4_copy((float*)corners[i], out->offset_uv);
+        glm_vec4_copy((float*)color, out->color);
+        ++out;
+    }
+    return out;
+}
+
+void render_combat_text(CombatTextSystem* system, ShaderManager* shaders, int text_shader,
+                        const CombatText* texts, int text_count)
+{
+    if (!system || system->vao_id == 0 || text_count <= 0) return;
+
+    // Lay out every popup into this frame's staging: centred on its anchor, one cell per character
+    CombatTextVertex* vertices = (CombatTextVertex*)arena_alloc(get_frame_arena(),
+                                                                (size_t)text_count * COMBAT_TEXT_MAX_LENGTH * 6 * sizeof(CombatTextVertex));
+    if (!vertices) return;
+    CombatTextVertex* out = vertices;
+    int glyph_count = 0;
+    for (int i = 0; i < text_count; ++i) {
+        const CombatText* text = &texts[i];
+        const CombatTextStyleInfo* style = &combat_text_styles[text->style];
+        float scale = style->height / SDF_FONT_INK_HEIGHT; // World units per atlas texel
+        float cell = SDF_FONT_CELL_SIZE * scale;
+        float advance = SDF_FONT_ADVANCE * scale;
+        int length = (int)strlen(text->text);
+        float pen = -0.5f * advance * (float)length;
+
+        vec4 anchor;
+        glm_vec4((float*)text->position, text->age / style->lifetime, anchor);
+        for (int c = 0; c < length; ++c, pen += advance) {
+            vec4 uv;
+            if (!get_sdf_glyph(&system->font, text->text[c], uv)) continue;
+            float center = pen + 0.5f * advance;
+            out = write_glyph(out, anchor, style->color, center - 0.5f * cell, -0.5f * cell,
+                              center + 0.5f * cell, 0.5f * cell, uv);
+            ++glyph_count;
+        }
+    }
+    if (glyph_count == 0) return;
+
+    const ShaderVariant* variant = use_shader_variant(shaders, text_shader, 0);
+    if (!variant) return;
+
+    // Orphan the buffer so the upload does not wait for the previous frame's draw
+    glBindBuffer(GL_ARRAY_BUFFER, system->vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)MAX_COMBAT_TEXT_GLYPHS * 6 * sizeof(CombatTextVertex), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)glyph_count * 6 * sizeof(CombatTextVertex), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0 + SDF_FONT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, system->font.texture);
+    count_texture_bind();
+    glActiveTexture(GL_TEXTURE0);
+    set_shader_int(variant, UNIFORM_FONT_ATLAS, SDF_FONT_TEXTURE_UNIT);
+
+    // On top of the units and the HP bars
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(system->vao_id);
+    count_vao_bind();
+    glDrawArrays(GL_TRIANGLES, 0, glyph_count * 6);
+    count_draw_call(glyph_count, 2);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+    check_gl_error("render_combat_text");
+}
@@ -0,0 +1,202 @@
+#include "dynamic_resolution.h"
+#include "metrics.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static int scale_metric = -1;
+static int scene_gpu_metric = -1;
+
+void init_dynamic_resolution(DynamicResolution* resolution)
+{
+    memset(resolution, 0, sizeof(DynamicResolution));
+    resolution->scale = DYNRES_MAX_SCALE;
+    resolution->min_scale = DYNRES_MIN_SCALE;
+    resolution->max_scale = DYNRES_MAX_SCALE;
+    resolution->full_cost_ms = -1.0;
+    glGenQueries(DYNRES_QUERY_COUNT, resolution->queries);
+
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    resolution->cpu_timing = renderer && (strstr(renderer, "llvmpipe") || strstr(renderer, "softpipe") ||
+                                          strstr(renderer, "SwiftShader") || strstr(renderer, "GDI Generic"));
+    if (resolution->cpu_timing) {
+        printf("[INFO] Dynamic resolution: software renderer '%s', timing the 3D pass on the CPU\n", renderer);
+    }
+    scale_metric = register_metric("render_scale", METRIC_GAUGE);
+    scene_gpu_metric = register_metric("scene_gpu_ms", METRIC_GAUGE);
+}
+
+void set_dynamic_resolution_scale(DynamicResolution* resolution, float fixed_scale)
+{
+    if (fixed_scale > 0.0f) {
+        if (fixed_scale < 0.1f) fixed_scale = 0.1f;
+        if (fixed_scale > 1.0f) fixed_scale = 1.0f;
+        resolution->min_scale = resolution->max_scale = fixed_scale;
+    } else {
+        resolution->min_scale = DYNRES_MIN_SCALE;
+        resolution->max_scale = DYNRES_MAX_SCALE;
+    }
+    resolution->scale = resolution->max_scale;
+    printf("[INFO] Render scale: %s (%.0f%%)\n", fixed_scale > 0.0f ? "fixed" : "dynamic", resolution->scale * 100.0f);
+}
+
+static void delete_target(DynamicResolution* resolution)
+{
+    if (resolution->framebuffer) glDeleteFramebuffers(1, &resolution->framebuffer);
+    if (resolution->color_texture) glDeleteTextures(1, &resolution->color_texture);
+    if (resolution->depth_renderbuffer) glDeleteRenderbuffers(1, &resolution->depth_renderbuffer);
+    resolution->framebuffer = resolution->color_texture = resolution->depth_renderbuffer = 0;
+    resolution->target_width = resolution->target_height = 0;
+}
+
+/**
+ * Allocated at full window size: a scale change only moves the viewport, nothing is reallocated.
+ */
+static bool create_target(DynamicResolution* resolution, int width, int height)
+{
+    delete_target(resolution);
+
+    glGenTextures(1, &resolution->color_texture);
+    glBindTexture(GL_TEXTURE_2D, resolution->color_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenRenderbuffers(1, &resolution->depth_renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, resolution->depth_renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &resolution->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, resolution->framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resolution->color_texture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, resolution->depth_renderbuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    check_gl_error("create_target - dynamic resolution");
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "ERROR: Dynamic resolution framebuffer incomplete (0x%x), rendering at full size\n", status);
+        delete_target(resolution);
+        return false;
+    }
+    resolution->target_width = width;
+    resolution->target_height = height;
+    return true;
+}
+
+void begin_scene_resolution(DynamicResolution* resolution, int width, int height)
+{
+    int render_width = (int)(width * resolution->scale + 0.5f);
+    int render_height = (int)(height * resolution->scale + 0.5f);
+    if (render_width < 1) render_width = 1;
+    if (render_height < 1) render_height = 1;
+
+    resolution->offscreen = false;
+    if (render_width < width || render_height < height) {
+        if (resolution->target_width == width && resolution->target_height == height) {
+            resolution->offscreen = true;
+        } else {
+            resolution->offscreen = create_target(resolution, width, height);
+        }
+    }
+    if (!resolution->offscreen) {
+        render_width = width;
+        render_height = height;
+    }
+    resolution->render_width = render_width;
+    resolution->render_height = render_height;
+
+    if (resolution->offscreen) {
+        glBindFramebuffer(GL_FRAMEBUFFER, resolution->framebuffer);
+        glViewport(0, 0, render_width, render_height);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    if (resolution->cpu_timing) {
+        glFinish(); // Earlier work must not be counted
+        resolution->begin_counter = SDL_GetPerformanceCounter();
+    } else {
+        // Only one query is open at a time; a slot whose result never arrived is reused
+        int slot = resolution->query_index;
+        glBeginQuery(GL_TIME_ELAPSED, resolution->queries[slot]);
+        resolution->query_scales[slot] = (float)render_width / (float)width;
+    }
+}
+
+static void add_cost_sample(DynamicResolution* resolution, double ms, double scale)
+{
+    resolution->scene_ms = ms;
+    double full_cost_ms = ms / (scale * scale);
+    resolution->full_cost_ms = resolution->full_cost_ms < 0.0
+                             ? full_cost_ms : resolution->full_cost_ms * 0.8 + full_cost_ms * 0.2;
+}
+
+/**
+ * Reads the finished queries and moves the scale towards the budget.
+ */
+static void update_scale(DynamicResolution* resolution, double budget_ms)
+{
+    for (int i = 1; i <= DYNRES_QUERY_COUNT; ++i) { // Oldest first
+        int slot = (resolution->query_index + i) % DYNRES_QUERY_COUNT;
+        if (resolution->query_scales[slot] <= 0.0f) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(resolution->queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(resolution->queries[slot], GL_QUERY_RESULT, &elapsed_ns);
+        add_cost_sample(resolution, (double)elapsed_ns / 1e6, resolution->query_scales[slot]);
+        resolution->query_scales[slot] = 0.0f;
+    }
+    set_metric(scene_gpu_metric, resolution->scene_ms);
+
+    if (resolution->min_scale >= resolution->max_scale || resolution->full_cost_ms <= 0.0 || budget_ms <= 0.0) return;
+    if (++resolution->frames_since_adjust < DYNRES_ADJUST_FRAMES) return;
+    resolution->frames_since_adjust = 0;
+
+    // Largest scale whose pixel count fits the budget
+    float fit = (float)sqrt(budget_ms * DYNRES_BUDGET_FRACTION / resolution->full_cost_ms);
+    float scale = resolution->scale;
+    if (fit < scale) scale = floorf(fit / DYNRES_STEP) * DYNRES_STEP; // Drop at once
+    else if (fit >= scale + 2.0f * DYNRES_STEP) scale += DYNRES_STEP;  // Climb back slowly, with a step of headroom
+    if (scale < resolution->min_scale) scale = resolution->min_scale;
+    if (scale > resolution->max_scale) scale = resolution->max_scale;
+    resolution->scale = scale;
+}
+
+void end_scene_resolution(DynamicResolution* resolution, int width, int height, double budget_ms)
+{
+    if (resolution->cpu_timing) {
+        glFinish();
+        add_cost_sample(resolution, (double)(SDL_GetPerformanceCounter() - resolution->begin_counter) * 1000.0 /
+                                    SDL_GetPerformanceFrequency(), (double)resolution->render_width / (double)width);
+    } else {
+        glEndQuery(GL_TIME_ELAPSED);
+        resolution->query_index = (resolution->query_index + 1) % DYNRES_QUERY_COUNT;
+    }
+
+    if (resolution->offscreen) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, resolution->framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, resolution->render_width, resolution->render_height,
+                          0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width, height);
+        check_gl_error("end_scene_resolution - upscale");
+    }
+
+    set_metric(scale_metric, (double)resolution->render_width / (double)width); // What this frame was drawn at
+    update_scale(resolution, budget_ms);
+}
+
+void destroy_dynamic_resolution(DynamicResolution* resolution)
+{
+    delete_target(resolution);
+    if (resolution->queries[0]) glDeleteQueries(DYNRES_QUERY_COUNT, resolution->queries);
+    memset(resolution->queries, 0, sizeof(resolution->queries));
+}
@@ -0,0 +1,113 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "file_map.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool map_file(FileMapping* mapping, const char* path)
+{
+    if (!mapping || !path) return false;
+    memset(mapping, 0, sizeof(FileMapping));
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE file_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (file_mapping == NULL) {
+        fprintf(stderr, "ERROR: map_file - CreateFileMapping failed for '%s'\n", path);
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        fprintf(stderr, "ERROR: map_file - MapViewOfFile failed for '%s'\n", path);
+        CloseHandle(file_mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mapping->data = view;
+    mapping->size = (size_t)file_size.QuadPart;
+    mapping->file_handle = file;
+    mapping->mapping_handle = file_mapping;
+    return true;
+}
+
+void unmap_file(FileMapping* mapping)
+{
+    if (!mapping) return;
+
+    if (mapping->data) UnmapViewOfFile(mapping->data);
+    if (mapping->mapping_handle) CloseHandle((HANDLE)mapping->mapping_handle);
+    if (mapping->file_handle) CloseHandle((HANDLE)mapping->file_handle);
+    memset(mapping, 0, sizeof(FileMapping));
+}
+
+#else
+
+bool map_file(FileMapping* mapping, const char* path)
+{
+    if (!mapping || !path) return false;
+    memset(mapping, 0, sizeof(FileMapping));
+    mapping->fd = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        fprintf(stderr, "ERROR: map_file - mmap failed for '%s'\n", path);
+        close(fd);
+        return false;
+    }
+
+    mapping->data = view;
+    mapping->size = (size_t)file_stat.st_size;
+    mapping->fd = fd;
+    return true;
+}
+
+void unmap_file(FileMapping* mapping)
+{
+    if (!mapping) return;
+
+    if (mapping->data) {
+        munmap((void*)mapping->data, mapping->size);
+        close(mapping->fd);
+    }
+    memset(mapping, 0, sizeof(FileMapping));
+    mapping->fd = -1;
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include "frame_pacing.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int latency_metric = -1;
+static int wait_metric = -1;
+
+static const char* get_vsync_name(VsyncMode mode)
+{
+    switch (mode) {
+        case VSYNC_ADAPTIVE: return "adaptive";
+        case VSYNC_OFF: return "off";
+        default: return "on";
+    }
+}
+
+bool parse_vsync_mode(const char* text, VsyncMode* mode)
+{
+    if (strcmp(text, "on") == 0) *mode = VSYNC_ON;
+    else if (strcmp(text, "off") == 0) *mode = VSYNC_OFF;
+    else if (strcmp(text, "adaptive") == 0) *mode = VSYNC_ADAPTIVE;
+    else return false;
+    return true;
+}
+
+static void set_frame_limit(FramePacer* pacer, int fps)
+{
+    pacer->frame_period = fps > 0 ? SDL_GetPerformanceFrequency() / (Uint64)fps : 0;
+    pacer->next_deadline = 0;
+}
+
+/**
+ * Applies the requested vsync, stepping down (adaptive -> on -> off) until the driver accepts one.
+ */
+static void apply_vsync(FramePacer* pacer, VsyncMode mode)
+{
+    if (mode == VSYNC_ADAPTIVE && SDL_GL_SetSwapInterval(VSYNC_ADAPTIVE) != 0) {
+        printf("[WARN] Adaptive vsync not supported (%s), using vsync\n", SDL_GetError());
+        mode = VSYNC_ON;
+    }
+    if (mode == VSYNC_ON && SDL_GL_SetSwapInterval(VSYNC_ON) != 0) {
+        printf("[WARN] Unable to set VSync: %s\n", SDL_GetError());
+        mode = VSYNC_OFF;
+    }
+    if (mode == VSYNC_OFF) SDL_GL_SetSwapInterval(VSYNC_OFF);
+    pacer->vsync = mode;
+
+    // Without vsync the limiter keeps the loop from spinning at thousands of frames
+    int fps = pacer->target_fps;
+    if (fps == 0 && mode == VSYNC_OFF && pacer->requested_vsync != VSYNC_OFF) fps = pacer->refresh_rate;
+    set_frame_limit(pacer, fps);
+    pacer->missed_frames = 0;
+    if (fps > 0) printf("[INFO] Frame pacing: vsync %s, limit %d FPS, display %d Hz\n", get_vsync_name(mode), fps, pacer->refresh_rate);
+    else printf("[INFO] Frame pacing: vsync %s, no limit, display %d Hz\n", get_vsync_name(mode), pacer->refresh_rate);
+}
+
+void init_frame_pacer(FramePacer* pacer, SDL_Window* window, int target_fps, VsyncMode vsync)
+{
+    memset(pacer, 0, sizeof(FramePacer));
+    pacer->target_fps = target_fps > 0 ? target_fps : 0;
+    pacer->requested_vsync = vsync;
+    pacer->late_input = true;
+
+    SDL_DisplayMode mode;
+    int display = window ? SDL_GetWindowDisplayIndex(window) : 0;
+    pacer->refresh_rate = (SDL_GetCurrentDisplayMode(display < 0 ? 0 : display, &mode) == 0 && mode.refresh_rate > 0)
+                        ? mode.refresh_rate : PACING_DEFAULT_REFRESH;
+
+    latency_metric = register_metric("input_latency_ms", METRIC_GAUGE);
+    wait_metric = register_metric("pacing_wait_ms", METRIC_GAUGE);
+    apply_vsync(pacer, vsync);
+}
+
+double get_frame_budget_ms(const FramePacer* pacer)
+{
+    return 1000.0 / (pacer->target_fps > 0 ? pacer->target_fps : pacer->refresh_rate);
+}
+
+void mark_input_sampled(FramePacer* pacer)
+{
+    pacer->input_sample_counter = SDL_GetPerformanceCounter();
+}
+
+/**
+ * Sleeps until shortly before the deadline, then spins: SDL_Delay alone overshoots by up to a scheduler tick.
+ */
+static void wait_until(Uint64 deadline)
+{
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    for (;;) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now >= deadline) return;
+        double remaining_ms = (double)(deadline - now) * 1000.0 / frequency;
+        if (remaining_ms > PACING_SPIN_MARGIN_MS) SDL_Delay((Uint32)(remaining_ms - PACING_SPIN_MARGIN_MS));
+    }
+}
+
+void pace_frame(FramePacer* pacer, Uint64 frame_start_counter)
+{
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (pacer->input_sample_counter != 0) {
+        pacer->latency_ms = (double)(now - pacer->input_sample_counter) * 1000.0 / frequency;
+        set_metric(latency_metric, pacer->latency_ms);
+    }
+
+    // Plain vsync on a machine that cannot hold the refresh drops to half rate (adaptive was already tried)
+    double frame_ms = (double)(now - frame_start_counter) * 1000.0 / frequency;
+    double refresh_ms = 1000.0 / pacer->refresh_rate;
+    if (pacer->vsync == VSYNC_ON && pacer->requested_vsync == VSYNC_ADAPTIVE && frame_ms > refresh_ms * 1.5) {
+        if (++pacer->missed_frames >= PACING_MISSED_FRAME_LIMIT) {
+            printf("[INFO] Frames keep missing the %d Hz refresh, turning vsync off\n", pacer->refresh_rate);
+            apply_vsync(pacer, VSYNC_OFF);
+        }
+    } else {
+        pacer->missed_frames = 0;
+    }
+
+    // Frame limiter
+    pacer->wait_ms = 0.0;
+    if (pacer->frame_period != 0) {
+        if (pacer->next_deadline == 0 || now > pacer->next_deadline + pacer->frame_period) {
+            pacer->next_deadline = now + pacer->frame_period; // Too late to catch up: start a new schedule
+        } else {
+            wait_until(pacer->next_deadline);
+            pacer->next_deadline += pacer->frame_period;
+        }
+        pacer->wait_ms = (double)(SDL_GetPerformanceCounter() - now) * 1000.0 / frequency;
+    }
+    set_metric(wait_metric, pacer->wait_ms);
+}
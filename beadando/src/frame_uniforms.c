@@ -0,0 +1,28 @@
+#include "frame_uniforms.h"
+#include "render_stats.h"
+#include "shader_manager.h"
+#include "utils.h"
+
+#include <stdio.h>
+
+GLuint create_frame_uniform_buffer(void)
+{
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_BLOCK_FRAME, buffer);
+    check_gl_error("create_frame_uniform_buffer");
+    printf("[INFO] Frame uniform buffer created: UBO=%u, Size=%d\n", buffer, (int)sizeof(FrameUniforms));
+    return buffer;
+}
+
+void upload_frame_uniforms(GLuint buffer, const FrameUniforms* uniforms)
+{
+    if (buffer == 0 || !uniforms) return;
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), uniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    count_uniform_upload();
+}
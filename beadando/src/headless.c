@@ -0,0 +1,451 @@
+#include "headless.h"
+#include "app.h"
+#include "arena.h"
+#include "metrics.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool parse_headless_options(int argc, char* argv[], HeadlessOptions* options)
+{
+    memset(options, 0, sizeof(HeadlessOptions));
+    options->frame_count = HEADLESS_DEFAULT_FRAMES;
+    options->width = HEADLESS_DEFAULT_WIDTH;
+    options->height = HEADLESS_DEFAULT_HEIGHT;
+    options->capture_interval = HEADLESS_DEFAULT_CAPTURE_INTERVAL;
+    options->tolerance = HEADLESS_DEFAULT_TOLERANCE;
+    options->max_mismatch = HEADLESS_DEFAULT_MAX_MISMATCH;
+
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--headless") == 0) {
+            headless = true;
+            continue;
+        }
+        if (!value) {
+            if (strncmp(arg, "--", 2) == 0) fprintf(stderr, "[WARN] Missing value for '%s'\n", arg);
+            continue;
+        }
+        if (strcmp(arg, "--frames") == 0) options->frame_count = atoi(value);
+        else if (strcmp(arg, "--size") == 0) sscanf(value, "%dx%d", &options->width, &options->height);
+        else if (strcmp(arg, "--timings") == 0) options->timings_path = value;
+        else if (strcmp(arg, "--metrics") == 0) options->metrics_path = value;
+        else if (strcmp(arg, "--capture") == 0) options->capture_dir = value;
+        else if (strcmp(arg, "--capture-every") == 0) options->capture_interval = atoi(value);
+        else if (strcmp(arg, "--golden") == 0) options->golden_dir = value;
+        else if (strcmp(arg, "--tolerance") == 0) options->tolerance = atoi(value);
+        else if (strcmp(arg, "--max-mismatch") == 0) options->max_mismatch = (float)atof(value);
+        else continue;
+        ++i;
+    }
+
+    if (options->frame_count < 1) options->frame_count = 1;
+    if (options->width < 1) options->width = HEADLESS_DEFAULT_WIDTH;
+    if (options->height < 1) options->height = HEADLESS_DEFAULT_HEIGHT;
+    if (options->capture_interval < 1) options->capture_interval = 1;
+    return headless;
+}
+
+#ifndef HEADLESS_EGL
+
+int run_headless(const HeadlessOptions* options)
+{
+    (void)options;
+    fprintf(stderr, "[ERROR] This build has no headless mode, rebuild with HEADLESS_EGL defined (make HEADLESS=1).\n");
+    return 1;
+}
+
+#else
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <sys/stat.h>
+
+#define HEADLESS_TIME_STEP (1.0f / 60.0f)
+#define HEADLESS_PREPARE_FRACTION 0.1f // Share of the frames shown in the prepare phase before the fight
+
+typedef struct HeadlessContext
+{
+    EGLDisplay display;
+    EGLContext context;
+    EGLSurface surface; // EGL_NO_SURFACE when surfaceless contexts are supported
+    GLuint framebuffer;
+    GLuint color_renderbuffer;
+    GLuint depth_renderbuffer;
+} HeadlessContext;
+
+typedef struct FrameTiming
+{
+    float cpu_ms; // Update and draw submission until the GPU finished
+    float gpu_ms; // GL_TIME_ELAPSED of the draw
+    int draw_calls;
+    int triangles;
+} FrameTiming;
+
+// --- Context ---
+
+static bool create_headless_context(HeadlessContext* headless)
+{
+    memset(headless, 0, sizeof(HeadlessContext));
+    headless->display = EGL_NO_DISPLAY;
+    headless->surface = EGL_NO_SURFACE;
+
+    // Surfaceless platform first: needs neither an X nor a Wayland server
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (get_platform_display) {
+        headless->display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if (headless->display == EGL_NO_DISPLAY) headless->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (headless->display == EGL_NO_DISPLAY || !eglInitialize(headless->display, &major, &minor)) {
+        fprintf(stderr, "[ERROR] No EGL display available (0x%x)\n", eglGetError());
+        return false;
+    }
+
+    const EGLint config_attributes[] = {
+        EGL_SURFACE_TYPE, 0, // Any; the framebuffer object is the render target
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint config_count = 0;
+    if (!eglChooseConfig(headless->display, config_attributes, &config, 1, &config_count) || config_count == 0 ||
+        !eglBindAPI(EGL_OPENGL_API)) {
+        fprintf(stderr, "[ERROR] No desktop OpenGL EGL config (0x%x)\n", eglGetError());
+        eglTerminate(headless->display);
+        return false;
+    }
+
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    headless->context = eglCreateContext(headless->display, config, EGL_NO_CONTEXT, context_attributes);
+    if (headless->context == EGL_NO_CONTEXT) {
+        fprintf(stderr, "[ERROR] Unable to create a GL 3.3 core context (0x%x)\n", eglGetError());
+        eglTerminate(headless->display);
+        return false;
+    }
+
+    if (!eglMakeCurrent(headless->display, EGL_NO_SURFACE, EGL_NO_SURFACE, headless->context)) {
+        // No EGL_KHR_surfaceless_context: a tiny pbuffer only to make the context current
+        const EGLint pbuffer_attributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        headless->surface = eglCreatePbufferSurface(headless->display, config, pbuffer_attributes);
+        if (headless->surface == EGL_NO_SURFACE ||
+            !eglMakeCurrent(headless->display, headless->surface, headless->surface, headless->context)) {
+            fprintf(stderr, "[ERROR] Unable to make the headless context current (0x%x)\n", eglGetError());
+            eglDestroyContext(headless->display, headless->context);
+            eglTerminate(headless->display);
+            return false;
+        }
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        fprintf(stderr, "[ERROR] Failed to initialize GLAD\n");
+        return false;
+    }
+    printf("[INFO] Headless EGL %d.%d: %s, %s\n", major, minor, glGetString(GL_RENDERER), glGetString(GL_VERSION));
+    return true;
+}
+
+static bool create_headless_framebuffer(HeadlessContext* headless, int width, int height)
+{
+    glGenFramebuffers(1, &headless->framebuffer);
+    glGenRenderbuffers(1, &headless->color_renderbuffer);
+    glGenRenderbuffers(1, &headless->depth_renderbuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, headless->color_renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, headless->depth_renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, headless->framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, headless->color_renderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, headless->depth_renderbuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[ERROR] Headless framebuffer incomplete (0x%x)\n", status);
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    check_gl_error("create_headless_framebuffer");
+    return true;
+}
+
+static void destroy_headless_context(HeadlessContext* headless)
+{
+    if (headless->framebuffer != 0) glDeleteFramebuffers(1, &headless->framebuffer);
+    if (headless->color_renderbuffer != 0) glDeleteRenderbuffers(1, &headless->color_renderbuffer);
+    if (headless->depth_renderbuffer != 0) glDeleteRenderbuffers(1, &headless->depth_renderbuffer);
+    if (headless->display == EGL_NO_DISPLAY) return;
+    eglMakeCurrent(headless->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (headless->surface != EGL_NO_SURFACE) eglDestroySurface(headless->display, headless->surface);
+    if (headless->context != EGL_NO_CONTEXT) eglDestroyContext(headless->display, headless->context);
+    eglTerminate(headless->display);
+}
+
+// --- Script ---
+
+/**
+ * Fixed line-up: the two starting units of init_scene plus a mixed squad on each side.
+ */
+static void setup_headless_units(Scene* scene)
+{
+    static const struct { UnitType type; int x, y; bool player; } lineup[] = {
+        {UNIT_MELEE_TANK, 2, 1, true}, {UNIT_RANGED_ARCHER, 5, 0, true}, {UNIT_MELEE_TANK, 6, 2, true},
+        {UNIT_MELEE_TANK, 2, 6, false}, {UNIT_MELEE_TANK, 3, 5, false}, {UNIT_MELEE_TANK, 5, 6, false},
+        {UNIT_RANGED_ARCHER, 3, 7, false}, {UNIT_RANGED_ARCHER, 6, 7, false}
+    };
+    for (int i = 0; i < (int)(sizeof(lineup) / sizeof(lineup[0])) && scene->unit_count < MAX_UNITS; ++i) {
+        init_unit(&scene->units[scene->unit_count++], lineup[i].type, lineup[i].x, lineup[i].y, lineup[i].player, LOC_BOARD);
+    }
+}
+
+/**
+ * Camera orbit and game phase of a frame: the prepare phase with a sweeping hover first, then the fight.
+ */
+static GamePhase script_frame(App* app, int frame, int frame_count)
+{
+    float progress = (float)frame / (float)frame_count;
+    set_camera_orbit(&app->camera, CAMERA_DEFAULT_YAW + 360.0f * progress,
+                     CAMERA_DEFAULT_PITCH - 15.0f * sinf(progress * 2.0f * GLM_PIf),
+                     CAMERA_DEFAULT_ZOOM + 2.0f * cosf(progress * 4.0f * GLM_PIf));
+
+    if (progress < HEADLESS_PREPARE_FRACTION) {
+        app->input_state.is_mouse_over_board = true;
+        app->input_state.hovered_grid_x = frame % BOARD_GRID_WIDTH;
+        app->input_state.hovered_grid_y = (frame / BOARD_GRID_WIDTH) % BOARD_GRID_HEIGHT;
+        return PHASE_PREPARE;
+    }
+    app->input_state.is_mouse_over_board = false;
+    return PHASE_COMBAT;
+}
+
+// --- Captures ---
+
+// In the scratch arena, valid until the caller's end_scratch
+static unsigned char* read_framebuffer(int width, int height)
+{
+    size_t pitch = (size_t)width * 4;
+    unsigned char* pixels = (unsigned char*)scratch_alloc(pitch * (size_t)height);
+    unsigned char* row = (unsigned char*)scratch_alloc(pitch);
+    if (!pixels || !row) {
+        return NULL;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    // GL rows start at the bottom, PNG rows at the top
+    for (int y = 0; y < height / 2; ++y) {
+        unsigned char* top = pixels + (size_t)y * pitch;
+        unsigned char* bottom = pixels + (size_t)(height - 1 - y) * pitch;
+        memcpy(row, top, pitch);
+        memcpy(top, bottom, pitch);
+        memcpy(bottom, row, pitch);
+    }
+    return pixels;
+}
+
+static bool save_capture(const char* path, unsigned char* pixels, int width, int height)
+{
+    // RGBA bytes in memory are SDL_PIXELFORMAT_ABGR8888 on little-endian hosts
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels, width, height, 32, width * 4, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) return false;
+    bool ok = IMG_SavePNG(surface, path) == 0;
+    SDL_FreeSurface(surface);
+    if (!ok) fprintf(stderr, "[ERROR] Unable to write '%s': %s\n", path, IMG_GetError());
+    return ok;
+}
+
+/**
+ * @return true if the frame matches its golden image within the tolerances.
+ */
+static bool compare_with_golden(const HeadlessOptions* options, const char* golden_path, const unsigned char* pixels)
+{
+    SDL_Surface* loaded = IMG_Load(golden_path);
+    if (!loaded) {
+        fprintf(stderr, "[ERROR] Missing golden image '%s'\n", golden_path);
+        return false;
+    }
+    SDL_Surface* golden = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!golden) return false;
+    if (golden->w != options->width || golden->h != options->height) {
+        fprintf(stderr, "[ERROR] '%s' is %dx%d, the capture is %dx%d\n", golden_path, golden->w, golden->h, options->width, options->height);
+        SDL_FreeSurface(golden);
+        return false;
+    }
+
+    long long mismatched = 0;
+    int worst = 0;
+    for (int y = 0; y < options->height; ++y) {
+        const unsigned char* expected = (const unsigned char*)golden->pixels + (size_t)y * golden->pitch;
+        const unsigned char* actual = pixels + (size_t)y * options->width * 4;
+        for (int x = 0; x < options->width * 4; x += 4) {
+            int difference = 0;
+            for (int c = 0; c < 3; ++c) { // Alpha is not part of the picture
+                int d = abs((int)expected[x + c] - (int)actual[x + c]);
+                if (d > difference) difference = d;
+            }
+            if (difference > worst) worst = difference;
+            if (difference > options->tolerance) mismatched++;
+        }
+    }
+    SDL_FreeSurface(golden);
+
+    float fraction = (float)mismatched / (float)((long long)options->width * options->height);
+    bool ok = fraction <= options->max_mismatch;
+    printf("[%s] %s: %.4f%% pixels differ (max channel difference %d)\n",
+           ok ? "INFO" : "ERROR", golden_path, 100.0f * fraction, worst);
+    return ok;
+}
+
+// --- Timings ---
+
+static void print_timing_summary(const char* name, float* values, int count)
+{
+    MetricSummary summary; // Same percentiles as the frame metrics
+    if (!summarize_samples(values, count, &summary)) return;
+    printf("[INFO]   %s ms: avg %.3f, p50 %.3f, p95 %.3f, max %.3f\n", name, summary.mean,
+           summary.p50, summary.p95, summary.max);
+}
+
+static void write_timings(const HeadlessOptions* options, const FrameTiming* timings)
+{
+    if (options->timings_path) {
+        FILE* file = fopen(options->timings_path, "w");
+        if (file) {
+            fprintf(file, "frame,cpu_ms,gpu_ms,draw_calls,triangles\n");
+            for (int i = 0; i < options->frame_count; ++i) {
+                fprintf(file, "%d,%.4f,%.4f,%d,%d\n", i, timings[i].cpu_ms, timings[i].gpu_ms, timings[i].draw_calls, timings[i].triangles);
+            }
+            fclose(file);
+            printf("[INFO] Frame timings written to '%s'\n", options->timings_path);
+        } else {
+            fprintf(stderr, "[ERROR] Unable to write '%s'\n", options->timings_path);
+        }
+    }
+
+    float* values = (float*)malloc((size_t)options->frame_count * sizeof(float));
+    if (!values) return;
+    printf("[INFO] Headless run: %d frames at %dx%d\n", options->frame_count, options->width, options->height);
+    for (int i = 0; i < options->frame_count; ++i) values[i] = timings[i].cpu_ms;
+    print_timing_summary("CPU", values, options->frame_count);
+    for (int i = 0; i < options->frame_count; ++i) values[i] = timings[i].gpu_ms;
+    print_timing_summary("GPU", values, options->frame_count);
+    free(values);
+}
+
+// --- Run ---
+
+int run_headless(const HeadlessOptions* options)
+{
+    static App app; // Too big for the stack
+    HeadlessContext headless;
+
+    if (SDL_Init(SDL_INIT_TIMER) != 0) {
+        fprintf(stderr, "[ERROR] SDL initialization error: %s\n", SDL_GetError());
+        return 1;
+    }
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+    if (!create_headless_context(&headless) ||
+        !create_headless_framebuffer(&headless, options->width, options->height) ||
+        !init_app_resources(&app, options->width, options->height)) {
+        destroy_headless_context(&headless);
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    setup_headless_units(&app.scene);
+    if (options->metrics_path) open_metrics_stream(options->metrics_path);
+    if (options->capture_dir) mkdir(options->capture_dir, 0755);
+
+    FrameTiming* timings = (FrameTiming*)calloc((size_t)options->frame_count, sizeof(FrameTiming));
+    GLuint timer_query;
+    glGenQueries(1, &timer_query);
+    int exit_code = 0;
+    int allocating_frames = 0;
+
+    for (int frame = 0; frame < options->frame_count && timings; ++frame) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        long long heap_allocations = get_heap_allocation_count();
+
+        GamePhase phase = script_frame(&app, frame, options->frame_count);
+        app.game_state.current_phase = phase;
+        step_app_simulation(&app, HEADLESS_TIME_STEP); // Inline: the captures show this frame's step
+        update_app_matrices(&app, options->width, options->height);
+
+        glBeginQuery(GL_TIME_ELAPSED, timer_query);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        render_app_scene(&app);
+        glEndQuery(GL_TIME_ELAPSED);
+        glFinish();
+
+        GLuint64 gpu_ns = 0;
+        glGetQueryObjectui64v(timer_query, GL_QUERY_RESULT, &gpu_ns);
+        timings[frame].cpu_ms = (float)((double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+        timings[frame].gpu_ms = (float)((double)gpu_ns / 1.0e6);
+        timings[frame].draw_calls = get_render_stats()->draw_calls;
+        timings[frame].triangles = get_render_stats()->triangles;
+        end_arena_frame();
+        end_metrics_frame(timings[frame].cpu_ms);
+
+        // --- Steady state does not touch the heap (ALLOC_CHECK builds only) ---
+        heap_allocations = get_heap_allocation_count() - heap_allocations;
+        if (heap_allocations > 0 && frame >= HEADLESS_ALLOC_WARMUP_FRAMES) {
+            fprintf(stderr, "[ERROR] Frame %d made %lld heap allocations\n", frame, heap_allocations);
+            allocating_frames++;
+        }
+
+        // --- Captures and golden comparison ---
+        if (frame % options->capture_interval != 0 || (!options->capture_dir && !options->golden_dir)) continue;
+        ArenaMark scratch = begin_scratch();
+        unsigned char* pixels = read_framebuffer(options->width, options->height);
+        if (!pixels) {
+            end_scratch(scratch);
+            continue;
+        }
+        char path[ASSET_PATH_MAX];
+        if (options->capture_dir) {
+            snprintf(path, sizeof(path), "%s/frame_%04d.png", options->capture_dir, frame);
+            save_capture(path, pixels, options->width, options->height);
+        }
+        if (options->golden_dir) {
+            snprintf(path, sizeof(path), "%s/frame_%04d.png", options->golden_dir, frame);
+            if (!compare_with_golden(options, path, pixels)) exit_code = 2;
+        }
+        end_scratch(scratch);
+    }
+
+    if (timings) write_timings(options, timings);
+    free(timings);
+    glDeleteQueries(1, &timer_query);
+    destroy_app_resources(&app);
+    destroy_headless_context(&headless);
+    IMG_Quit();
+    SDL_Quit();
+    if (exit_code != 0) fprintf(stderr, "[ERROR] Headless run: captures differ from the golden images\n");
+    if (allocating_frames > 0) {
+        fprintf(stderr, "[ERROR] Headless run: %d frames allocated from the heap\n", allocating_frames);
+        if (exit_code == 0) exit_code = 4;
+    }
+    return exit_code;
+}
+
+#endif /* HEADLESS_EGL */
@@ -0,0 +1,88 @@
+#include "health_bars.h"
+#include "arena.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static const vec3 player_bar_color = {0.2f, 0.85f, 0.3f};
+static const vec3 enemy_bar_color = {0.9f, 0.2f, 0.2f};
+
+bool init_health_bars(HealthBarRenderer* bars, int capacity)
+{
+    if (!bars || capacity <= 0) return false;
+    memset(bars, 0, sizeof(HealthBarRenderer));
+
+    bars->capacity = capacity;
+
+    // The quad corners come from gl_VertexID, so the VAO only holds the instance stream
+    glGenVertexArrays(1, &bars->vao_id);
+    glGenBuffers(1, &bars->instance_vbo_id);
+    glBindVertexArray(bars->vao_id);
+    glBindBuffer(GL_ARRAY_BUFFER, bars->instance_vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacity * sizeof(HealthBarInstance), NULL, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(HealthBarInstance), (void*)offsetof(HealthBarInstance, position_health));
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(HealthBarInstance), (void*)offsetof(HealthBarInstance, color));
+    glVertexAttribDivisor(1, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("init_health_bars");
+    return true;
+}
+
+void destroy_health_bars(HealthBarRenderer* bars)
+{
+    if (!bars) return;
+    if (bars->instance_vbo_id != 0) glDeleteBuffers(1, &bars->instance_vbo_id);
+    if (bars->vao_id != 0) glDeleteVertexArrays(1, &bars->vao_id);
+    memset(bars, 0, sizeof(HealthBarRenderer));
+}
+
+void render_health_bars(HealthBarRenderer* bars, ShaderManager* shaders, int bar_shader,
+                        const Unit* units, int unit_count)
+{
+    if (!bars || bars->vao_id == 0 || !units || unit_count <= 0) return;
+
+    // Staging for this frame only
+    int max_count = unit_count < bars->capacity ? unit_count : bars->capacity;
+    HealthBarInstance* instances = (HealthBarInstance*)arena_alloc(get_frame_arena(), (size_t)max_count * sizeof(HealthBarInstance));
+    if (!instances) return;
+
+    int count = 0;
+    for (int i = 0; i < unit_count && count < max_count; ++i) {
+        const Unit* unit = &units[i];
+        if (unit->location != LOC_BOARD || !unit->is_alive) continue;
+
+        HealthBarInstance* instance = &instances[count++];
+        float health = unit->max_hp > 0.0f ? unit->current_hp / unit->max_hp : 0.0f;
+        float charge = 1.0f - unit->attack_cooldown_timer * unit->attack_speed; // 1 when the next attack is ready
+        glm_vec4((float*)unit->world_pos, glm_clamp(health, 0.0f, 1.0f), instance->position_health);
+        instance->position_health[1] += HEALTH_BAR_HEIGHT;
+        glm_vec4((float*)(unit->is_player_unit ? player_bar_color : enemy_bar_color), glm_clamp(charge, 0.0f, 1.0f), instance->color);
+    }
+    if (count == 0) return;
+
+    const ShaderVariant* variant = use_shader_variant(shaders, bar_shader, 0);
+    if (!variant) return;
+
+    // Orphan the buffer so the upload does not wait for the previous frame's draw
+    glBindBuffer(GL_ARRAY_BUFFER, bars->instance_vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)bars->capacity * sizeof(HealthBarInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)count * sizeof(HealthBarInstance), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // On top of the units, like a HUD
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(bars->vao_id);
+    count_vao_bind();
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    count_draw_call(count, 2);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+    check_gl_error("render_health_bars");
+}
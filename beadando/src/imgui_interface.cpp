@@ -8,6 +8,7 @@
 #include <imgui/imgui_impl_opengl3.h> // Now using the actual header
 
 #include <stdio.h> // For printf in example
+#include "metrics.h"
 #include "scene.h"
 #include "unit.h"
 
@@ -275,8 +276,8 @@ const char* GetUnitTypeName(UnitType type) {
     }
 }
 
-void ImGui_DrawBenchWindowWrapper(const struct Scene* scene, int* selected_bench_index_ptr, GamePhase current_phase) {
-    if (!scene || !selected_bench_index_ptr) return;
+void ImGui_DrawBenchWindowWrapper(const Unit* units, int unit_count, int* selected_bench_index_ptr, GamePhase current_phase) {
+    if (!units || !selected_bench_index_ptr) return;
 
     // --- Bench Window ---
     // Position it bottom-left, next to shop? Or along the whole bottom?
@@ -295,10 +296,10 @@ void ImGui_DrawBenchWindowWrapper(const struct Scene* scene, int* selected_bench
         ImGui::Separator();
 
         int current_bench_count = 0;
-        for (int i = 0; i < scene->unit_count; ++i) {
-            if (scene->units[i].location == LOC_BENCH) {
+        for (int i = 0; i < unit_count; ++i) {
+            if (units[i].location == LOC_BENCH) {
                 current_bench_count++;
-                const Unit* bench_unit = &scene->units[i];
+                const Unit* bench_unit = &units[i];
                 char label[64];
                 sprintf(label, "%s##Bench%d", GetUnitTypeName(bench_unit->type), bench_unit->id);
                 bool is_selected = (*selected_bench_index_ptr == i);
@@ -439,6 +440,7 @@ void ImGui_DrawHelpWindowWrapper(bool* p_open) {
         ImGui::Text("Left-Click (Bench): Select a unit for placement.");
         ImGui::Text("Left-Click (Board - Player Side): Place selected unit if tile is valid.");
         ImGui::Text("F1: Toggle this Help window.");
+        ImGui::Text("F3: Toggle the Render Stats window.");
         ImGui::Unindent();
         ImGui::Spacing();
 
@@ -458,4 +460,44 @@ void ImGui_DrawHelpWindowWrapper(bool* p_open) {
     ImGui::End();
 }
 
+void ImGui_DrawRenderStatsWindowWrapper(const RenderStats* stats, bool* p_open) {
+    if (!stats || !p_open || !(*p_open)) {
+        return;
+    }
+
+    if (ImGui::Begin("Render Stats (F3 to toggle)", p_open, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+        MetricSummary frame_time;
+        if (get_metric_summary(METRIC_FRAME_TIME, &frame_time)) {
+            ImGui::Text("Frame ms: p50 %.2f  p95 %.2f  p99 %.2f  max %.2f (%d frames)",
+                        frame_time.p50, frame_time.p95, frame_time.p99, frame_time.max, frame_time.samples);
+        }
+        MetricSummary latency;
+        if (get_metric_summary(find_metric("input_latency_ms"), &latency)) {
+            ImGui::Text("Input to present ms: p50 %.2f  p95 %.2f (scanout not included)", latency.p50, latency.p95);
+        }
+        int render_scale = find_metric("render_scale");
+        if (render_scale >= 0) {
+            ImGui::Text("Render scale: %.0f%%  (3D pass GPU %.2f ms)", get_metric_value(render_scale) * 100.0,
+                        get_metric_value(find_metric("scene_gpu_ms")));
+        }
+        ImGui::Separator();
+        ImGui::Text("Draw calls: %d", stats->draw_calls);
+        ImGui::Text("Indirect commands: %d", stats->indirect_commands);
+        ImGui::Text("Instances: %d", stats->instances);
+        ImGui::Text("Triangles: %d", stats->triangles);
+        ImGui::Text("Texture binds: %d", stats->texture_binds);
+        ImGui::Text("VAO binds: %d", stats->vao_binds);
+        ImGui::Text("Uniform uploads: %d", stats->uniform_uploads);
+        ImGui::Separator();
+        double hit_rate = stats->shadow_cache_lookups > 0
+                ? 100.0 * (double)stats->shadow_cache_hits / (double)stats->shadow_cache_lookups : 0.0;
+        ImGui::Text("Shadow cache hit rate: %.1f%% (%lld / %lld)", hit_rate, stats->shadow_cache_hits, stats->shadow_cache_lookups);
+        ImGui::Text("Shadow layers rendered: %d", stats->shadow_layers_rendered);
+        ImGui::Text("Point lights: %d (%d cell references)", stats->point_lights, stats->point_light_references);
+        ImGui::Text("Particles: %d", stats->particles);
+    }
+    ImGui::End();
+}
+
 } // extern "C"
\ No newline at end of file
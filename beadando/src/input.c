@@ -57,16 +57,22 @@ void InputManager_PollAndProcess(struct App* app, InputState* input_state) {
     input_state->right_mouse_released = false;
     input_state->mouse_wheel_delta_y = 0.0f;
     input_state->quit_requested = false;
+    input_state->event_count = 0;
     input_state->f1_pressed_this_frame = false;
+    input_state->f3_pressed_this_frame = false;
+    input_state->plus_key_pressed = false;
+    input_state->minus_key_pressed = false;
     // hovered_grid_x/y and is_mouse_over_board will be updated later
 
     // --- Get current continuous states ---
     SDL_GetMouseState(&input_state->mouse_screen_x, &input_state->mouse_screen_y);
+    SDL_GetRelativeMouseState(&input_state->mouse_delta_x, &input_state->mouse_delta_y);
     // GetKeyboardState for panning is handled after event polling to combine with presses/releases
 
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         ImGui_ProcessEventWrapper(&event); // Pass to ImGui first
+        input_state->event_count++;
 
         switch (event.type) {
             case SDL_QUIT:
@@ -102,6 +108,16 @@ void InputManager_PollAndProcess(struct App* app, InputState* input_state) {
                 if (event.key.keysym.scancode == SDL_SCANCODE_F1 && !event.key.repeat) {
                     input_state->f1_pressed_this_frame = true;
                 }
+                if (event.key.keysym.scancode == SDL_SCANCODE_F3 && !event.key.repeat) {
+                    input_state->f3_pressed_this_frame = true;
+                }
+                // Light adjustment, repeats while held ('=' is the unshifted '+' key)
+                if (event.key.keysym.scancode == SDL_SCANCODE_KP_PLUS || event.key.keysym.scancode == SDL_SCANCODE_EQUALS) {
+                    input_state->plus_key_pressed = true;
+                }
+                if (event.key.keysym.scancode == SDL_SCANCODE_KP_MINUS || event.key.keysym.scancode == SDL_SCANCODE_MINUS) {
+                    input_state->minus_key_pressed = true;
+                }
                 break;
         }
     }
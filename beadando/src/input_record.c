@@ -0,0 +1,208 @@
+#include "input_record.h"
+
+#include <SDL2/SDL.h>
+
+#include <string.h>
+
+void init_input_recorder(InputRecorder* recorder)
+{
+    memset(recorder, 0, sizeof(InputRecorder));
+    recorder->mode = INPUT_RECORD_OFF;
+    recorder->first_divergent_frame = -1;
+}
+
+bool start_input_recording(InputRecorder* recorder, const char* path)
+{
+    stop_input_recorder(recorder);
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file) {
+        fprintf(stderr, "[ERROR] Unable to create the input recording '%s'\n", path);
+        return false;
+    }
+
+    InputRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = INPUT_RECORD_MAGIC;
+    header.version = INPUT_RECORD_VERSION;
+    header.frame_size = sizeof(InputFrame);
+    fwrite(&header, sizeof(header), 1, recorder->file);
+
+    recorder->mode = INPUT_RECORD_RECORDING;
+    printf("[INFO] Recording input to '%s'\n", path);
+    return true;
+}
+
+bool start_input_replay(InputRecorder* recorder, const char* path)
+{
+    stop_input_recorder(recorder);
+    if (!map_file(&recorder->mapping, path)) {
+        fprintf(stderr, "[ERROR] Unable to open the input recording '%s'\n", path);
+        return false;
+    }
+
+    const InputRecordHeader* header = (const InputRecordHeader*)recorder->mapping.data;
+    if (recorder->mapping.size < sizeof(InputRecordHeader) ||
+        header->magic != INPUT_RECORD_MAGIC || header->version != INPUT_RECORD_VERSION ||
+        header->frame_size != sizeof(InputFrame)) {
+        fprintf(stderr, "[ERROR] '%s' is not an input recording of this build\n", path);
+        unmap_file(&recorder->mapping);
+        return false;
+    }
+
+    // A recording cut short by a crash simply ends at its last whole frame
+    recorder->frames = (const InputFrame*)(header + 1);
+    recorder->frame_count = (int)((recorder->mapping.size - sizeof(InputRecordHeader)) / sizeof(InputFrame));
+    recorder->mode = INPUT_RECORD_REPLAYING;
+    printf("[INFO] Replaying %d frames from '%s'\n", recorder->frame_count, path);
+    return true;
+}
+
+// --- Frame ---
+
+static void store_input_state(InputFrame* frame, const InputState* input)
+{
+    frame->mouse_wheel_delta_y = input->mouse_wheel_delta_y;
+    frame->pan_forward_backward_intent = input->pan_forward_backward_intent;
+    frame->pan_right_left_intent = input->pan_right_left_intent;
+    frame->mouse_x = (int16_t)input->mouse_screen_x;
+    frame->mouse_y = (int16_t)input->mouse_screen_y;
+    frame->mouse_delta_x = (int16_t)input->mouse_delta_x;
+    frame->mouse_delta_y = (int16_t)input->mouse_delta_y;
+    frame->hovered_grid_x = (int8_t)input->hovered_grid_x;
+    frame->hovered_grid_y = (int8_t)input->hovered_grid_y;
+
+    uint32_t flags = 0;
+    if (input->left_mouse_pressed) flags |= INPUT_FRAME_LEFT_PRESSED;
+    if (input->left_mouse_down) flags |= INPUT_FRAME_LEFT_DOWN;
+    if (input->left_mouse_released) flags |= INPUT_FRAME_LEFT_RELEASED;
+    if (input->right_mouse_pressed) flags |= INPUT_FRAME_RIGHT_PRESSED;
+    if (input->right_mouse_down) flags |= INPUT_FRAME_RIGHT_DOWN;
+    if (input->right_mouse_released) flags |= INPUT_FRAME_RIGHT_RELEASED;
+    if (input->is_mouse_over_board) flags |= INPUT_FRAME_OVER_BOARD;
+    if (input->quit_requested) flags |= INPUT_FRAME_QUIT;
+    if (input->f1_pressed_this_frame) flags |= INPUT_FRAME_F1;
+    if (input->f3_pressed_this_frame) flags |= INPUT_FRAME_F3;
+    if (input->plus_key_pressed) flags |= INPUT_FRAME_PLUS;
+    if (input->minus_key_pressed) flags |= INPUT_FRAME_MINUS;
+    if (input->imgui_wants_mouse) flags |= INPUT_FRAME_IMGUI_MOUSE;
+    if (input->imgui_wants_keyboard) flags |= INPUT_FRAME_IMGUI_KEYBOARD;
+    frame->flags = flags;
+}
+
+static void load_input_state(const InputFrame* frame, InputState* input)
+{
+    bool live_quit = input->quit_requested;
+
+    input->mouse_wheel_delta_y = frame->mouse_wheel_delta_y;
+    input->pan_forward_backward_intent = frame->pan_forward_backward_intent;
+    input->pan_right_left_intent = frame->pan_right_left_intent;
+    input->mouse_screen_x = frame->mouse_x;
+    input->mouse_screen_y = frame->mouse_y;
+    input->mouse_delta_x = frame->mouse_delta_x;
+    input->mouse_delta_y = frame->mouse_delta_y;
+    input->hovered_grid_x = frame->hovered_grid_x;
+    input->hovered_grid_y = frame->hovered_grid_y;
+
+    uint32_t flags = frame->flags;
+    input->left_mouse_pressed = (flags & INPUT_FRAME_LEFT_PRESSED) != 0;
+    input->left_mouse_down = (flags & INPUT_FRAME_LEFT_DOWN) != 0;
+    input->left_mouse_released = (flags & INPUT_FRAME_LEFT_RELEASED) != 0;
+    input->right_mouse_pressed = (flags & INPUT_FRAME_RIGHT_PRESSED) != 0;
+    input->right_mouse_down = (flags & INPUT_FRAME_RIGHT_DOWN) != 0;
+    input->right_mouse_released = (flags & INPUT_FRAME_RIGHT_RELEASED) != 0;
+    input->is_mouse_over_board = (flags & INPUT_FRAME_OVER_BOARD) != 0;
+    input->quit_requested = live_quit || (flags & INPUT_FRAME_QUIT) != 0;
+    input->f1_pressed_this_frame = (flags & INPUT_FRAME_F1) != 0;
+    input->f3_pressed_this_frame = (flags & INPUT_FRAME_F3) != 0;
+    input->plus_key_pressed = (flags & INPUT_FRAME_PLUS) != 0;
+    input->minus_key_pressed = (flags & INPUT_FRAME_MINUS) != 0;
+    input->imgui_wants_mouse = (flags & INPUT_FRAME_IMGUI_MOUSE) != 0;
+    input->imgui_wants_keyboard = (flags & INPUT_FRAME_IMGUI_KEYBOARD) != 0;
+}
+
+double begin_input_frame(InputRecorder* recorder, InputState* input_state, double dt)
+{
+    if (recorder->frame_index == 0 && recorder->mode != INPUT_RECORD_OFF) {
+        recorder->start_counter = SDL_GetPerformanceCounter();
+    }
+
+    if (recorder->mode == INPUT_RECORD_RECORDING) {
+        memset(&recorder->frame, 0, sizeof(InputFrame));
+        recorder->frame.dt = dt;
+        store_input_state(&recorder->frame, input_state);
+        return dt;
+    }
+
+    if (recorder->mode == INPUT_RECORD_REPLAYING) {
+        if (recorder->frame_index >= recorder->frame_count) {
+            input_state->quit_requested = true; // Recording used up: the session is over
+            return 0.0;
+        }
+        recorder->frame = recorder->frames[recorder->frame_index];
+        load_input_state(&recorder->frame, input_state);
+        return recorder->frame.dt;
+    }
+    return dt;
+}
+
+void check_input_frame_state(InputRecorder* recorder, uint64_t checksum)
+{
+    if (recorder->mode == INPUT_RECORD_RECORDING) {
+        recorder->frame.checksum = checksum;
+    } else if (recorder->mode == INPUT_RECORD_REPLAYING && checksum != recorder->frame.checksum) {
+        if (recorder->first_divergent_frame < 0) {
+            recorder->first_divergent_frame = recorder->frame_index;
+            fprintf(stderr, "[WARN] Replay diverged at frame %d (checksum %016llx, recorded %016llx)\n",
+                    recorder->frame_index, (unsigned long long)checksum, (unsigned long long)recorder->frame.checksum);
+        }
+        recorder->divergent_frames++;
+    }
+}
+
+int apply_input_frame_ui(InputRecorder* recorder, int ui_actions, int* selected_bench_unit_index)
+{
+    if (recorder->mode == INPUT_RECORD_RECORDING) {
+        recorder->frame.ui_actions = ui_actions;
+        recorder->frame.selected_bench_unit_index = (int16_t)*selected_bench_unit_index;
+    } else if (recorder->mode == INPUT_RECORD_REPLAYING) {
+        *selected_bench_unit_index = recorder->frame.selected_bench_unit_index;
+        return recorder->frame.ui_actions;
+    }
+    return ui_actions;
+}
+
+void end_input_frame(InputRecorder* recorder)
+{
+    if (recorder->mode == INPUT_RECORD_OFF) return;
+    if (recorder->mode == INPUT_RECORD_RECORDING && fwrite(&recorder->frame, sizeof(InputFrame), 1, recorder->file) != 1) {
+        fprintf(stderr, "[ERROR] Failed to write the input recording, recording stopped\n");
+        stop_input_recorder(recorder);
+        return;
+    }
+    recorder->frame_index++;
+}
+
+void stop_input_recorder(InputRecorder* recorder)
+{
+    if (recorder->mode != INPUT_RECORD_OFF && recorder->frame_index > 0) {
+        double seconds = (double)(SDL_GetPerformanceCounter() - recorder->start_counter) / SDL_GetPerformanceFrequency();
+        printf("[INFO] %s %d frames, %.3f ms per frame\n", recorder->mode == INPUT_RECORD_RECORDING ? "Recorded" : "Replayed",
+               recorder->frame_index, 1000.0 * seconds / recorder->frame_index);
+    }
+    if (recorder->mode == INPUT_RECORD_REPLAYING) {
+        if (recorder->divergent_frames > 0) {
+            fprintf(stderr, "[WARN] Replay diverged in %d of %d frames (first: %d)\n",
+                    recorder->divergent_frames, recorder->frame_index, recorder->first_divergent_frame);
+        } else {
+            printf("[INFO] Replay matched the recording on every frame\n");
+        }
+    }
+
+    if (recorder->file) fclose(recorder->file);
+    unmap_file(&recorder->mapping);
+    int divergent_frames = recorder->divergent_frames;
+    int first_divergent_frame = recorder->first_divergent_frame;
+    init_input_recorder(recorder);
+    recorder->divergent_frames = divergent_frames; // Kept for the exit code
+    recorder->first_divergent_frame = first_divergent_frame;
+}
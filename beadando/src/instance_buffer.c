@@ -0,0 +1,84 @@
+#include "instance_buffer.h"
+#include "utils.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+void init_instance_buffer(InstanceBuffer* buffer)
+{
+    if (!buffer) return;
+    buffer->count = 0;
+    buffer->overflow_reported = false;
+    glGenBuffers(1, &buffer->vbo_id);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(buffer->instances), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("init_instance_buffer");
+    printf("[INFO] Instance buffer created: VBO=%u, Capacity=%d\n", buffer->vbo_id, MAX_INSTANCES);
+}
+
+void destroy_instance_buffer(InstanceBuffer* buffer)
+{
+    if (!buffer) return;
+    if (buffer->vbo_id != 0) {
+        glDeleteBuffers(1, &buffer->vbo_id);
+        buffer->vbo_id = 0;
+    }
+    buffer->count = 0;
+}
+
+void clear_instances(InstanceBuffer* buffer)
+{
+    if (buffer) buffer->count = 0;
+}
+
+InstanceData* push_instance(InstanceBuffer* buffer)
+{
+    if (!buffer) return NULL;
+    if (buffer->count >= MAX_INSTANCES) {
+        if (!buffer->overflow_reported) {
+            printf("[WARN] push_instance - instance buffer full (%d), further instances are dropped\n", MAX_INSTANCES);
+            buffer->overflow_reported = true;
+        }
+        return NULL;
+    }
+    return &buffer->instances[buffer->count++];
+}
+
+void upload_instances(const InstanceBuffer* buffer)
+{
+    if (!buffer || buffer->vbo_id == 0 || buffer->count == 0) return;
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo_id);
+    // Orphan the previous frame's storage so the driver does not stall on it
+    glBufferData(GL_ARRAY_BUFFER, sizeof(buffer->instances), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, buffer->count * sizeof(InstanceData), buffer->instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void bind_instance_attributes(const InstanceBuffer* buffer, int first_instance)
+{
+    if (!buffer) return;
+    size_t base = (size_t)first_instance * sizeof(InstanceData);
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo_id);
+    for (int column = 0; column < 4; ++column) {
+        GLuint location = INSTANCE_ATTRIB_MODEL + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + offsetof(InstanceData, model) + column * sizeof(vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
+    glEnableVertexAttribArray(INSTANCE_ATTRIB_TINT);
+    glVertexAttribPointer(INSTANCE_ATTRIB_TINT, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(base + offsetof(InstanceData, color_tint)));
+    glVertexAttribDivisor(INSTANCE_ATTRIB_TINT, 1);
+    glEnableVertexAttribArray(INSTANCE_ATTRIB_LAYER);
+    glVertexAttribPointer(INSTANCE_ATTRIB_LAYER, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(base + offsetof(InstanceData, texture_layer)));
+    glVertexAttribDivisor(INSTANCE_ATTRIB_LAYER, 1);
+    glEnableVertexAttribArray(INSTANCE_ATTRIB_ANIMATION);
+    glVertexAttribPointer(INSTANCE_ATTRIB_ANIMATION, 2, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(base + offsetof(InstanceData, animation)));
+    glVertexAttribDivisor(INSTANCE_ATTRIB_ANIMATION, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,337 @@
+#include "job_system.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct Job
+{
+    JobFunction function;
+    void* data;
+    JobCounter* counter;
+    JobCounter* dependency; // Only set while the job waits in the pending list
+} Job;
+
+typedef struct JobDeque
+{
+    SDL_SpinLock lock;
+    unsigned int top;    // Oldest job, taken by thieves
+    unsigned int bottom; // One past the newest job, pushed and popped by the owner
+    Job jobs[JOB_DEQUE_CAPACITY];
+} JobDeque;
+
+typedef struct ParallelForBatch
+{
+    ParallelForFunction function;
+    void* data;
+    int begin;
+    int end;
+} ParallelForBatch;
+
+static struct
+{
+    bool running;
+    int worker_count; // Fixed before the first thread starts; the threads read it
+    int thread_count; // Started, can be fewer if creating a thread failed
+    SDL_Thread* threads[MAX_JOB_WORKERS];
+    JobDeque deques[MAX_JOB_WORKERS + 1]; // 0 is the main thread
+    SDL_sem* wake;                        // Posted once per queued job
+    SDL_atomic_t quit;
+
+    SDL_mutex* pending_lock;
+    Job pending[MAX_PENDING_JOBS];
+    int pending_count;
+
+    SDL_mutex* main_lock;
+    Job main_jobs[MAX_MAIN_THREAD_JOBS];
+    int main_first;
+    int main_count;
+} scheduler;
+
+static _Thread_local int thread_index = 0; // Deque of the calling thread, 0 on the main thread
+
+// --- Deques ---
+
+static bool push_deque(JobDeque* deque, const Job* job)
+{
+    SDL_AtomicLock(&deque->lock);
+    bool pushed = deque->bottom - deque->top < JOB_DEQUE_CAPACITY;
+    if (pushed) {
+        deque->jobs[deque->bottom % JOB_DEQUE_CAPACITY] = *job;
+        deque->bottom++;
+    }
+    SDL_AtomicUnlock(&deque->lock);
+    return pushed;
+}
+
+static bool pop_deque(JobDeque* deque, Job* job)
+{
+    SDL_AtomicLock(&deque->lock);
+    bool popped = deque->bottom != deque->top;
+    if (popped) {
+        deque->bottom--;
+        *job = deque->jobs[deque->bottom % JOB_DEQUE_CAPACITY];
+    }
+    SDL_AtomicUnlock(&deque->lock);
+    return popped;
+}
+
+static bool steal_deque(JobDeque* deque, Job* job)
+{
+    SDL_AtomicLock(&deque->lock);
+    bool stolen = deque->bottom != deque->top;
+    if (stolen) {
+        *job = deque->jobs[deque->top % JOB_DEQUE_CAPACITY];
+        deque->top++;
+    }
+    SDL_AtomicUnlock(&deque->lock);
+    return stolen;
+}
+
+// --- Running jobs ---
+
+static void push_job(const Job* job);
+
+/**
+ * Queues the pending jobs that waited for the counter that just finished.
+ */
+static void release_dependents(JobCounter* counter)
+{
+    Job ready[MAX_PENDING_JOBS];
+    int ready_count = 0;
+    SDL_LockMutex(scheduler.pending_lock);
+    for (int i = 0; i < scheduler.pending_count;) {
+        if (scheduler.pending[i].dependency == counter) {
+            ready[ready_count] = scheduler.pending[i];
+            ready[ready_count++].dependency = NULL;
+            scheduler.pending[i] = scheduler.pending[--scheduler.pending_count];
+        } else {
+            ++i;
+        }
+    }
+    SDL_UnlockMutex(scheduler.pending_lock);
+    for (int i = 0; i < ready_count; ++i) {
+        push_job(&ready[i]);
+    }
+}
+
+static void execute_job(const Job* job)
+{
+    job->function(job->data);
+    if (job->counter && SDL_AtomicDecRef(&job->counter->pending)) {
+        if (scheduler.running) release_dependents(job->counter);
+    }
+}
+
+static void push_job(const Job* job)
+{
+    if (!scheduler.running || !push_deque(&scheduler.deques[thread_index], job)) {
+        execute_job(job); // No pool, or the deque is full
+        return;
+    }
+    SDL_SemPost(scheduler.wake);
+}
+
+static bool find_job(Job* job)
+{
+    if (pop_deque(&scheduler.deques[thread_index], job)) return true;
+    int deque_count = scheduler.worker_count + 1;
+    for (int i = 1; i < deque_count; ++i) {
+        if (steal_deque(&scheduler.deques[(thread_index + i) % deque_count], job)) return true;
+    }
+    return false;
+}
+
+static int worker_main(void* data)
+{
+    thread_index = (int)(intptr_t)data;
+    while (!SDL_AtomicGet(&scheduler.quit)) {
+        Job job;
+        if (find_job(&job)) {
+            execute_job(&job);
+        } else {
+            SDL_SemWait(scheduler.wake);
+        }
+    }
+    return 0;
+}
+
+// --- Public API ---
+
+void init_job_system(int worker_count)
+{
+    if (scheduler.running) return;
+    memset(&scheduler, 0, sizeof(scheduler));
+    if (worker_count <= 0) worker_count = SDL_GetCPUCount() - 1;
+    if (worker_count > MAX_JOB_WORKERS) worker_count = MAX_JOB_WORKERS;
+    if (worker_count <= 0) {
+        printf("[INFO] Job system: no worker threads, jobs run inline\n");
+        return;
+    }
+
+    scheduler.wake = SDL_CreateSemaphore(0);
+    scheduler.pending_lock = SDL_CreateMutex();
+    scheduler.main_lock = SDL_CreateMutex();
+    if (!scheduler.wake || !scheduler.pending_lock || !scheduler.main_lock) {
+        fprintf(stderr, "[ERROR] Job system: %s, jobs run inline\n", SDL_GetError());
+        shutdown_job_system();
+        return;
+    }
+    scheduler.running = true;
+    scheduler.worker_count = worker_count;
+    for (int i = 0; i < worker_count; ++i) {
+        scheduler.threads[i] = SDL_CreateThread(worker_main, "job_worker", (void*)(intptr_t)(i + 1));
+        if (!scheduler.threads[i]) {
+            fprintf(stderr, "[WARN] Job system: worker %d not started: %s\n", i + 1, SDL_GetError());
+            break; // The deques of the missing workers stay empty
+        }
+        scheduler.thread_count++;
+    }
+    printf("[INFO] Job system: %d worker threads\n", scheduler.thread_count);
+}
+
+void shutdown_job_system(void)
+{
+    if (scheduler.running) {
+        // Leftovers run here, so no counter is left waiting
+        for (;;) {
+            Job job;
+            if (find_job(&job)) execute_job(&job);
+            else if (run_main_thread_jobs() == 0) break;
+        }
+        SDL_AtomicSet(&scheduler.quit, 1);
+        for (int i = 0; i < scheduler.thread_count; ++i) {
+            SDL_SemPost(scheduler.wake);
+        }
+        for (int i = 0; i < scheduler.thread_count; ++i) {
+            SDL_WaitThread(scheduler.threads[i], NULL);
+        }
+    }
+    if (scheduler.wake) SDL_DestroySemaphore(scheduler.wake);
+    if (scheduler.pending_lock) SDL_DestroyMutex(scheduler.pending_lock);
+    if (scheduler.main_lock) SDL_DestroyMutex(scheduler.main_lock);
+    memset(&scheduler, 0, sizeof(scheduler));
+}
+
+int get_job_thread_count(void)
+{
+    return scheduler.thread_count + 1;
+}
+
+void run_job(JobFunction function, void* data, JobCounter* counter)
+{
+    run_job_after(function, data, NULL, counter);
+}
+
+void run_job_after(JobFunction function, void* data, JobCounter* dependency, JobCounter* counter)
+{
+    if (counter) SDL_AtomicIncRef(&counter->pending);
+    Job job = {function, data, counter, NULL};
+
+    if (dependency && !is_job_counter_done(dependency)) {
+        if (!scheduler.running) {
+            wait_for_job_counter(dependency); // Inline: the dependency can only finish through this thread
+        } else {
+            // Checked again under the lock: release_dependents takes it after the counter reached zero
+            SDL_LockMutex(scheduler.pending_lock);
+            bool parked = !is_job_counter_done(dependency) && scheduler.pending_count < MAX_PENDING_JOBS;
+            if (parked) {
+                job.dependency = dependency;
+                scheduler.pending[scheduler.pending_count++] = job;
+            }
+            SDL_UnlockMutex(scheduler.pending_lock);
+            if (parked) return;
+            wait_for_job_counter(dependency); // Finished meanwhile, or no room: wait here instead
+        }
+    }
+    push_job(&job);
+}
+
+void run_main_thread_job(JobFunction function, void* data, JobCounter* counter)
+{
+    Job job = {function, data, counter, NULL};
+    if (counter) SDL_AtomicIncRef(&counter->pending);
+    if (!scheduler.running) {
+        execute_job(&job);
+        return;
+    }
+    for (;;) {
+        SDL_LockMutex(scheduler.main_lock);
+        bool queued = scheduler.main_count < MAX_MAIN_THREAD_JOBS;
+        if (queued) {
+            scheduler.main_jobs[(scheduler.main_first + scheduler.main_count++) % MAX_MAIN_THREAD_JOBS] = job;
+        }
+        SDL_UnlockMutex(scheduler.main_lock);
+        if (queued) return;
+        if (thread_index == 0) run_main_thread_jobs(); // Full: make room ourselves
+        else SDL_Delay(1);
+    }
+}
+
+int run_main_thread_jobs(void)
+{
+    if (!scheduler.running || thread_index != 0) return 0;
+    int run_count = 0;
+    for (;;) {
+        Job job;
+        SDL_LockMutex(scheduler.main_lock);
+        bool found = scheduler.main_count > 0;
+        if (found) {
+            job = scheduler.main_jobs[scheduler.main_first];
+            scheduler.main_first = (scheduler.main_first + 1) % MAX_MAIN_THREAD_JOBS;
+            scheduler.main_count--;
+        }
+        SDL_UnlockMutex(scheduler.main_lock);
+        if (!found) return run_count;
+        execute_job(&job);
+        run_count++;
+    }
+}
+
+bool is_job_counter_done(JobCounter* counter)
+{
+    return SDL_AtomicGet(&counter->pending) == 0;
+}
+
+void wait_for_job_counter(JobCounter* counter)
+{
+    while (!is_job_counter_done(counter)) {
+        Job job;
+        if (scheduler.running && find_job(&job)) {
+            execute_job(&job);
+        } else if (run_main_thread_jobs() == 0) {
+            SDL_Delay(0); // The last jobs run elsewhere: yield
+        }
+    }
+}
+
+static void run_parallel_for_batch(void* data)
+{
+    const ParallelForBatch* batch = (const ParallelForBatch*)data;
+    batch->function(batch->begin, batch->end, batch->data);
+}
+
+void parallel_for(int count, int batch_size, ParallelForFunction function, void* data)
+{
+    if (count <= 0) return;
+    if (batch_size < 1) batch_size = 1;
+    if (!scheduler.running || count <= batch_size) {
+        function(0, count, data);
+        return;
+    }
+    int min_batch_size = (count + MAX_PARALLEL_FOR_BATCHES - 1) / MAX_PARALLEL_FOR_BATCHES;
+    if (batch_size < min_batch_size) batch_size = min_batch_size;
+
+    ParallelForBatch batches[MAX_PARALLEL_FOR_BATCHES];
+    JobCounter counter = {{0}};
+    int batch_count = 0;
+    for (int begin = 0; begin < count; begin += batch_size) {
+        ParallelForBatch* batch = &batches[batch_count++];
+        batch->function = function;
+        batch->data = data;
+        batch->begin = begin;
+        batch->end = begin + batch_size < count ? begin + batch_size : count;
+        run_job(run_parallel_for_batch, batch, &counter);
+    }
+    wait_for_job_counter(&counter);
+}
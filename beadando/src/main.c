@@ -1,26 +1,74 @@
 #include "app.h"
+#include "headless.h"
+#include "metrics.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /**
  * Main function
  */
 int main(int argc, char* argv[])
 {
+    HeadlessOptions headless_options;
+    if (parse_headless_options(argc, argv, &headless_options)) {
+        return run_headless(&headless_options);
+    }
+
     App app;
 
     printf("DEBUG: main - Calling init_app...\n");
     init_app(&app, 800, 600);
+
+    // Repeatable sessions: --record <file> writes the input of every frame, --replay <file> plays it back
+    // --metrics <file.csv|file.json> streams the frame metrics
+    // --fps <n> limits the frame rate, --vsync on|off|adaptive overrides the default (adaptive)
+    // --render-scale auto|<0.1-1> fixes the resolution of the 3D pass or lets it follow the frame time (default)
+    // --pipeline on|off simulates the next frame on a job worker while this one is drawn (default on)
+    int target_fps = 0;
+    VsyncMode vsync = VSYNC_ADAPTIVE;
+    bool pacing_changed = false;
+    bool pipelined = true;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0) {
+            start_input_recording(&app.input_recorder, argv[i + 1]);
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            start_input_replay(&app.input_recorder, argv[i + 1]);
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            open_metrics_stream(argv[i + 1]);
+        } else if (strcmp(argv[i], "--fps") == 0) {
+            target_fps = atoi(argv[i + 1]);
+            pacing_changed = true;
+        } else if (strcmp(argv[i], "--vsync") == 0) {
+            if (parse_vsync_mode(argv[i + 1], &vsync)) pacing_changed = true;
+            else printf("[WARN] Unknown --vsync mode '%s' (on, off, adaptive)\n", argv[i + 1]);
+        } else if (strcmp(argv[i], "--render-scale") == 0 && app.is_running) {
+            set_dynamic_resolution_scale(&app.dynamic_resolution, strcmp(argv[i + 1], "auto") == 0 ? 0.0f : (float)atof(argv[i + 1]));
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            pipelined = strcmp(argv[i + 1], "off") != 0;
+        }
+    }
+    if (pacing_changed && app.is_running) {
+        init_frame_pacer(&app.frame_pacer, app.window, target_fps, vsync);
+    }
+    if (app.is_running) {
+        set_app_pipelined(&app, pipelined);
+    }
     printf("DEBUG: main - init_app finished. Checking loop condition (app.is_running=%s)...\n", app.is_running ? "true" : "false");
 
     while (app.is_running) {
         update_app(&app);
-        render_app(&app);
+        if (should_render_app(&app)) {
+            render_app(&app);
+        } else {
+            wait_for_app_events(&app); // Nothing changed: sleep instead of drawing the same frame
+        }
     }
     
     printf("DEBUG: main - Loop finished. Calling destroy_app...\n");
     destroy_app(&app);
     printf("DEBUG: main - Exiting.\n");
 
-    return 0;
+    return app.input_recorder.divergent_frames > 0 ? 3 : 0; // A replay that diverged fails the run
 }
@@ -0,0 +1,311 @@
+#include "mesh_pool.h"
+#include "mesh_container.h"
+#include "asset_paths.h"
+#include "asset_pack.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <obj/load.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Command layout read by glMultiDrawElementsIndirect (GL 4.3).
+ */
+typedef struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+} DrawElementsIndirectCommand;
+
+static void configure_vertex_attributes(const MeshPool* pool)
+{
+    glBindVertexArray(pool->vao_id);
+    glBindBuffer(GL_ARRAY_BUFFER, pool->vbo_id);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tex_coord));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool->ibo_id);
+
+    glBindVertexArray(0); // Unbind VAO first!
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/**
+ * Replaces the buffer with a bigger one, keeping the first used_size bytes.
+ * The copy targets are used so the VAO's element buffer binding is not touched.
+ */
+static bool grow_buffer(GLuint* buffer_id, GLsizeiptr used_size, GLsizeiptr new_size)
+{
+    GLuint new_buffer = 0;
+    glGenBuffers(1, &new_buffer);
+    if (new_buffer == 0) return false;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_size, NULL, GL_STATIC_DRAW);
+    if (used_size > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, *buffer_id);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used_size);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, buffer_id);
+    *buffer_id = new_buffer;
+    return true;
+}
+
+bool init_mesh_pool(MeshPool* pool)
+{
+    if (!pool) return false;
+    memset(pool, 0, sizeof(MeshPool));
+
+    pool->vertex_capacity = MESH_POOL_INITIAL_VERTICES;
+    pool->index_capacity = MESH_POOL_INITIAL_INDICES;
+
+    glGenVertexArrays(1, &pool->vao_id);
+    glGenBuffers(1, &pool->vbo_id);
+    glGenBuffers(1, &pool->ibo_id);
+    if (pool->vao_id == 0 || pool->vbo_id == 0 || pool->ibo_id == 0) {
+        fprintf(stderr, "ERROR: init_mesh_pool - Failed to create VAO/buffers\n");
+        destroy_mesh_pool(pool);
+        return false;
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool->vbo_id);
+    glBufferData(GL_COPY_WRITE_BUFFER, pool->vertex_capacity * sizeof(VertexData), NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool->ibo_id);
+    glBufferData(GL_COPY_WRITE_BUFFER, pool->index_capacity * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    configure_vertex_attributes(pool);
+
+    // Multi-draw indirect is core since 4.3; the 3.3 path draws batch by batch
+    if (GLAD_GL_VERSION_4_3 && glMultiDrawElementsIndirect != NULL) {
+        glGenBuffers(1, &pool->indirect_buffer_id);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pool->indirect_buffer_id);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, MAX_POOL_DRAWS * sizeof(DrawElementsIndirectCommand), NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    check_gl_error("init_mesh_pool");
+
+    printf("[INFO] Mesh pool created: VAO=%u, VBO=%u, IBO=%u, Indirect=%s\n",
+           pool->vao_id, pool->vbo_id, pool->ibo_id, pool->indirect_buffer_id != 0 ? "Yes" : "No");
+    return true;
+}
+
+void destroy_mesh_pool(MeshPool* pool)
+{
+    if (!pool) return;
+
+    if (pool->indirect_buffer_id != 0) glDeleteBuffers(1, &pool->indirect_buffer_id);
+    if (pool->ibo_id != 0) glDeleteBuffers(1, &pool->ibo_id);
+    if (pool->vbo_id != 0) glDeleteBuffers(1, &pool->vbo_id);
+    if (pool->vao_id != 0) glDeleteVertexArrays(1, &pool->vao_id);
+    memset(pool, 0, sizeof(MeshPool));
+}
+
+int add_mesh_to_pool(MeshPool* pool, const VertexData* vertices, GLsizei vertex_count, const GLuint* indices, GLsizei index_count,
+                     const float* bounds_min, const float* bounds_max)
+{
+    if (!pool || pool->vao_id == 0 || !vertices || !indices || vertex_count <= 0 || index_count <= 0) {
+        return -1;
+    }
+    if (pool->mesh_count >= MAX_POOL_MESHES) {
+        fprintf(stderr, "ERROR: add_mesh_to_pool - Pool is full (%d meshes)\n", MAX_POOL_MESHES);
+        return -1;
+    }
+
+    // --- Grow the shared buffers if the mesh does not fit ---
+    bool regrown = false;
+    if (pool->vertex_count + vertex_count > pool->vertex_capacity) {
+        GLsizei new_capacity = pool->vertex_capacity;
+        while (pool->vertex_count + vertex_count > new_capacity) new_capacity *= 2;
+        if (!grow_buffer(&pool->vbo_id, pool->vertex_count * sizeof(VertexData), new_capacity * sizeof(VertexData))) {
+            fprintf(stderr, "ERROR: add_mesh_to_pool - Failed to grow the vertex buffer\n");
+            return -1;
+        }
+        pool->vertex_capacity = new_capacity;
+        regrown = true;
+    }
+    if (pool->index_count + index_count > pool->index_capacity) {
+        GLsizei new_capacity = pool->index_capacity;
+        while (pool->index_count + index_count > new_capacity) new_capacity *= 2;
+        if (!grow_buffer(&pool->ibo_id, pool->index_count * sizeof(GLuint), new_capacity * sizeof(GLuint))) {
+            fprintf(stderr, "ERROR: add_mesh_to_pool - Failed to grow the index buffer\n");
+            return -1;
+        }
+        pool->index_capacity = new_capacity;
+        regrown = true;
+    }
+    if (regrown) {
+        configure_vertex_attributes(pool); // The VAO still points at the old buffers
+    }
+
+    // --- Upload into the free tail ---
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool->vbo_id);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, pool->vertex_count * sizeof(VertexData), vertex_count * sizeof(VertexData), vertices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool->ibo_id);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, pool->index_count * sizeof(GLuint), index_count * sizeof(GLuint), indices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    check_gl_error("add_mesh_to_pool - upload");
+
+    int mesh = pool->mesh_count++;
+    pool->meshes[mesh].base_vertex = pool->vertex_count;
+    pool->meshes[mesh].first_index = (GLuint)pool->index_count;
+    pool->meshes[mesh].index_count = index_count;
+    if (bounds_min && bounds_max) {
+        memcpy(pool->meshes[mesh].bounds_min, bounds_min, 3 * sizeof(float));
+        memcpy(pool->meshes[mesh].bounds_max, bounds_max, 3 * sizeof(float));
+    } else {
+        compute_vertex_bounds(vertices, vertex_count, pool->meshes[mesh].bounds_min, pool->meshes[mesh].bounds_max);
+    }
+    pool->vertex_count += vertex_count;
+    pool->index_count += index_count;
+
+    printf("[INFO] Mesh %d added to pool: BaseVertex=%d, FirstIndex=%u, Indices=%d\n",
+           mesh, pool->meshes[mesh].base_vertex, pool->meshes[mesh].first_index, index_count);
+    return mesh;
+}
+
+int add_model_to_pool(MeshPool* pool, const Model* model)
+{
+    VertexData* vertex_data = NULL;
+    GLuint* index_data = NULL;
+    GLsizei index_count = 0;
+    if (!build_model_vertex_data(model, &vertex_data, &index_data, &index_count)) {
+        return -1;
+    }
+
+    // build_model_vertex_data emits one vertex per index
+    int mesh = add_mesh_to_pool(pool, vertex_data, index_count, index_data, index_count, NULL, NULL);
+
+    free(vertex_data);
+    free(index_data);
+    return mesh;
+}
+
+static int load_mesh_container_into_pool(MeshPool* pool, const char* path)
+{
+    AssetData asset;
+    if (!open_asset(path, &asset)) {
+        return -1; // Not cooked (yet), caller falls back to the OBJ
+    }
+
+    const unsigned char* base = (const unsigned char*)asset.data;
+    const MeshContainerHeader* header = (const MeshContainerHeader*)base;
+    if (asset.size < sizeof(MeshContainerHeader) ||
+        header->magic != MESH_CONTAINER_MAGIC || header->version != MESH_CONTAINER_VERSION ||
+        header->vertex_stride != sizeof(VertexData)) {
+        fprintf(stderr, "[ERROR] Mesh container '%s' has a bad magic/version (re-cook it).\n", path);
+        close_asset(&asset);
+        return -1;
+    }
+    if (header->vertex_offset > asset.size ||
+        (uint64_t)header->vertex_count * sizeof(VertexData) > asset.size - header->vertex_offset ||
+        header->index_offset > asset.size ||
+        (uint64_t)header->index_count * sizeof(uint32_t) > asset.size - header->index_offset) {
+        fprintf(stderr, "[ERROR] Mesh container '%s' is truncated.\n", path);
+        close_asset(&asset);
+        return -1;
+    }
+
+    // Drawn with the mesh's base vertex: an index past vertex_count reads another mesh or past the VBO
+    const uint32_t* indices = (const uint32_t*)(base + header->index_offset);
+    for (uint32_t i = 0; i < header->index_count; ++i) {
+        if (indices[i] >= header->vertex_count) {
+            fprintf(stderr, "[ERROR] Mesh container '%s': index %u is %u, past the %u vertices.\n", path, i,
+                    indices[i], header->vertex_count);
+            close_asset(&asset);
+            return -1;
+        }
+    }
+
+    int mesh = add_mesh_to_pool(pool, (const VertexData*)(base + header->vertex_offset), (GLsizei)header->vertex_count,
+                                (const GLuint*)indices, (GLsizei)header->index_count,
+                                header->bounds_min, header->bounds_max);
+    close_asset(&asset);
+    return mesh;
+}
+
+int load_mesh_into_pool(MeshPool* pool, const char* model_path)
+{
+    if (!pool || !model_path) return -1;
+
+    char cooked_path[ASSET_PATH_MAX];
+    if (get_cooked_asset_path(model_path, ".mesh", cooked_path, sizeof(cooked_path))) {
+        int mesh = load_mesh_container_into_pool(pool, cooked_path);
+        if (mesh >= 0) {
+            printf("[INFO] Loaded cooked mesh '%s'\n", cooked_path);
+            return mesh;
+        }
+    }
+
+    Model model;
+    if (!load_model(&model, model_path)) {
+        return -1;
+    }
+    int mesh = add_model_to_pool(pool, &model);
+    free_model(&model);
+    return mesh;
+}
+
+void draw_mesh_pool(const MeshPool* pool, const InstanceBuffer* instances, const MeshDraw* draws, int draw_count)
+{
+    if (!pool || pool->vao_id == 0 || !instances || !draws || draw_count <= 0) return;
+    if (draw_count > MAX_POOL_DRAWS) draw_count = MAX_POOL_DRAWS;
+
+    glBindVertexArray(pool->vao_id);
+    count_vao_bind();
+
+    if (pool->indirect_buffer_id != 0) {
+        // base_instance offsets the instanced attributes, so they are pointed at the start once
+        DrawElementsIndirectCommand commands[MAX_POOL_DRAWS];
+        int command_count = 0;
+        for (int i = 0; i < draw_count; ++i) {
+            if (draws[i].mesh < 0 || draws[i].mesh >= pool->mesh_count || draws[i].instance_count <= 0) continue;
+            const PoolMesh* mesh = &pool->meshes[draws[i].mesh];
+            DrawElementsIndirectCommand* command = &commands[command_count++];
+            command->count = (GLuint)mesh->index_count;
+            command->instance_count = (GLuint)draws[i].instance_count;
+            command->first_index = mesh->first_index;
+            command->base_vertex = mesh->base_vertex;
+            command->base_instance = (GLuint)draws[i].first_instance;
+            count_indirect_command(draws[i].instance_count, mesh->index_count / 3);
+        }
+
+        if (command_count > 0) {
+            bind_instance_attributes(instances, 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pool->indirect_buffer_id);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(commands), NULL, GL_STREAM_DRAW);
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, command_count * sizeof(DrawElementsIndirectCommand), commands);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, NULL, command_count, 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            count_draw_call(0, 0);
+        }
+    } else {
+        // GL 3.3 has no base instance, so each batch re-points the instance attributes
+        for (int i = 0; i < draw_count; ++i) {
+            if (draws[i].mesh < 0 || draws[i].mesh >= pool->mesh_count || draws[i].instance_count <= 0) continue;
+            const PoolMesh* mesh = &pool->meshes[draws[i].mesh];
+            bind_instance_attributes(instances, draws[i].first_instance);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, mesh->index_count, GL_UNSIGNED_INT,
+                                              (void*)(mesh->first_index * sizeof(GLuint)),
+                                              draws[i].instance_count, mesh->base_vertex);
+            count_draw_call(draws[i].instance_count, mesh->index_count / 3);
+        }
+    }
+
+    glBindVertexArray(0);
+}
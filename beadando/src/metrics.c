@@ -0,0 +1,226 @@
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct Metric
+{
+    char name[MAX_METRIC_NAME];
+    MetricKind kind;
+    double value; // Frame being recorded
+    float window[METRICS_WINDOW_FRAMES]; // Ring of finished frames
+    double stream_sum; // Of the streamed frames, for the whole-run summary
+    double stream_max;
+} Metric;
+
+typedef struct MetricsRegistry
+{
+    Metric metrics[MAX_METRICS];
+    int metric_count;
+    int window_next;  // Ring position of the next finished frame
+    int window_count;
+    long long frame_index;
+
+    FILE* stream;
+    bool stream_json;
+    int stream_columns; // Metrics when the stream header was written
+    long long stream_frames;
+} MetricsRegistry;
+
+static MetricsRegistry registry;
+
+static void ensure_frame_time_metric(void)
+{
+    if (registry.metric_count > 0) return;
+    snprintf(registry.metrics[0].name, MAX_METRIC_NAME, "frame_ms");
+    registry.metrics[0].kind = METRIC_GAUGE;
+    registry.metric_count = 1;
+}
+
+int register_metric(const char* name, MetricKind kind)
+{
+    ensure_frame_time_metric();
+    int existing = find_metric(name);
+    if (existing >= 0) return existing;
+    if (registry.metric_count >= MAX_METRICS) {
+        fprintf(stderr, "[WARN] Metrics registry full, '%s' is not recorded (limit %d)\n", name, MAX_METRICS);
+        return -1;
+    }
+    Metric* metric = &registry.metrics[registry.metric_count];
+    memset(metric, 0, sizeof(Metric));
+    snprintf(metric->name, MAX_METRIC_NAME, "%s", name);
+    metric->kind = kind;
+    return registry.metric_count++;
+}
+
+int find_metric(const char* name)
+{
+    for (int i = 0; i < registry.metric_count; ++i) {
+        if (strcmp(registry.metrics[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+const char* get_metric_name(int metric)
+{
+    if (metric < 0 || metric >= registry.metric_count) return "";
+    return registry.metrics[metric].name;
+}
+
+void add_metric(int metric, double value)
+{
+    if (metric < 0 || metric >= registry.metric_count) return;
+    registry.metrics[metric].value += value;
+}
+
+void set_metric(int metric, double value)
+{
+    if (metric < 0 || metric >= registry.metric_count) return;
+    registry.metrics[metric].value = value;
+}
+
+double get_metric_value(int metric)
+{
+    if (metric < 0 || metric >= registry.metric_count) return 0.0;
+    return registry.metrics[metric].value;
+}
+
+// --- Stream ---
+
+static void write_stream_header(void)
+{
+    registry.stream_columns = registry.metric_count;
+    if (registry.stream_json) {
+        fprintf(registry.stream, "{\n  \"metrics\": [\"frame\"");
+        for (int i = 0; i < registry.stream_columns; ++i) fprintf(registry.stream, ", \"%s\"", registry.metrics[i].name);
+        fprintf(registry.stream, "],\n  \"frames\": [\n");
+    } else {
+        fprintf(registry.stream, "frame");
+        for (int i = 0; i < registry.stream_columns; ++i) fprintf(registry.stream, ",%s", registry.metrics[i].name);
+        fprintf(registry.stream, "\n");
+    }
+}
+
+static void write_stream_row(void)
+{
+    if (registry.stream_columns == 0) write_stream_header();
+    bool json = registry.stream_json;
+    if (json) fprintf(registry.stream, "%s    [%lld", registry.stream_frames > 0 ? ",\n" : "", registry.frame_index);
+    else fprintf(registry.stream, "%lld", registry.frame_index);
+    for (int i = 0; i < registry.stream_columns; ++i) {
+        Metric* metric = &registry.metrics[i];
+        fprintf(registry.stream, json ? ", %.6g" : ",%.6g", metric->value);
+        metric->stream_sum += metric->value;
+        if (registry.stream_frames == 0 || metric->value > metric->stream_max) metric->stream_max = metric->value;
+    }
+    registry.stream_frames++;
+    fprintf(registry.stream, json ? "]" : "\n");
+}
+
+bool open_metrics_stream(const char* path)
+{
+    close_metrics_stream();
+    ensure_frame_time_metric();
+    registry.stream = fopen(path, "w");
+    if (!registry.stream) {
+        fprintf(stderr, "[ERROR] Unable to create the metrics stream '%s'\n", path);
+        return false;
+    }
+    const char* extension = strrchr(path, '.');
+    registry.stream_json = extension && strcmp(extension, ".json") == 0;
+    registry.stream_columns = 0;
+    registry.stream_frames = 0;
+    registry.frame_index = 0;
+    for (int i = 0; i < registry.metric_count; ++i) {
+        registry.metrics[i].stream_sum = 0.0;
+        registry.metrics[i].stream_max = 0.0;
+    }
+    printf("[INFO] Streaming frame metrics to '%s'\n", path);
+    return true;
+}
+
+void close_metrics_stream(void)
+{
+    if (!registry.stream) return;
+    if (registry.stream_json) {
+        if (registry.stream_columns == 0) write_stream_header();
+        // Whole run from the streamed rows; percentiles need the frames, so they only cover the rolling window
+        fprintf(registry.stream, "\n  ],\n  \"summary\": {\n    \"frames\": %lld", registry.stream_frames);
+        for (int i = 0; registry.stream_frames > 0 && i < registry.stream_columns; ++i) {
+            const Metric* metric = &registry.metrics[i];
+            fprintf(registry.stream, ",\n    \"%s\": {\"mean\": %.6g, \"max\": %.6g}", metric->name,
+                    metric->stream_sum / (double)registry.stream_frames, metric->stream_max);
+        }
+        fprintf(registry.stream, "\n  },\n  \"last_%d_frames\": {", METRICS_WINDOW_FRAMES);
+        bool first = true;
+        for (int i = 0; registry.stream_frames > 0 && i < registry.stream_columns; ++i) {
+            MetricSummary summary;
+            if (!get_metric_summary(i, &summary)) continue;
+            fprintf(registry.stream, "%s\n    \"%s\": {\"frames\": %d, \"mean\": %.6g, \"p50\": %.6g, \"p95\": %.6g, \"p99\": %.6g, \"max\": %.6g}",
+                    first ? "" : ",", registry.metrics[i].name, summary.samples, summary.mean, summary.p50, summary.p95,
+                    summary.p99, summary.max);
+            first = false;
+        }
+        fprintf(registry.stream, "\n  }\n}\n");
+    }
+    fclose(registry.stream);
+    registry.stream = NULL;
+}
+
+// --- Frames ---
+
+void end_metrics_frame(double frame_ms)
+{
+    ensure_frame_time_metric();
+    registry.metrics[METRIC_FRAME_TIME].value = frame_ms;
+    if (registry.stream) write_stream_row();
+
+    for (int i = 0; i < registry.metric_count; ++i) {
+        Metric* metric = &registry.metrics[i];
+        metric->window[registry.window_next] = (float)metric->value;
+        if (metric->kind == METRIC_COUNTER) metric->value = 0.0;
+    }
+    registry.window_next = (registry.window_next + 1) % METRICS_WINDOW_FRAMES;
+    if (registry.window_count < METRICS_WINDOW_FRAMES) registry.window_count++;
+    registry.frame_index++;
+}
+
+static int compare_floats(const void* a, const void* b)
+{
+    float fa = *(const float*)a, fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+bool get_metric_summary(int metric, MetricSummary* summary)
+{
+    if (metric < 0 || metric >= registry.metric_count || registry.window_count == 0 || !summary) return false;
+
+    float sorted[METRICS_WINDOW_FRAMES];
+    int count = registry.window_count;
+    const Metric* source = &registry.metrics[metric];
+    // Before the ring wraps the frames are at the start of it
+    memcpy(sorted, source->window, (size_t)count * sizeof(float));
+    summarize_samples(sorted, count, summary);
+
+    int last = (registry.window_next + METRICS_WINDOW_FRAMES - 1) % METRICS_WINDOW_FRAMES;
+    summary->last = source->window[last];
+    return true;
+}
+
+bool summarize_samples(float* values, int count, MetricSummary* summary)
+{
+    if (!values || count <= 0 || !summary) return false;
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) sum += values[i];
+    summary->last = values[count - 1];
+    qsort(values, (size_t)count, sizeof(float), compare_floats);
+
+    summary->mean = sum / count;
+    summary->p50 = values[count / 2];
+    summary->p95 = values[(int)(count * 0.95f)];
+    summary->p99 = values[(int)(count * 0.99f)];
+    summary->max = values[count - 1];
+    summary->samples = count;
+    return true;
+}
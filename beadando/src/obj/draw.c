@@ -3,6 +3,8 @@
 
 #include <glad/glad.h> // Need GL functions
 
+#include "render_stats.h"
+
 #include <stdio.h> // For errors or info
 
 void draw_model(const Model* model)
@@ -13,6 +15,7 @@ void draw_model(const Model* model)
     }
     // printf("DEBUG: draw_model - Binding VAO %u\n", model->vao_id);
     glBindVertexArray(model->vao_id);
+    count_vao_bind();
 
     // printf("DEBUG: draw_model - Calling glDrawElements (Count: %d)\n", model->index_count);
     glDrawElements(
@@ -21,12 +24,28 @@ void draw_model(const Model* model)
             GL_UNSIGNED_INT,
             NULL
     );
+    count_draw_call(1, model->index_count / 3);
 
     // printf("DEBUG: draw_model - Unbinding VAO\n");
     glBindVertexArray(0);
     // printf("DEBUG: draw_model - END\n");
 }
 
+void draw_model_instanced(const Model* model, const InstanceBuffer* instances, int first_instance, int count)
+{
+    if (!model || model->vao_id == 0 || model->index_count == 0 || !instances || count <= 0) {
+        return;
+    }
+    glBindVertexArray(model->vao_id);
+    count_vao_bind();
+    bind_instance_attributes(instances, first_instance);
+
+    glDrawElementsInstanced(GL_TRIANGLES, model->index_count, GL_UNSIGNED_INT, NULL, count);
+    count_draw_call(count, model->index_count / 3);
+
+    glBindVertexArray(0);
+}
+
 // This function might not be needed if draw_model handles everything
 void draw_triangles(const Model* model) {
     (void)model;
@@ -1,5 +1,6 @@
 #include <obj/load.h>
 #include <obj/model.h>
+#include "asset_pack.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -7,8 +8,8 @@
 #define LINE_BUFFER_SIZE 1024
 
 // Forward declarations for functions defined later in this file
-void count_elements(Model* model, FILE* file);
-int read_elements(Model* model, FILE* file);
+void count_elements(Model* model, const char* data, size_t size);
+int read_elements(Model* model, const char* data, size_t size);
 ElementType calc_element_type(const char* text);
 int read_vertex(Vertex* vertex, const char* text);
 int read_texture_vertex(TextureVertex* texture_vertex, const char* text);
@@ -17,10 +18,27 @@ int read_triangle(Triangle* triangle, const char* text);
 int is_numeric(char c);
 
 
+// Copies the next line (at most LINE_BUFFER_SIZE - 1 characters, like fgets) and advances the cursor.
+// Returns FALSE at the end of the data.
+static int next_line(const char** cursor, const char* end, char* line)
+{
+    if (*cursor >= end) return FALSE;
+
+    const char* line_end = memchr(*cursor, '\n', (size_t)(end - *cursor));
+    const char* next = line_end ? line_end + 1 : end;
+    size_t length = (size_t)(next - *cursor);
+    if (length > LINE_BUFFER_SIZE - 1) length = LINE_BUFFER_SIZE - 1;
+
+    memcpy(line, *cursor, length);
+    line[length] = '\0';
+    *cursor = next;
+    return TRUE;
+}
+
 // Corrected load_model function
 int load_model(Model* model, const char* filename)
 {
-    FILE* file = NULL;
+    AssetData asset;
     int allocation_success = FALSE;
     int read_success = FALSE;
 
@@ -28,21 +46,22 @@ int load_model(Model* model, const char* filename)
 
     init_model(model); // Initialize struct fields to 0/NULL
 
-    file = fopen(filename, "r");
-    if (file == NULL) {
+    // Parsed in place from the asset pack or the mapped loose file
+    if (!open_asset(filename, &asset)) {
         fprintf(stderr, "ERROR: Cannot open model file: '%s'\n", filename);
         return FALSE;
     }
+    const char* data = (const char*)asset.data;
 
     printf("DEBUG: load_model - Counting elements...\n");
-    count_elements(model, file); // This will read through the file
+    count_elements(model, data, asset.size); // This will read through the file
     printf("DEBUG: load_model - Elements counted (V=%d, VT=%d, VN=%d, F=%d)\n",
            model->n_vertices, model->n_texture_vertices, model->n_normals, model->n_triangles);
 
     // Check counts before allocating
     if(model->n_vertices == 0 || model->n_triangles == 0) {
         fprintf(stderr, "ERROR: Model file '%s' has no vertices or faces.\n", filename);
-        fclose(file);
+        close_asset(&asset);
         return FALSE;
     }
 
@@ -50,34 +69,33 @@ int load_model(Model* model, const char* filename)
     allocation_success = allocate_model(model); // Call allocate_model ONLY HERE
     if (!allocation_success) {
         fprintf(stderr, "ERROR: Failed to allocate memory during load_model.\n");
-        fclose(file);
+        close_asset(&asset);
         return FALSE;
     }
     printf("DEBUG: load_model - Memory allocated.\n");
 
-    // Reset file pointer to beginning for reading elements
-    rewind(file); // Go back to the start of the file
-
     printf("DEBUG: load_model - Reading elements...\n");
-    read_success = read_elements(model, file); // Read into the allocated memory
+    read_success = read_elements(model, data, asset.size); // Read into the allocated memory
     if (!read_success) {
         fprintf(stderr, "ERROR: Failed to read elements from model file.\n");
-        fclose(file);
+        close_asset(&asset);
         free_model(model); // Free allocated memory if reading fails
         return FALSE;
     }
     printf("DEBUG: load_model - Elements read.\n");
 
-    fclose(file); // Close the file on success
+    close_asset(&asset); // Close the file on success
     printf("DEBUG: load_model('%s') - SUCCESS\n", filename);
     return TRUE;
 }
 
 
 // count_elements: Reads file once to count items
-void count_elements(Model* model, FILE* file)
+void count_elements(Model* model, const char* data, size_t size)
 {
     char line[LINE_BUFFER_SIZE];
+    const char* cursor = data;
+    const char* end = data + size;
     printf("DEBUG: count_elements - START\n");
 
     // Reset counts (init_model already does this, but explicit reset here is ok)
@@ -86,7 +104,7 @@ void count_elements(Model* model, FILE* file)
     model->n_normals = 0;
     model->n_triangles = 0;
 
-    while (fgets(line, LINE_BUFFER_SIZE, file) != NULL) {
+    while (next_line(&cursor, end, line)) {
         switch (calc_element_type(line)) {
         case VERTEX:         model->n_vertices++;         break;
         case TEXTURE_VERTEX: model->n_texture_vertices++; break;
@@ -96,15 +114,15 @@ void count_elements(Model* model, FILE* file)
         }
     }
      printf("DEBUG: count_elements - END\n");
-     // No need to reset file pointer here, load_model will handle it
-     // fseek(file, original_pos, SEEK_SET);
 }
 
 
 // read_elements: Reads file again to fill allocated arrays
-int read_elements(Model* model, FILE* file)
+int read_elements(Model* model, const char* data, size_t size)
 {
     char line[LINE_BUFFER_SIZE];
+    const char* cursor = data;
+    const char* end = data + size;
     int vertex_index = 0;     // Start indices at 0
     int texture_index = 0;
     int normal_index = 0;
@@ -115,7 +133,7 @@ int read_elements(Model* model, FILE* file)
 
     // --- DO NOT allocate_model(model); HERE --- // REMOVED
 
-    while (fgets(line, LINE_BUFFER_SIZE, file) != NULL) {
+    while (next_line(&cursor, end, line)) {
         ElementType element_type = calc_element_type(line);
         switch (element_type) {
         case VERTEX:
@@ -260,55 +278,49 @@ int read_normal(Vertex* normal, const char* text)
 
 int read_triangle(Triangle* triangle, const char* text)
 {
-    // Expects "f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3" format
-    // Or other variations like v1//vn1 or v1/vt1 - this code assumes v/vt/vn
-    int items_read = sscanf(text, "f %d/%d/%d %d/%d/%d %d/%d/%d",
-                            &triangle->points[0].vertex_index,
-                            &triangle->points[0].texture_index,
-                            &triangle->points[0].normal_index,
-                            &triangle->points[1].vertex_index,
-                            &triangle->points[1].texture_index,
-                            &triangle->points[1].normal_index,
-                            &triangle->points[2].vertex_index,
-                            &triangle->points[2].texture_index,
-                            &triangle->points[2].normal_index
-                            );
-
-    if (items_read == 9) {
-        return TRUE;
-    } else {
-         // Add support for other face formats (v//vn, v/vt) if needed by parsing differently
-         fprintf(stderr, "ERROR: Failed to parse face line (expected v/vt/vn format): %s\n", text);
+    // Accepts "f v/vt/vn ...", "f v//vn ...", "f v/vt ..." and "f v ..." corners.
+    // Missing texture/normal indices are stored as INVALID_VERTEX_INDEX.
+    const char* cursor = text;
+    while (*cursor == ' ' || *cursor == '\t') { ++cursor; }
+    if (*cursor != 'f') {
+        fprintf(stderr, "ERROR: Failed to parse face line: %s\n", text);
         return FALSE;
     }
-     // Keep original manual parsing if preferred, but sscanf is less error-prone
-     /*
-     int point_index;
-     int i = 0;
-     // Skip 'f' and spaces
-     while (text[i] != 0 && text[i] != 'f') { ++i; }
-     ++i;
-     while (text[i] != 0 && (text[i] == ' ' || text[i] == '\t')) { ++i; }
-
-     for (point_index = 0; point_index < 3; ++point_index) {
-         if (text[i] == 0 || sscanf(&text[i], "%d", &triangle->points[point_index].vertex_index) != 1) return FALSE;
-         while (text[i] != 0 && text[i] != '/') { ++i; } // Move to '/' after vertex index
-         if (text[i] == 0) return FALSE; // Expected '/'
-         ++i; // Move past '/'
-
-         if (text[i] != '/') { // Check if texture index exists
-              if (text[i] == 0 || sscanf(&text[i], "%d", &triangle->points[point_index].texture_index) != 1) return FALSE;
-              while (text[i] != 0 && text[i] != '/') { ++i; } // Move to '/' after texture index
-         } else {
-              triangle->points[point_index].texture_index = INVALID_VERTEX_INDEX; // Or 0? Indicate missing.
-         }
-         if (text[i] == 0) return FALSE; // Expected '/'
-         ++i; // Move past '/'
-
-         if (text[i] == 0 || sscanf(&text[i], "%d", &triangle->points[point_index].normal_index) != 1) return FALSE;
-         while (text[i] != 0 && text[i] != ' ' && text[i] != '\t' && text[i] != '\n' && text[i] != '\r') { ++i; } // Move to next space/end
-          while (text[i] != 0 && (text[i] == ' ' || text[i] == '\t')) { ++i; } // Skip whitespace
-     }
-     return TRUE;
-     */
+    ++cursor;
+
+    for (int point_index = 0; point_index < 3; ++point_index) {
+        FacePoint* point = &triangle->points[point_index];
+        char* end = NULL;
+
+        point->vertex_index = (int)strtol(cursor, &end, 10);
+        if (end == cursor) {
+            fprintf(stderr, "ERROR: Failed to parse face line (expected 3 corners): %s\n", text);
+            return FALSE;
+        }
+        cursor = end;
+        point->texture_index = INVALID_VERTEX_INDEX;
+        point->normal_index = INVALID_VERTEX_INDEX;
+
+        if (*cursor == '/') {
+            ++cursor;
+            if (*cursor != '/') {
+                point->texture_index = (int)strtol(cursor, &end, 10);
+                if (end == cursor) {
+                    fprintf(stderr, "ERROR: Failed to parse face line (bad texture index): %s\n", text);
+                    return FALSE;
+                }
+                cursor = end;
+            }
+            if (*cursor == '/') {
+                ++cursor;
+                point->normal_index = (int)strtol(cursor, &end, 10);
+                if (end == cursor) {
+                    fprintf(stderr, "ERROR: Failed to parse face line (bad normal index): %s\n", text);
+                    return FALSE;
+                }
+                cursor = end;
+            }
+        }
+    }
+    return TRUE;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <stdlib.h> // For malloc, free
 #include <string.h> // For memcpy, NULL
+#include <stddef.h> // For offsetof
+#include <math.h>   // For sqrtf
 
 // Include GLAD for OpenGL functions
 #include <glad/glad.h>
@@ -18,6 +20,7 @@ void init_model(Model* model)
     model->texture_vertices = NULL;
     model->normals = NULL;
     model->triangles = NULL;
+    model->storage = NULL;
     model->vao_id = 0;
     model->vbo_id = 0;
     model->ibo_id = 0;
@@ -28,41 +31,29 @@ int allocate_model(Model* model)
 {
     printf("DEBUG: allocate_model - START (Requesting V=%d, VT=%d, VN=%d, F=%d)\n",
         model->n_vertices, model->n_texture_vertices, model->n_normals, model->n_triangles);
-    if (model->n_vertices > 0) {
-        model->vertices = (Vertex*)malloc(model->n_vertices * sizeof(Vertex));
-        if (model->vertices == NULL) {
-            fprintf(stderr, "ERROR: Failed to allocate memory for vertices.\n");
-            return FALSE;
-        }
-    }
-    if (model->n_texture_vertices > 0) {
-        model->texture_vertices = (TextureVertex*)malloc(model->n_texture_vertices * sizeof(TextureVertex));
-         if (model->texture_vertices == NULL) {
-            fprintf(stderr, "ERROR: Failed to allocate memory for texture vertices.\n");
-            // Free previously allocated memory before returning
-            free(model->vertices); model->vertices = NULL;
-            return FALSE;
-        }
-    }
-    if (model->n_normals > 0) {
-        model->normals = (Vertex*)malloc(model->n_normals * sizeof(Vertex));
-         if (model->normals == NULL) {
-            fprintf(stderr, "ERROR: Failed to allocate memory for normals.\n");
-            free(model->vertices); model->vertices = NULL;
-            free(model->texture_vertices); model->texture_vertices = NULL;
-            return FALSE;
-        }
-    }
-    if (model->n_triangles > 0) {
-        model->triangles = (Triangle*)malloc(model->n_triangles * sizeof(Triangle));
-         if (model->triangles == NULL) {
-            fprintf(stderr, "ERROR: Failed to allocate memory for triangles.\n");
-            free(model->vertices); model->vertices = NULL;
-            free(model->texture_vertices); model->texture_vertices = NULL;
-            free(model->normals); model->normals = NULL;
-            return FALSE;
-        }
+
+    // Doubles first, the int triangles last, so every array stays aligned without padding
+    size_t vertices_size = (size_t)model->n_vertices * sizeof(Vertex);
+    size_t texture_vertices_size = (size_t)model->n_texture_vertices * sizeof(TextureVertex);
+    size_t normals_size = (size_t)model->n_normals * sizeof(Vertex);
+    size_t triangles_size = (size_t)model->n_triangles * sizeof(Triangle);
+    size_t total_size = vertices_size + texture_vertices_size + normals_size + triangles_size;
+    if (total_size == 0) return TRUE;
+
+    unsigned char* block = (unsigned char*)malloc(total_size);
+    if (block == NULL) {
+        fprintf(stderr, "ERROR: Failed to allocate memory for the model (%lu bytes).\n", (unsigned long)total_size);
+        return FALSE;
     }
+    model->storage = block;
+    model->vertices = model->n_vertices > 0 ? (Vertex*)block : NULL;
+    block += vertices_size;
+    model->texture_vertices = model->n_texture_vertices > 0 ? (TextureVertex*)block : NULL;
+    block += texture_vertices_size;
+    model->normals = model->n_normals > 0 ? (Vertex*)block : NULL;
+    block += normals_size;
+    model->triangles = model->n_triangles > 0 ? (Triangle*)block : NULL;
+
     printf("[INFO] Model memory allocated: V=%d, VT=%d, VN=%d, F=%d\n",
         model->n_vertices, model->n_texture_vertices, model->n_normals, model->n_triangles);
     return TRUE;
@@ -72,10 +63,7 @@ void free_model(Model* model)
 {
     if (model == NULL) return;
 
-    free(model->vertices);
-    free(model->texture_vertices);
-    free(model->normals);
-    free(model->triangles);
+    free(model->storage);
 
     // Reset model state after freeing
     init_model(model);
@@ -85,30 +73,58 @@ void free_model(Model* model)
 
 // --- VBO/VAO/IBO Setup ---
 
-// Define a structure for the interleaved vertex data we will send to the GPU
-// Using floats as preferred by OpenGL
-typedef struct VertexData {
-    float position[3];
-    float normal[3];
-    float tex_coord[2];
-} VertexData;
+void compute_triangle_normal(const float a[3], const float b[3], const float c[3], float normal[3]) {
+    float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+    normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+    normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+
+    float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    if (length > 1e-12f) {
+        normal[0] /= length;
+        normal[1] /= length;
+        normal[2] /= length;
+    } else {
+        // Degenerate triangle, default to up
+        normal[0] = 0.0f;
+        normal[1] = 1.0f;
+        normal[2] = 0.0f;
+    }
+}
 
+void compute_vertex_bounds(const VertexData* vertices, GLsizei vertex_count, float bounds_min[3], float bounds_max[3]) {
+    for (int k = 0; k < 3; ++k) {
+        bounds_min[k] = 0.0f;
+        bounds_max[k] = 0.0f;
+    }
+    if (!vertices || vertex_count <= 0) return;
 
-void setup_model_buffers(Model* model) {
-    printf("DEBUG: setup_model_buffers - START\n");
-    if (!model || !model->triangles || model->n_triangles == 0 || !model->vertices) {
-        fprintf(stderr, "ERROR: Cannot setup model buffers - model data missing or empty.\n");
-        return;
+    for (int k = 0; k < 3; ++k) {
+        bounds_min[k] = vertices[0].position[k];
+        bounds_max[k] = vertices[0].position[k];
     }
+    for (GLsizei i = 1; i < vertex_count; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            if (vertices[i].position[k] < bounds_min[k]) bounds_min[k] = vertices[i].position[k];
+            if (vertices[i].position[k] > bounds_max[k]) bounds_max[k] = vertices[i].position[k];
+        }
+    }
+}
 
-    // --- 1. Prepare data for buffers ---
-    // We need to potentially combine data from the separate arrays loaded from the OBJ
-    // into a single interleaved VBO and create an index buffer (IBO/EBO).
+int build_model_vertex_data(const Model* model, VertexData** vertex_data, GLuint** index_data, GLsizei* index_count) {
+    if (!model || !model->triangles || model->n_triangles == 0 || !model->vertices ||
+        !vertex_data || !index_data || !index_count) {
+        fprintf(stderr, "ERROR: Cannot build model vertex data - model data missing or empty.\n");
+        return FALSE;
+    }
+
+    // We need to combine data from the separate arrays loaded from the OBJ
+    // into a single interleaved vertex array and an index array.
 
     // Calculate the number of unique face points (indices) needed.
     // This is simply the number of corners in all triangles.
     GLsizei num_indices = model->n_triangles * 3;
-    model->index_count = num_indices; // Store for drawing
 
     // Allocate memory for vertex data and index data
     VertexData* vertex_buffer_data = (VertexData*)malloc(num_indices * sizeof(VertexData));
@@ -118,7 +134,7 @@ void setup_model_buffers(Model* model) {
         fprintf(stderr, "ERROR: Failed to allocate memory for buffer setup.\n");
         free(vertex_buffer_data); // free if allocated
         free(index_buffer_data);  // free if allocated
-        return;
+        return FALSE;
     }
 
     // Populate the buffers by iterating through the triangles
@@ -129,19 +145,18 @@ void setup_model_buffers(Model* model) {
 
             // --- Index Validation ---
             if (fp.vertex_index <= 0 || fp.vertex_index > model->n_vertices) {
-                fprintf(stderr, "ERROR: setup_model_buffers - Invalid vertex index %d in face %d point %d.\n", fp.vertex_index, i, j);
-                // Handle error: free allocated buffers and return?
+                fprintf(stderr, "ERROR: build_model_vertex_data - Invalid vertex index %d in face %d point %d.\n", fp.vertex_index, i, j);
                 free(vertex_buffer_data);
                 free(index_buffer_data);
-                return;
+                return FALSE;
             }
-            if (model->texture_vertices && (fp.texture_index <= 0 || fp.texture_index > model->n_texture_vertices)) {
-                fprintf(stderr, "ERROR: setup_model_buffers - Invalid texture index %d in face %d point %d.\n", fp.texture_index, i, j);
-                free(vertex_buffer_data); free(index_buffer_data); return;
+            if (fp.texture_index != INVALID_VERTEX_INDEX && (fp.texture_index < 0 || fp.texture_index > model->n_texture_vertices)) {
+                fprintf(stderr, "ERROR: build_model_vertex_data - Invalid texture index %d in face %d point %d.\n", fp.texture_index, i, j);
+                free(vertex_buffer_data); free(index_buffer_data); return FALSE;
             }
-            if (model->normals && (fp.normal_index <= 0 || fp.normal_index > model->n_normals)) {
-                fprintf(stderr, "ERROR: setup_model_buffers - Invalid normal index %d in face %d point %d.\n", fp.normal_index, i, j);
-                free(vertex_buffer_data); free(index_buffer_data); return;
+            if (fp.normal_index != INVALID_VERTEX_INDEX && (fp.normal_index < 0 || fp.normal_index > model->n_normals)) {
+                fprintf(stderr, "ERROR: build_model_vertex_data - Invalid normal index %d in face %d point %d.\n", fp.normal_index, i, j);
+                free(vertex_buffer_data); free(index_buffer_data); return FALSE;
             }
             // --- End Index Validation ---
 
@@ -175,6 +190,41 @@ void setup_model_buffers(Model* model) {
         }
     }
 
+    // Faces without normals get flat face normals instead of a constant {0,0,1}
+    // (the asset cooker replaces them with smoothed ones, see tools/mesh_cook.c)
+    for (int i = 0; i < model->n_triangles; ++i) {
+        const Triangle* triangle = &model->triangles[i];
+        if (model->normals && triangle->points[0].normal_index > 0 &&
+            triangle->points[1].normal_index > 0 && triangle->points[2].normal_index > 0) {
+            continue;
+        }
+        float normal[3];
+        VertexData* corners = &vertex_buffer_data[i * 3];
+        compute_triangle_normal(corners[0].position, corners[1].position, corners[2].position, normal);
+        for (int j = 0; j < 3; ++j) {
+            memcpy(corners[j].normal, normal, sizeof(normal));
+        }
+    }
+
+    *vertex_data = vertex_buffer_data;
+    *index_data = index_buffer_data;
+    *index_count = num_indices;
+    return TRUE;
+}
+
+void setup_model_buffers(Model* model) {
+    printf("DEBUG: setup_model_buffers - START\n");
+
+    // --- 1. Prepare data for buffers ---
+    VertexData* vertex_buffer_data = NULL;
+    GLuint* index_buffer_data = NULL;
+    GLsizei num_indices = 0;
+    if (!build_model_vertex_data(model, &vertex_buffer_data, &index_buffer_data, &num_indices)) {
+        fprintf(stderr, "ERROR: Cannot setup model buffers - model data missing or empty.\n");
+        return;
+    }
+    model->index_count = num_indices; // Store for drawing
+
     // --- 2. Create and Bind VAO ---
     glGenVertexArrays(1, &model->vao_id);
     glBindVertexArray(model->vao_id);
@@ -0,0 +1,260 @@
+#include "particles.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARTICLE_ARRAY_COUNT 9 // Float arrays of a pool, see ParticlePool
+
+/**
+ * Look of a particle type.
+ */
+typedef struct ParticleTypeInfo
+{
+    float speed_min, speed_max;
+    float lifetime_min, lifetime_max;
+    float size; // Half size of the billboard
+    float gravity;
+    float drag; // Fraction of the velocity lost per second
+    bool upward; // Emit into the upper hemisphere only
+    vec4 start_color;
+    vec4 end_color;
+} ParticleTypeInfo;
+
+static const ParticleTypeInfo particle_types[NUM_PARTICLE_TYPES] = {
+    [PARTICLE_HIT_SPARK] = {
+        2.0f, 4.5f, 0.25f, 0.55f, 0.05f, -9.8f, 1.5f, true,
+        {1.0f, 0.85f, 0.4f, 1.0f}, {1.0f, 0.3f, 0.05f, 0.0f}
+    },
+    [PARTICLE_DEATH_BURST] = {
+        0.5f, 2.0f, 0.7f, 1.4f, 0.09f, 0.8f, 2.0f, false,
+        {1.0f, 0.25f, 0.15f, 0.9f}, {0.2f, 0.05f, 0.05f, 0.0f}
+    }
+};
+
+// --- Random numbers (xorshift32) ---
+
+static float random_float(unsigned int* state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (float)(x >> 8) / 16777216.0f; // [0, 1)
+}
+
+static float random_range(unsigned int* state, float min, float max)
+{
+    return min + (max - min) * random_float(state);
+}
+
+// --- Pools ---
+
+static bool init_pool(ParticlePool* pool)
+{
+    memset(pool, 0, sizeof(ParticlePool));
+    // One allocation per pool; the capacity is a multiple of 4, so every array stays 16-byte aligned
+    float* block = (float*)malloc((size_t)PARTICLE_ARRAY_COUNT * MAX_PARTICLES_PER_POOL * sizeof(float));
+    if (!block) return false;
+
+    float** arrays[PARTICLE_ARRAY_COUNT] = {
+        &pool->position_x, &pool->position_y, &pool->position_z,
+        &pool->velocity_x, &pool->velocity_y, &pool->velocity_z,
+        &pool->age, &pool->lifetime, &pool->size
+    };
+    for (int i = 0; i < PARTICLE_ARRAY_COUNT; ++i) {
+        *arrays[i] = block + (size_t)i * MAX_PARTICLES_PER_POOL;
+    }
+    return true;
+}
+
+static void destroy_pool(ParticlePool* pool)
+{
+    free(pool->position_x); // Start of the block
+    memset(pool, 0, sizeof(ParticlePool));
+}
+
+static void integrate_pool(ParticlePool* pool, const ParticleTypeInfo* info, float dt)
+{
+    float* restrict position_x = pool->position_x;
+    float* restrict position_y = pool->position_y;
+    float* restrict position_z = pool->position_z;
+    float* restrict velocity_x = pool->velocity_x;
+    float* restrict velocity_y = pool->velocity_y;
+    float* restrict velocity_z = pool->velocity_z;
+    float* restrict age = pool->age;
+    const int count = pool->count;
+    const float damping = fmaxf(1.0f - info->drag * dt, 0.0f);
+    const float gravity = info->gravity * dt;
+
+    // Straight-line loop over plain float arrays, the compiler vectorizes it
+    for (int i = 0; i < count; ++i) {
+        velocity_x[i] *= damping;
+        velocity_y[i] = velocity_y[i] * damping + gravity;
+        velocity_z[i] *= damping;
+        position_x[i] += velocity_x[i] * dt;
+        position_y[i] = fmaxf(position_y[i] + velocity_y[i] * dt, 0.0f); // Rest on the board
+        position_z[i] += velocity_z[i] * dt;
+        age[i] += dt;
+    }
+
+    // Swap-remove the expired particles
+    float* arrays[PARTICLE_ARRAY_COUNT] = {
+        pool->position_x, pool->position_y, pool->position_z,
+        pool->velocity_x, pool->velocity_y, pool->velocity_z,
+        pool->age, pool->lifetime, pool->size
+    };
+    for (int i = 0; i < pool->count;) {
+        if (pool->age[i] < pool->lifetime[i]) {
+            ++i;
+            continue;
+        }
+        int last = --pool->count;
+        for (int a = 0; a < PARTICLE_ARRAY_COUNT; ++a) arrays[a][i] = arrays[a][last];
+    }
+}
+
+// --- Public API ---
+
+bool init_particle_system(ParticleSystem* system)
+{
+    if (!system) return false;
+    memset(system, 0, sizeof(ParticleSystem));
+    system->random_state = 0x9E3779B9u;
+
+    for (int type = 0; type < NUM_PARTICLE_TYPES; ++type) {
+        if (!init_pool(&system->pools[type])) {
+            fprintf(stderr, "ERROR: init_particle_system - Out of memory\n");
+            destroy_particle_system(system);
+            return false;
+        }
+    }
+
+    // The quad corners come from gl_VertexID, so the VAO only holds the instance stream
+    glGenVertexArrays(1, &system->vao_id);
+    glGenBuffers(1, &system->instance_vbo_id);
+    glBindVertexArray(system->vao_id);
+    glBindBuffer(GL_ARRAY_BUFFER, system->instance_vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)NUM_PARTICLE_TYPES * MAX_PARTICLES_PER_POOL * sizeof(ParticleInstance), NULL, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, position_size));
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, color));
+    glVertexAttribDivisor(1, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("init_particle_system");
+
+    printf("[INFO] Particle system created: %d types x %d particles\n", NUM_PARTICLE_TYPES, MAX_PARTICLES_PER_POOL);
+    return true;
+}
+
+void destroy_particle_system(ParticleSystem* system)
+{
+    if (!system) return;
+    for (int type = 0; type < NUM_PARTICLE_TYPES; ++type) {
+        destroy_pool(&system->pools[type]);
+    }
+    if (system->instance_vbo_id != 0) glDeleteBuffers(1, &system->instance_vbo_id);
+    if (system->vao_id != 0) glDeleteVertexArrays(1, &system->vao_id);
+    system->instance_vbo_id = 0;
+    system->vao_id = 0;
+}
+
+void emit_particles(ParticleSystem* system, ParticleType type, const vec3 position, int count)
+{
+    if (!system || type < 0 || type >= NUM_PARTICLE_TYPES) return;
+    ParticlePool* pool = &system->pools[type];
+    if (!pool->position_x) return;
+    const ParticleTypeInfo* info = &particle_types[type];
+
+    if (count > MAX_PARTICLES_PER_POOL - pool->count) count = MAX_PARTICLES_PER_POOL - pool->count;
+    for (int n = 0; n < count; ++n) {
+        int i = pool->count++;
+
+        // Uniform direction on the sphere
+        float z = random_range(&system->random_state, -1.0f, 1.0f);
+        float angle = random_range(&system->random_state, 0.0f, 2.0f * GLM_PIf);
+        float ring = sqrtf(1.0f - z * z);
+        float speed = random_range(&system->random_state, info->speed_min, info->speed_max);
+        float up = info->upward ? fabsf(z) : z;
+
+        pool->position_x[i] = position[0];
+        pool->position_y[i] = position[1];
+        pool->position_z[i] = position[2];
+        pool->velocity_x[i] = ring * cosf(angle) * speed;
+        pool->velocity_y[i] = up * speed;
+        pool->velocity_z[i] = ring * sinf(angle) * speed;
+        pool->age[i] = 0.0f;
+        pool->lifetime[i] = random_range(&system->random_state, info->lifetime_min, info->lifetime_max);
+        pool->size[i] = info->size * random_range(&system->random_state, 0.7f, 1.3f);
+    }
+}
+
+void update_particle_system(ParticleSystem* system, float dt)
+{
+    if (!system) return;
+    for (int type = 0; type < NUM_PARTICLE_TYPES; ++type) {
+        if (system->pools[type].count > 0) integrate_pool(&system->pools[type], &particle_types[type], dt);
+    }
+}
+
+int get_particle_count(const ParticleSystem* system)
+{
+    int count = 0;
+    for (int type = 0; type < NUM_PARTICLE_TYPES; ++type) count += system->pools[type].count;
+    return count;
+}
+
+int build_particle_instances(const ParticleSystem* system, ParticleInstance* instances)
+{
+    int instance_count = 0;
+    for (int type = 0; type < NUM_PARTICLE_TYPES; ++type) {
+        const ParticlePool* pool = &system->pools[type];
+        const ParticleTypeInfo* info = &particle_types[type];
+        for (int i = 0; i < pool->count; ++i) {
+            ParticleInstance* instance = &instances[instance_count++];
+            float t = pool->age[i] / pool->lifetime[i];
+            instance->position_size[0] = pool->position_x[i];
+            instance->position_size[1] = pool->position_y[i];
+            instance->position_size[2] = pool->position_z[i];
+            instance->position_size[3] = pool->size[i];
+            glm_vec4_lerp((float*)info->start_color, (float*)info->end_color, t, instance->color);
+        }
+    }
+    return instance_count;
+}
+
+void render_particle_system(ParticleSystem* system, ShaderManager* shaders, int particle_shader,
+                            const ParticleInstance* instances, int instance_count)
+{
+    if (!system || system->vao_id == 0) return;
+    count_particles(instance_count);
+    if (instance_count == 0) return;
+
+    const ShaderVariant* variant = use_shader_variant(shaders, particle_shader, 0);
+    if (!variant) return;
+
+    // Orphan the buffer so the upload does not wait for the previous frame's draw
+    glBindBuffer(GL_ARRAY_BUFFER, system->instance_vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)NUM_PARTICLE_TYPES * MAX_PARTICLES_PER_POOL * sizeof(ParticleInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)instance_count * sizeof(ParticleInstance), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glDepthMask(GL_FALSE);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive, so the draw order does not matter
+    glBindVertexArray(system->vao_id);
+    count_vao_bind();
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instance_count);
+    count_draw_call(instance_count, 2);
+    glBindVertexArray(0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_TRUE);
+    check_gl_error("render_particle_system");
+}
@@ -0,0 +1,149 @@
+#include "point_lights.h"
+#include "board.h"
+#include "render_stats.h"
+#include "shader_manager.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+void init_point_lights(PointLightList* list)
+{
+    if (!list) return;
+    memset(list, 0, sizeof(PointLightList));
+
+    glGenBuffers(1, &list->uniform_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, list->uniform_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(PointLightUniforms), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_BLOCK_POINT_LIGHTS, list->uniform_buffer);
+    check_gl_error("init_point_lights");
+    printf("[INFO] Point light buffer created: UBO=%u, Size=%d, Capacity=%d\n",
+           list->uniform_buffer, (int)sizeof(PointLightUniforms), MAX_POINT_LIGHTS);
+}
+
+void destroy_point_lights(PointLightList* list)
+{
+    if (!list) return;
+    if (list->uniform_buffer != 0) {
+        glDeleteBuffers(1, &list->uniform_buffer);
+        list->uniform_buffer = 0;
+    }
+    list->count = 0;
+}
+
+void spawn_point_light(PointLightList* list, const vec3 position, const vec3 color, float radius, float lifetime)
+{
+    if (!list || lifetime <= 0.0f || radius <= 0.0f) return;
+
+    PointLight* light;
+    if (list->count < MAX_POINT_LIGHTS) {
+        light = &list->lights[list->count++];
+    } else {
+        light = &list->lights[0]; // Oldest has the largest age fraction, look for it
+        for (int i = 1; i < list->count; ++i) {
+            if (list->lights[i].age / list->lights[i].lifetime > light->age / light->lifetime) light = &list->lights[i];
+        }
+    }
+    glm_vec3_copy((float*)position, light->position);
+    glm_vec3_copy((float*)color, light->color);
+    light->radius = radius;
+    light->intensity = 1.0f;
+    light->age = 0.0f;
+    light->lifetime = lifetime;
+}
+
+void update_point_lights(PointLightList* list, float dt)
+{
+    if (!list) return;
+    for (int i = 0; i < list->count;) {
+        PointLight* light = &list->lights[i];
+        light->age += dt;
+        if (light->age >= light->lifetime) {
+            *light = list->lights[--list->count]; // Order does not matter
+            continue;
+        }
+        light->intensity = 1.0f - light->age / light->lifetime;
+        ++i;
+    }
+}
+
+static void get_cell_range(float center, float radius, float origin, float cell_size, int* first, int* last)
+{
+    *first = (int)floorf((center - radius - origin) / cell_size);
+    *last = (int)floorf((center + radius - origin) / cell_size);
+    if (*first < 0) *first = 0;
+    if (*last > LIGHT_GRID_SIZE - 1) *last = LIGHT_GRID_SIZE - 1;
+}
+
+int bin_point_lights(PointLightList* list, const PointLight* lights, int light_count)
+{
+    if (!list || list->uniform_buffer == 0) return 0;
+
+    PointLightUniforms* uniforms = &list->uniforms;
+    float cell_size_x = (BOARD_GRID_WIDTH * BOARD_TILE_SIZE) / LIGHT_GRID_SIZE;
+    float cell_size_z = (BOARD_GRID_HEIGHT * BOARD_TILE_SIZE) / LIGHT_GRID_SIZE;
+    glm_vec4_copy((vec4){0.0f, 0.0f, cell_size_x, cell_size_z}, uniforms->grid);
+    uniforms->light_count = light_count;
+
+    // Pass 1: count the lights overlapping each cell (square bounds of the light sphere)
+    int cell_counts[LIGHT_GRID_CELLS] = {0};
+    for (int i = 0; i < light_count; ++i) {
+        const PointLight* light = &lights[i];
+        glm_vec4((float*)light->position, light->radius, uniforms->lights[2 * i]);
+        glm_vec3_scale((float*)light->color, light->intensity, uniforms->lights[2 * i + 1]);
+        uniforms->lights[2 * i + 1][3] = 0.0f;
+
+        int first_x, last_x, first_z, last_z;
+        get_cell_range(light->position[0], light->radius, uniforms->grid[0], cell_size_x, &first_x, &last_x);
+        get_cell_range(light->position[2], light->radius, uniforms->grid[1], cell_size_z, &first_z, &last_z);
+        for (int z = first_z; z <= last_z; ++z) {
+            for (int x = first_x; x <= last_x; ++x) {
+                int* count = &cell_counts[z * LIGHT_GRID_SIZE + x];
+                if (*count < MAX_LIGHTS_PER_CELL) (*count)++;
+            }
+        }
+    }
+
+    // Offsets of the cells in the index list
+    int index_count = 0;
+    for (int cell = 0; cell < LIGHT_GRID_CELLS; ++cell) {
+        int count = cell_counts[cell];
+        if (index_count + count > MAX_LIGHT_INDICES) count = MAX_LIGHT_INDICES - index_count;
+        uniforms->cells[cell][0] = index_count;
+        uniforms->cells[cell][1] = 0; // Filled in pass 2
+        cell_counts[cell] = count;
+        index_count += count;
+    }
+
+    // Pass 2: write the light indices
+    int* indices = &uniforms->indices[0][0];
+    for (int i = 0; i < light_count; ++i) {
+        const PointLight* light = &lights[i];
+        int first_x, last_x, first_z, last_z;
+        get_cell_range(light->position[0], light->radius, uniforms->grid[0], cell_size_x, &first_x, &last_x);
+        get_cell_range(light->position[2], light->radius, uniforms->grid[1], cell_size_z, &first_z, &last_z);
+        for (int z = first_z; z <= last_z; ++z) {
+            for (int x = first_x; x <= last_x; ++x) {
+                int cell = z * LIGHT_GRID_SIZE + x;
+                if (uniforms->cells[cell][1] >= cell_counts[cell]) continue; // Cell is full
+                indices[uniforms->cells[cell][0] + uniforms->cells[cell][1]++] = i;
+            }
+        }
+    }
+    uniforms->index_count = index_count;
+    count_point_lights(light_count, index_count);
+    if (index_count == 0) return 0;
+
+    // Only the used part of the light and index arrays is uploaded
+    glBindBuffer(GL_UNIFORM_BUFFER, list->uniform_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, offsetof(PointLightUniforms, lights) + (size_t)light_count * 2 * sizeof(vec4), uniforms);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(PointLightUniforms, cells),
+                    sizeof(uniforms->cells) + ((size_t)index_count + 3) / 4 * sizeof(uniforms->indices[0]), uniforms->cells);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    count_uniform_upload();
+    check_gl_error("bin_point_lights");
+    return index_count;
+}
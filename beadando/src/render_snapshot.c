@@ -0,0 +1,107 @@
+#include "render_snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool init_render_snapshots(RenderSnapshotBuffer* buffer)
+{
+    if (!buffer) return false;
+    memset(buffer, 0, sizeof(RenderSnapshotBuffer));
+    buffer->latest = -1;
+    buffer->reading = -1;
+    buffer->writing = -1;
+
+    buffer->snapshots = (RenderSnapshot*)calloc(RENDER_SNAPSHOT_COUNT, sizeof(RenderSnapshot));
+    if (!buffer->snapshots) {
+        fprintf(stderr, "ERROR: init_render_snapshots - Out of memory\n");
+        return false;
+    }
+    size_t arena_capacity = (size_t)MAX_PARTICLE_INSTANCES * sizeof(ParticleInstance) + ARENA_ALIGNMENT;
+    for (int i = 0; i < RENDER_SNAPSHOT_COUNT; ++i) {
+        if (!init_arena(&buffer->snapshots[i].arena, "render snapshot", arena_capacity)) {
+            destroy_render_snapshots(buffer);
+            return false;
+        }
+    }
+    return true;
+}
+
+void destroy_render_snapshots(RenderSnapshotBuffer* buffer)
+{
+    if (!buffer) return;
+    if (buffer->snapshots) {
+        for (int i = 0; i < RENDER_SNAPSHOT_COUNT; ++i) {
+            destroy_arena(&buffer->snapshots[i].arena);
+        }
+        free(buffer->snapshots);
+    }
+    memset(buffer, 0, sizeof(RenderSnapshotBuffer));
+    buffer->latest = -1;
+    buffer->reading = -1;
+    buffer->writing = -1;
+}
+
+RenderSnapshot* begin_snapshot_write(RenderSnapshotBuffer* buffer)
+{
+    if (!buffer || !buffer->snapshots) return NULL;
+    for (int i = 0; i < RENDER_SNAPSHOT_COUNT; ++i) {
+        if (i != buffer->latest && i != buffer->reading) {
+            buffer->writing = i;
+            buffer->snapshots[i].sequence = ++buffer->sequence;
+            return &buffer->snapshots[i];
+        }
+    }
+    return NULL; // Unreachable with three slots
+}
+
+void capture_render_snapshot(RenderSnapshot* snapshot, Scene* scene)
+{
+    if (!snapshot || !scene) return;
+
+    snapshot->time = scene->time;
+    snapshot->unit_count = scene->unit_count;
+    memcpy(snapshot->units, scene->units, (size_t)scene->unit_count * sizeof(Unit));
+
+    // Board units grouped by type, so each type is one batch of the instanced draw
+    int instance_count = 0;
+    for (int type = 0; type < NUM_UNIT_TYPES; ++type) {
+        snapshot->unit_first[type] = instance_count;
+        for (int i = 0; i < scene->unit_count; ++i) {
+            Unit* unit = &scene->units[i];
+            if (unit->type != type || unit->location != LOC_BOARD) continue;
+            // Dead units stay until their death animation has played
+            if (!unit->is_alive && (unit->animation != UNIT_ANIM_DEATH ||
+                                    scene->time - unit->animation_start >= UNIT_DEATH_DURATION)) continue;
+            fill_unit_instance(unit, scene, &snapshot->unit_instances[instance_count++]);
+        }
+        snapshot->unit_instance_count[type] = instance_count - snapshot->unit_first[type];
+    }
+
+    snapshot->point_light_count = scene->point_lights.count;
+    memcpy(snapshot->point_lights, scene->point_lights.lights, (size_t)scene->point_lights.count * sizeof(PointLight));
+    snapshot->combat_text_count = scene->combat_text.count;
+    memcpy(snapshot->combat_texts, scene->combat_text.texts, (size_t)scene->combat_text.count * sizeof(CombatText));
+
+    reset_arena(&snapshot->arena);
+    snapshot->particle_count = 0;
+    snapshot->particles = (ParticleInstance*)arena_alloc(&snapshot->arena,
+                                                         (size_t)get_particle_count(&scene->particles) * sizeof(ParticleInstance));
+    if (snapshot->particles) {
+        snapshot->particle_count = build_particle_instances(&scene->particles, snapshot->particles);
+    }
+}
+
+void publish_snapshot(RenderSnapshotBuffer* buffer)
+{
+    if (!buffer || buffer->writing < 0) return;
+    buffer->latest = buffer->writing;
+    buffer->writing = -1;
+}
+
+const RenderSnapshot* acquire_render_snapshot(RenderSnapshotBuffer* buffer)
+{
+    if (!buffer || buffer->latest < 0) return NULL;
+    buffer->reading = buffer->latest;
+    return &buffer->snapshots[buffer->reading];
+}
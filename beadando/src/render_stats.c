@@ -0,0 +1,99 @@
+#include "render_stats.h"
+#include "metrics.h"
+
+#include <string.h>
+
+static RenderStats frame_stats; // View of the registry metrics, filled by get_render_stats
+
+// Handles in the metrics registry (see metrics.h), -1 until init_render_stats
+static int draw_calls_metric = -1;
+static int indirect_commands_metric = -1;
+static int instances_metric = -1;
+static int triangles_metric = -1;
+static int texture_binds_metric = -1;
+static int vao_binds_metric = -1;
+static int uniform_uploads_metric = -1;
+static int shadow_layers_metric = -1;
+static int point_lights_metric = -1;
+static int point_light_references_metric = -1;
+static int particles_metric = -1;
+static int shadow_cache_hit_rate_metric = -1;
+
+// Since startup, kept across frames
+static long long shadow_cache_lookups;
+static long long shadow_cache_hits;
+
+void init_render_stats(void) {
+    draw_calls_metric = register_metric("draw_calls", METRIC_COUNTER);
+    indirect_commands_metric = register_metric("indirect_commands", METRIC_COUNTER);
+    instances_metric = register_metric("instances", METRIC_COUNTER);
+    triangles_metric = register_metric("triangles", METRIC_COUNTER);
+    texture_binds_metric = register_metric("texture_binds", METRIC_COUNTER);
+    vao_binds_metric = register_metric("vao_binds", METRIC_COUNTER);
+    uniform_uploads_metric = register_metric("uniform_uploads", METRIC_COUNTER);
+    shadow_layers_metric = register_metric("shadow_layers", METRIC_COUNTER);
+    point_lights_metric = register_metric("point_lights", METRIC_GAUGE);
+    point_light_references_metric = register_metric("point_light_refs", METRIC_GAUGE);
+    particles_metric = register_metric("particles", METRIC_GAUGE);
+    shadow_cache_hit_rate_metric = register_metric("shadow_cache_hit_rate", METRIC_GAUGE);
+}
+
+void count_draw_call(int instance_count, int triangles_per_instance) {
+    add_metric(draw_calls_metric, 1.0);
+    add_metric(instances_metric, instance_count);
+    add_metric(triangles_metric, (double)instance_count * triangles_per_instance);
+}
+
+void count_indirect_command(int instance_count, int triangles_per_instance) {
+    add_metric(indirect_commands_metric, 1.0);
+    add_metric(instances_metric, instance_count);
+    add_metric(triangles_metric, (double)instance_count * triangles_per_instance);
+}
+
+void count_texture_bind(void) {
+    add_metric(texture_binds_metric, 1.0);
+}
+
+void count_vao_bind(void) {
+    add_metric(vao_binds_metric, 1.0);
+}
+
+void count_uniform_upload(void) {
+    add_metric(uniform_uploads_metric, 1.0);
+}
+
+void count_shadow_cache_lookup(bool hit) {
+    shadow_cache_lookups++;
+    if (hit) shadow_cache_hits++;
+    set_metric(shadow_cache_hit_rate_metric, (double)shadow_cache_hits / (double)shadow_cache_lookups);
+}
+
+void count_shadow_layer_render(void) {
+    add_metric(shadow_layers_metric, 1.0);
+}
+
+void count_point_lights(int light_count, int reference_count) {
+    set_metric(point_lights_metric, light_count);
+    set_metric(point_light_references_metric, reference_count);
+}
+
+void count_particles(int particle_count) {
+    set_metric(particles_metric, particle_count);
+}
+
+const RenderStats* get_render_stats(void) {
+    frame_stats.draw_calls = (int)get_metric_value(draw_calls_metric);
+    frame_stats.indirect_commands = (int)get_metric_value(indirect_commands_metric);
+    frame_stats.instances = (int)get_metric_value(instances_metric);
+    frame_stats.triangles = (int)get_metric_value(triangles_metric);
+    frame_stats.texture_binds = (int)get_metric_value(texture_binds_metric);
+    frame_stats.vao_binds = (int)get_metric_value(vao_binds_metric);
+    frame_stats.uniform_uploads = (int)get_metric_value(uniform_uploads_metric);
+    frame_stats.shadow_layers_rendered = (int)get_metric_value(shadow_layers_metric);
+    frame_stats.point_lights = (int)get_metric_value(point_lights_metric);
+    frame_stats.point_light_references = (int)get_metric_value(point_light_references_metric);
+    frame_stats.particles = (int)get_metric_value(particles_metric);
+    frame_stats.shadow_cache_lookups = shadow_cache_lookups;
+    frame_stats.shadow_cache_hits = shadow_cache_hits;
+    return &frame_stats;
+}
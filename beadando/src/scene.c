@@ -1,4 +1,5 @@
 #include "scene.h"
+#include "render_snapshot.h"
 #include "utils.h" // For Material struct (will be replaced)
 
 #include <glad/glad.h>
@@ -14,6 +15,8 @@
 #include "game_state.h"
 #include "input.h"
 #include "app.h"
+#include "instance_buffer.h"
+#include "render_stats.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -65,19 +68,22 @@ void destroy_scene(Scene* scene) {
         printf("DEBUG: destroy_scene - Destroying unit type resources...\n");
         for (int i = 0; i < NUM_UNIT_TYPES; ++i) {
             printf("DEBUG: destroy_scene - Destroying type %d\n", i);
-            if (scene->unit_vaos[i] != 0)
-            {
-                destroy_model_buffers(&scene->unit_models[i]);
-                scene->unit_vaos[i] = 0;
-            }
-            
-            free_model(&scene->unit_models[i]);
+            scene->unit_meshes[i] = -1;
+        }
+        destroy_mesh_pool(&scene->mesh_pool);
 
-            if (scene->unit_textures[i] != 0){
-                glDeleteTextures(1, &scene->unit_textures[i]);
-                scene->unit_textures[i] = 0;
-            }
+        if (scene->texture_array != 0) {
+            glDeleteTextures(1, &scene->texture_array);
+            scene->texture_array = 0;
         }
+        destroy_instance_buffer(&scene->instance_buffer);
+        destroy_shadow_map(&scene->shadow_map);
+        destroy_point_lights(&scene->point_lights);
+        destroy_particle_system(&scene->particles);
+        destroy_health_bars(&scene->health_bars);
+        destroy_board_overlay(&scene->board_overlay);
+        destroy_combat_text(&scene->combat_text);
+        scene->shadows_enabled = false;
 
         printf("DEBUG: destroy_scene - Unit resources destroyed.\n");
         
@@ -93,6 +99,8 @@ void init_scene(Scene* scene)
         return;
     }
 
+    scene->time = 0.0f;
+
     // Material setup
     // Diffuse: How much it reflects light evenly. Often matches texture color.
     glm_vec3_copy((vec3){1.0f, 1.0f, 1.0f}, scene->material.diffuse);
@@ -105,8 +113,13 @@ void init_scene(Scene* scene)
     
     scene->unit_count = 0;
     
+    // --- Shared mesh buffers for the board and every unit type ---
+    if (!init_mesh_pool(&scene->mesh_pool)) {
+        fprintf(stderr, "ERROR: init_scene - Failed to initialize the mesh pool\n");
+    }
+
     // --- Initialize board ---
-    if (!init_board(&scene->board, "assets/models/asd.obj", "assets/textures/grid.png")) {
+    if (!init_board(&scene->board, &scene->mesh_pool, "assets/models/asd.obj")) {
         fprintf(stderr, "ERROR: init_scene - Failed to initialize board\n");
     }
     
@@ -124,45 +137,46 @@ void init_scene(Scene* scene)
             [UNIT_RANGED_ARCHER] = "assets/textures/cube.png"
     };
 
+    // --- Texture array: layer 0 is the board, unit types share layers by path ---
+    const char* layer_files[1 + NUM_UNIT_TYPES];
+    int layer_count = 0;
+    layer_files[layer_count++] = "assets/textures/grid.png";
+    scene->board.texture_layer = 0;
+    for (int i = 0; i < NUM_UNIT_TYPES; ++i) {
+        int layer = 0;
+        while (layer < layer_count && strcmp(layer_files[layer], texture_files[i]) != 0) {
+            layer++;
+        }
+        if (layer == layer_count) {
+            layer_files[layer_count++] = texture_files[i];
+        }
+        scene->unit_texture_layers[i] = layer;
+    }
+
+    scene->texture_array = load_texture_array(layer_files, layer_count);
+    if (scene->texture_array == 0) {
+        fprintf(stderr, "ERROR: init_scene - Failed to load the scene texture array\n");
+    }
+    init_instance_buffer(&scene->instance_buffer);
+    scene->shadows_enabled = init_shadow_map(&scene->shadow_map);
+    init_point_lights(&scene->point_lights);
+    init_particle_system(&scene->particles);
+    init_health_bars(&scene->health_bars, MAX_UNITS);
+    init_board_overlay(&scene->board_overlay);
+    init_combat_text(&scene->combat_text);
+
     for (int i = 0; i < NUM_UNIT_TYPES; ++i) {
         printf("DEBUG: init_scene - Loading resources for unit type %d\n", i);
         
-        scene->unit_vaos[i] = 0;
-        scene->unit_textures[i] = 0;
-        scene->unit_index_counts[i] = 0;
-        init_model(&scene->unit_models[i]);
-
-        // Load model
-        if (!load_model(&scene->unit_models[i], model_files[i])){
+        // Load the mesh (cooked container or OBJ) into the shared pool
+        scene->unit_meshes[i] = load_mesh_into_pool(&scene->mesh_pool, model_files[i]);
+        if (scene->unit_meshes[i] < 0) {
             fprintf(stderr, "ERROR: init_scene - Failed to load model for unit type %d (%s)\n", i, model_files[i]);
             continue;
         }
 
-        // Setup Buffers
-        if (scene->unit_models[i].n_vertices > 0 && scene->unit_models[i].n_triangles > 0) {
-            setup_model_buffers(&scene->unit_models[i]);
-            if(scene->unit_models[i].vao_id == 0) {
-                fprintf(stderr, "ERROR: init_scene - Failed to setup buffers for unit type %d\n", i);
-                // free_model(&scene->unit_models[i]); // Free CPU data if buffers fail
-                continue;
-            }
-            // Store VAO and index count for rendering
-            scene->unit_vaos[i] = scene->unit_models[i].vao_id;
-            scene->unit_index_counts[i] = scene->unit_models[i].index_count;
-        } else {
-            fprintf(stderr, "ERROR: init_scene - Model loaded for unit type %d has no vertices/triangles.\n", i);
-            // free_model(&scene->unit_models[i]);
-            continue;
-        }
-        
-        // Load Texture
-        scene->unit_textures[i] = load_texture(texture_files[i]);
-        if (scene->unit_textures[i] == 0) {
-            fprintf(stderr, "ERROR: init_scene - Failed to load texture for unit type %d (%s)\n", i, texture_files[i]);
-            // Note: Model/buffers are loaded, maybe use a default texture? For now, just log error.
-        }
-        printf("DEBUG: init_scene - Resources loaded for type %d (VAO=%u, Tex=%u, Indices=%d)\n",
-               i, scene->unit_vaos[i], scene->unit_textures[i], scene->unit_index_counts[i]);
+        printf("DEBUG: init_scene - Resources loaded for type %d (Mesh=%d, Layer=%d)\n",
+               i, scene->unit_meshes[i], scene->unit_texture_layers[i]);
     }
     printf("DEBUG: init_scene - Unit type resources loaded.\n");
 
@@ -195,82 +209,144 @@ void update_scene(Scene* scene, float dt, GamePhase current_phase) // Added curr
     for (int i = 0; i < scene->unit_count; ++i) {
         update_unit(&scene->units[i], scene, dt, current_phase); // Pass scene and current_phase
     }
+    update_point_lights(&scene->point_lights, dt);
+    update_particle_system(&scene->particles, dt);
+    update_combat_text(&scene->combat_text, dt);
+    scene->time += dt;
 }
 
-void render_scene(const Scene* scene, GLuint shader_program, const App* app, int selected_bench_unit_index)
+bool is_scene_animating(const Scene* scene)
 {
-    if (!scene || !app) return;
-    
-    // Reset tint for normal objects
-    if (app->shader_uloc_color_tint != -1) {
-        glUniform4f(app->shader_uloc_color_tint, 1.0f, 1.0f, 1.0f, 1.0f);
-        check_gl_error("Set default tint for scene (render_scene)");
+    if (!scene) return false;
+    if (get_particle_count(&scene->particles) > 0 || scene->combat_text.count > 0 || scene->point_lights.count > 0) {
+        return true;
     }
+    for (int i = 0; i < scene->unit_count; ++i) {
+        const Unit* unit = &scene->units[i];
+        if (unit->location == LOC_BOARD && !unit->is_alive && unit->animation == UNIT_ANIM_DEATH &&
+            scene->time - unit->animation_start < UNIT_DEATH_DURATION) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void render_scene(Scene* scene, const RenderSnapshot* snapshot, ShaderManager* shaders, int shader, int depth_shader,
+                  const App* app, int selected_bench_unit_index)
+{
+    if (!scene || !snapshot || !app || !shaders) return;
 
-    render_board(&scene->board, shader_program, app);
-    check_gl_error("after render_board (in render_scene)");
+    InstanceBuffer* instances = &scene->instance_buffer;
+    clear_instances(instances);
 
-    glActiveTexture(GL_TEXTURE0); // Good practice
-    for (int i = 0; i < scene->unit_count; ++i) {
-        if (scene->units[i].location == LOC_BOARD && scene->units[i].is_alive) {
-            // Reset tint before drawing each unit, as ghost might change it
-            if (app->shader_uloc_color_tint != -1) {
-                glUniform4f(app->shader_uloc_color_tint, 1.0f, 1.0f, 1.0f, 1.0f);
-            }
-            render_unit(&scene->units[i], scene, shader_program, app);
-            check_gl_error("after render_unit in loop");
+    // --- Collect instances: board, then units grouped by type, ghost last (it is blended) ---
+    int board_first = instances->count;
+    InstanceData* board_instance = push_instance(instances);
+    if (board_instance) {
+        fill_board_instance(&scene->board, board_instance);
+    }
+    int board_count = instances->count - board_first;
+
+    int unit_first[NUM_UNIT_TYPES];
+    int unit_count[NUM_UNIT_TYPES];
+    for (int type = 0; type < NUM_UNIT_TYPES; ++type) {
+        unit_first[type] = instances->count;
+        const InstanceData* captured = &snapshot->unit_instances[snapshot->unit_first[type]];
+        for (int i = 0; i < snapshot->unit_instance_count[type]; ++i) {
+            InstanceData* instance = push_instance(instances);
+            if (!instance) break;
+            *instance = captured[i];
         }
+        unit_count[type] = instances->count - unit_first[type];
     }
 
-    // --- Render "Ghost" of Unit Being Placed ---
-    if (selected_bench_unit_index != -1 && app->input_state.is_mouse_over_board) {
-        if (selected_bench_unit_index >= 0 && selected_bench_unit_index < scene->unit_count) {
-            const Unit* unit_to_preview = &scene->units[selected_bench_unit_index];
-            if (unit_to_preview->location == LOC_BENCH) {
-                UnitType preview_type = unit_to_preview->type;
-
-                bool on_player_side = is_tile_on_player_side(app->input_state.hovered_grid_y);
-                bool tile_empty = is_tile_empty_for_player(scene, app->input_state.hovered_grid_x, app->input_state.hovered_grid_y);
-
-                if (scene->unit_vaos[preview_type] != 0) {
-                    // --- Set Tint for Ghost ---
-                    if (app->shader_uloc_color_tint != -1) {
-                        if (on_player_side && tile_empty) {
-                            glUniform4f(app->shader_uloc_color_tint, 0.7f, 1.0f, 0.7f, 0.65f); // Light green, semi-transparent
-                        } else {
-                            glUniform4f(app->shader_uloc_color_tint, 1.0f, 0.7f, 0.7f, 0.65f); // Light red, semi-transparent
-                        }
-                    }
-
-                    mat4 ghost_model_matrix;
-                    // ... (calculate ghost_model_matrix as before) ...
-                    glm_mat4_identity(ghost_model_matrix);
-                    vec3 ghost_world_pos;
-                    grid_to_world_pos(app->input_state.hovered_grid_x, app->input_state.hovered_grid_y, ghost_world_pos);
-                    ghost_world_pos[1] = 0.1f;
-                    glm_translate(ghost_model_matrix, ghost_world_pos);
-                    float base_scale = 0.8f;
-                    glm_scale(ghost_model_matrix, (vec3){base_scale, base_scale, base_scale});
-
-
-                    if (app->shader_uloc_model != -1) {
-                        glUniformMatrix4fv(app->shader_uloc_model, 1, GL_FALSE, (const GLfloat*)ghost_model_matrix);
-                        check_gl_error("Reset tint after ghost (render_scene end)");
-                    }
-                    glBindTexture(GL_TEXTURE_2D, scene->unit_textures[preview_type]);
-                    glBindVertexArray(scene->unit_vaos[preview_type]);
-                    GLsizei index_count = scene->unit_index_counts[preview_type];
-                    if (index_count > 0) {
-                        glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, NULL);
-                    }
-                    glBindVertexArray(0);
-
-                    // --- Reset Tint after drawing ghost ---
-                    if (app->shader_uloc_color_tint != -1) {
-                        glUniform4f(app->shader_uloc_color_tint, 1.0f, 1.0f, 1.0f, 1.0f);
-                    }
-                }
+    // --- "Ghost" of Unit Being Placed ---
+    int ghost_first = instances->count;
+    UnitType ghost_type = UNIT_MELEE_TANK;
+    if (selected_bench_unit_index >= 0 && selected_bench_unit_index < snapshot->unit_count &&
+        app->input_state.is_mouse_over_board) {
+        const Unit* unit_to_preview = &snapshot->units[selected_bench_unit_index];
+        InstanceData* instance = NULL;
+        if (unit_to_preview->location == LOC_BENCH && scene->unit_meshes[unit_to_preview->type] >= 0) {
+            instance = push_instance(instances);
+        }
+        if (instance) {
+            ghost_type = unit_to_preview->type;
+
+            // Placement rule cached in the overlay cells, updated before the frame (see update_board_overlay)
+            bool placeable = (get_board_overlay_cell(&scene->board_overlay, app->input_state.hovered_grid_x,
+                                                     app->input_state.hovered_grid_y) & BOARD_CELL_PLACEABLE) != 0;
+
+            glm_mat4_identity(instance->model);
+            vec3 ghost_world_pos;
+            grid_to_world_pos(app->input_state.hovered_grid_x, app->input_state.hovered_grid_y, ghost_world_pos);
+            ghost_world_pos[1] = 0.1f;
+            glm_translate(instance->model, ghost_world_pos);
+            float base_scale = 0.8f;
+            glm_scale(instance->model, (vec3){base_scale, base_scale, base_scale});
+
+            if (placeable) {
+                glm_vec4_copy((vec4){0.7f, 1.0f, 0.7f, 0.65f}, instance->color_tint); // Light green, semi-transparent
+            } else {
+                glm_vec4_copy((vec4){1.0f, 0.7f, 0.7f, 0.65f}, instance->color_tint); // Light red, semi-transparent
             }
+            instance->texture_layer = (float)scene->unit_texture_layers[ghost_type];
+            instance->animation = (float)UNIT_ANIM_NONE;
+            instance->animation_start = 0.0f;
         }
     }
-}
\ No newline at end of file
+    int ghost_count = instances->count - ghost_first;
+
+    upload_instances(instances);
+    check_gl_error("render_scene - upload instances");
+
+    MeshDraw draws[NUM_UNIT_TYPES + 1];
+    int draw_count = 0;
+    draws[draw_count++] = (MeshDraw){scene->board.mesh, board_first, board_count};
+    for (int type = 0; type < NUM_UNIT_TYPES; ++type) {
+        draws[draw_count++] = (MeshDraw){scene->unit_meshes[type], unit_first[type], unit_count[type]};
+    }
+
+    // --- Shadow map: board is the static layer, units the dynamic one (the ghost casts none) ---
+    bool shadows = false;
+    if (scene->shadows_enabled && depth_shader >= 0) {
+        shadows = update_shadow_map(&scene->shadow_map, shaders, depth_shader, app->light_direction_world,
+                                    &scene->mesh_pool, instances, draws, 1, draws + 1, draw_count - 1);
+    }
+
+    // --- Point lights: binned per board cell, the variant without them is used when there are none ---
+    bool point_lights = bin_point_lights(&scene->point_lights, snapshot->point_lights, snapshot->point_light_count) > 0;
+
+    uint32_t lit_features = (shadows ? SHADER_FEATURE_SHADOWS : 0) | (point_lights ? SHADER_FEATURE_POINT_LIGHTS : 0);
+    const ShaderVariant* lit = use_shader_variant(shaders, shader, lit_features);
+    if (!lit) return;
+
+    // --- Shared state: one texture bind and one material for the whole pass ---
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, scene->texture_array);
+    count_texture_bind();
+
+    set_shader_int(lit, UNIFORM_TEXTURE, 0);
+    set_shader_vec3(lit, UNIFORM_MATERIAL_DIFFUSE, scene->material.diffuse);
+    set_shader_vec3(lit, UNIFORM_MATERIAL_SPECULAR, scene->material.specular);
+    set_shader_float(lit, UNIFORM_MATERIAL_SHININESS, scene->material.shininess);
+    set_shader_int(lit, UNIFORM_SHADOW_MAP, SHADOW_TEXTURE_UNIT);
+    check_gl_error("render_scene - material uniforms");
+
+    // --- One VAO for every batch ---
+    draw_mesh_pool(&scene->mesh_pool, instances, draws, draw_count);
+    check_gl_error("render_scene - instanced draws");
+
+    // --- Ghost last (it is blended), unlit ---
+    if (ghost_count > 0) {
+        const ShaderVariant* unlit = use_shader_variant(shaders, shader, SHADER_FEATURE_UNLIT);
+        if (unlit) {
+            set_shader_int(unlit, UNIFORM_TEXTURE, 0);
+            MeshDraw ghost_draw = {scene->unit_meshes[ghost_type], ghost_first, ghost_count};
+            draw_mesh_pool(&scene->mesh_pool, instances, &ghost_draw, 1);
+            check_gl_error("render_scene - ghost draw");
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
@@ -0,0 +1,160 @@
+#include "sdf_font.h"
+#include "utils.h"
+
+#include <SDL2/SDL.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FONT_COLUMNS 5
+#define FONT_ROWS 7
+#define SDF_SUPERSAMPLE 4 // Edge positions are searched on a grid this much finer than the atlas
+
+/**
+ * Built-in 5x7 bitmap font, one bit per pixel (MSB = left column), top row first.
+ */
+typedef struct BitmapGlyph
+{
+    char character;
+    unsigned char rows[FONT_ROWS];
+} BitmapGlyph;
+
+static const BitmapGlyph bitmap_font[] = {
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+    {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {'+', {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    {'!', {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}}
+};
+
+#define BITMAP_GLYPH_COUNT ((int)(sizeof(bitmap_font) / sizeof(bitmap_font[0])))
+
+// Position of the glyph's ink inside its cell (bottom-left, texels)
+#define INK_ORIGIN_X ((SDF_FONT_CELL_SIZE - FONT_COLUMNS * SDF_FONT_PIXEL_SIZE) / 2)
+#define INK_ORIGIN_Y ((SDF_FONT_CELL_SIZE - SDF_FONT_INK_HEIGHT) / 2)
+
+/**
+ * Whether a point of the cell (texels, y up) is inside the glyph.
+ */
+static bool is_inside_glyph(const BitmapGlyph* glyph, float x, float y)
+{
+    int column = (int)floorf((x - INK_ORIGIN_X) / SDF_FONT_PIXEL_SIZE);
+    int row = FONT_ROWS - 1 - (int)floorf((y - INK_ORIGIN_Y) / SDF_FONT_PIXEL_SIZE);
+    if (column < 0 || column >= FONT_COLUMNS || row < 0 || row >= FONT_ROWS) return false;
+    return (glyph->rows[row] >> (FONT_COLUMNS - 1 - column)) & 1;
+}
+
+/**
+ * Brute-force distance field of one cell: for each texel, the nearest supersampled point
+ * of the opposite state within the spread.
+ */
+static void rasterize_glyph(const BitmapGlyph* glyph, unsigned char* atlas, int atlas_width, int cell)
+{
+    enum { SAMPLES = SDF_FONT_CELL_SIZE * SDF_SUPERSAMPLE };
+    static bool inside[SAMPLES][SAMPLES];
+    for (int y = 0; y < SAMPLES; ++y) {
+        for (int x = 0; x < SAMPLES; ++x) {
+            inside[y][x] = is_inside_glyph(glyph, (x + 0.5f) / SDF_SUPERSAMPLE, (y + 0.5f) / SDF_SUPERSAMPLE);
+        }
+    }
+
+    const int radius = SDF_FONT_SPREAD * SDF_SUPERSAMPLE;
+    for (int ty = 0; ty < SDF_FONT_CELL_SIZE; ++ty) {
+        for (int tx = 0; tx < SDF_FONT_CELL_SIZE; ++tx) {
+            int cx = tx * SDF_SUPERSAMPLE + SDF_SUPERSAMPLE / 2;
+            int cy = ty * SDF_SUPERSAMPLE + SDF_SUPERSAMPLE / 2;
+            bool center_inside = inside[cy][cx];
+
+            int best = radius * radius;
+            for (int dy = -radius; dy <= radius; ++dy) {
+                int sy = cy + dy;
+                if (sy < 0 || sy >= SAMPLES) {
+                    if (center_inside && dy * dy < best) best = dy * dy; // Outside the cell is empty
+                    continue;
+                }
+                for (int dx = -radius; dx <= radius; ++dx) {
+                    int sx = cx + dx;
+                    int d2 = dx * dx + dy * dy;
+                    if (d2 >= best) continue;
+                    bool sample_inside = (sx >= 0 && sx < SAMPLES) ? inside[sy][sx] : false;
+                    if (sample_inside != center_inside) best = d2;
+                }
+            }
+
+            float distance = sqrtf((float)best) / SDF_SUPERSAMPLE; // Texels
+            float signed_distance = center_inside ? distance : -distance;
+            float value = 0.5f + signed_distance / (2.0f * SDF_FONT_SPREAD);
+            if (value < 0.0f) value = 0.0f;
+            if (value > 1.0f) value = 1.0f;
+            atlas[ty * atlas_width + cell * SDF_FONT_CELL_SIZE + tx] = (unsigned char)(value * 255.0f + 0.5f);
+        }
+    }
+}
+
+bool init_sdf_font(SdfFont* font)
+{
+    if (!font) return false;
+    memset(font, 0, sizeof(SdfFont));
+    for (int i = 0; i < 128; ++i) font->glyph_cells[i] = -1;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    int atlas_width = BITMAP_GLYPH_COUNT * SDF_FONT_CELL_SIZE;
+    unsigned char* atlas = (unsigned char*)calloc((size_t)atlas_width * SDF_FONT_CELL_SIZE, 1);
+    if (!atlas) {
+        fprintf(stderr, "ERROR: init_sdf_font - Out of memory\n");
+        return false;
+    }
+    for (int i = 0; i < BITMAP_GLYPH_COUNT; ++i) {
+        rasterize_glyph(&bitmap_font[i], atlas, atlas_width, i);
+        font->glyph_cells[(unsigned char)bitmap_font[i].character] = i;
+    }
+    font->cell_count = BITMAP_GLYPH_COUNT;
+
+    glGenTextures(1, &font->texture);
+    glBindTexture(GL_TEXTURE_2D, font->texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlas_width, SDF_FONT_CELL_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // The field is meant to be interpolated
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    free(atlas);
+    check_gl_error("init_sdf_font");
+
+    double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    printf("[INFO] SDF font atlas generated: %d glyphs, %dx%d in %.1f ms\n", font->cell_count, atlas_width, SDF_FONT_CELL_SIZE, ms);
+    return font->texture != 0;
+}
+
+void destroy_sdf_font(SdfFont* font)
+{
+    if (!font) return;
+    if (font->texture != 0) glDeleteTextures(1, &font->texture);
+    font->texture = 0;
+    font->cell_count = 0;
+}
+
+bool get_sdf_glyph(const SdfFont* font, char character, vec4 uv_rect)
+{
+    unsigned char code = (unsigned char)character;
+    if (!font || code >= 128 || font->glyph_cells[code] < 0) return false;
+    float cell_width = 1.0f / (float)font->cell_count;
+    uv_rect[0] = (float)font->glyph_cells[code] * cell_width;
+    uv_rect[1] = 0.0f;
+    uv_rect[2] = uv_rect[0] + cell_width;
+    uv_rect[3] = 1.0f;
+    return true;
+}
@@ -1,55 +1,36 @@
 #include "shader.h"
+#include "asset_pack.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> // For strlen, strcmp
 
-// Helper function to read shader source code from a file
-// Returns a dynamically allocated string containing the file content,
-// or NULL if the file couldn't be read. Caller must free the memory.
-char* read_shader_source(const char* path) {
-    FILE* file = fopen(path, "rb"); // Read in binary mode to avoid Windows CRLF issues
-    if (!file) {
-        fprintf(stderr, "ERROR: Could not open shader file: %s\n", path);
-        return NULL;
-    }
-
-    fseek(file, 0, SEEK_END);
-    long length = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    if (length <= 0) { // Handle empty file or error
-         fprintf(stderr, "ERROR: Shader file is empty or error reading size: %s\n", path);
-         fclose(file);
-         return NULL;
-    }
-
-    char* buffer = (char*)malloc(length + 1); // +1 for null terminator
-    if (!buffer) {
-        fprintf(stderr, "ERROR: Could not allocate memory for shader source: %s\n", path);
-        fclose(file);
-        return NULL;
+// Helper function to compile a shader and check for errors
+// The source does not need to be NUL-terminated (it points into the asset pack).
+// defines (may be NULL) is inserted right after the #version line.
+// Returns the shader ID, or 0 if compilation failed.
+GLuint compile_shader(const char* source, GLint length, const char* defines, GLenum type) {
+    const GLchar* strings[3];
+    GLint lengths[3];
+    int count = 0;
+
+    // #version has to stay the first line, the defines go after it
+    GLint version_length = 0;
+    if (defines && length > 8 && strncmp(source, "#version", 8) == 0) {
+        const char* newline = memchr(source, '\n', (size_t)length);
+        version_length = newline ? (GLint)(newline - source) + 1 : length;
+        strings[count] = source;
+        lengths[count++] = version_length;
     }
-
-    size_t bytes_read = fread(buffer, 1, length, file);
-    fclose(file);
-
-    if (bytes_read != length) {
-         fprintf(stderr, "ERROR: Could not read entire shader file: %s\n", path);
-         free(buffer);
-         return NULL;
+    if (defines) {
+        strings[count] = defines;
+        lengths[count++] = (GLint)strlen(defines);
     }
+    strings[count] = source + version_length;
+    lengths[count++] = length - version_length;
 
-    buffer[length] = '\0'; // Null-terminate the string
-
-    return buffer;
-}
-
-// Helper function to compile a shader and check for errors
-// Returns the shader ID, or 0 if compilation failed.
-GLuint compile_shader(const char* source, GLenum type) {
     GLuint shader = glCreateShader(type);
-    glShaderSource(shader, 1, &source, NULL);
+    glShaderSource(shader, count, strings, lengths);
     glCompileShader(shader);
 
     GLint success;
@@ -65,28 +46,14 @@ GLuint compile_shader(const char* source, GLenum type) {
     return shader;
 }
 
-
-
-// Main function to load shaders
-GLuint load_shaders(const char* vertex_path, const char* fragment_path) {
-    char* vertex_source = read_shader_source(vertex_path);
-    if (!vertex_source) return 0;
-
-    char* fragment_source = read_shader_source(fragment_path);
-    if (!fragment_source) {
-        free(vertex_source); // Clean up vertex source if fragment fails
-        return 0;
-    }
-
-    GLuint vertex_shader = compile_shader(vertex_source, GL_VERTEX_SHADER);
-    free(vertex_source); // Free source after compilation attempt
+GLuint link_shader_program(const char* vertex_source, GLint vertex_length,
+                           const char* fragment_source, GLint fragment_length, const char* defines) {
+    GLuint vertex_shader = compile_shader(vertex_source, vertex_length, defines, GL_VERTEX_SHADER);
     if (vertex_shader == 0) {
-        if(fragment_source) free(fragment_source); // Ensure fragment source is freed if allocated
         return 0; // Vertex shader failed
     }
 
-    GLuint fragment_shader = compile_shader(fragment_source, GL_FRAGMENT_SHADER);
-    free(fragment_source); // Free source after compilation attempt
+    GLuint fragment_shader = compile_shader(fragment_source, fragment_length, defines, GL_FRAGMENT_SHADER);
     if (fragment_shader == 0) {
         glDeleteShader(vertex_shader); // Clean up successful vertex shader
         return 0; // Fragment shader failed
@@ -95,6 +62,10 @@ GLuint load_shaders(const char* vertex_path, const char* fragment_path) {
     GLuint program = glCreateProgram();
     glAttachShader(program, vertex_shader);
     glAttachShader(program, fragment_shader);
+    if (GLAD_GL_VERSION_4_1) {
+        // Lets the shader manager store the linked binary (see shader_manager.c)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(program);
 
     GLint success;
@@ -114,6 +85,31 @@ GLuint load_shaders(const char* vertex_path, const char* fragment_path) {
     glDetachShader(program, fragment_shader);
     glDeleteShader(vertex_shader);
     glDeleteShader(fragment_shader);
+    return program;
+}
+
+// Main function to load shaders
+GLuint load_shaders(const char* vertex_path, const char* fragment_path) {
+    AssetData vertex_source;
+    if (!open_asset(vertex_path, &vertex_source)) {
+        fprintf(stderr, "ERROR: Could not open shader file: %s\n", vertex_path);
+        return 0;
+    }
+
+    AssetData fragment_source;
+    if (!open_asset(fragment_path, &fragment_source)) {
+        fprintf(stderr, "ERROR: Could not open shader file: %s\n", fragment_path);
+        close_asset(&vertex_source); // Clean up vertex source if fragment fails
+        return 0;
+    }
+
+    GLuint program = link_shader_program((const char*)vertex_source.data, (GLint)vertex_source.size,
+                                         (const char*)fragment_source.data, (GLint)fragment_source.size, NULL);
+    close_asset(&vertex_source); // Release sources after compilation attempt
+    close_asset(&fragment_source);
+    if (program == 0) {
+        return 0;
+    }
 
     printf("[INFO] Shaders loaded and linked successfully (Program ID: %u)\n", program);
     return program;
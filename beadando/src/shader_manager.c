@@ -0,0 +1,522 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "shader_manager.h"
+#include "shader.h"
+#include "arena.h"
+#include "asset_pack.h"
+#include "file_map.h"
+#include "render_stats.h"
+#include "utils.h" // check_gl_error
+
+#include <SDL2/SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define make_directory(path) _mkdir(path)
+#else
+#define make_directory(path) mkdir(path, 0755)
+#endif
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// --- Binary cache ---
+
+static void get_cache_path(uint64_t key, char* out_path, size_t out_size)
+{
+    snprintf(out_path, out_size, "%s/%016llx.bin", SHADER_CACHE_DIR, (unsigned long long)key);
+}
+
+static GLuint load_cached_program(uint64_t key)
+{
+    char path[ASSET_PATH_MAX];
+    get_cache_path(key, path, sizeof(path));
+
+    FileMapping mapping;
+    if (!map_file(&mapping, path)) {
+        return 0; // Not cached yet
+    }
+
+    const ShaderCacheHeader* header = (const ShaderCacheHeader*)mapping.data;
+    if (mapping.size < sizeof(ShaderCacheHeader) ||
+        header->magic != SHADER_CACHE_MAGIC || header->version != SHADER_CACHE_VERSION || header->key != key ||
+        sizeof(ShaderCacheHeader) + (size_t)header->binary_length > mapping.size) {
+        printf("[WARN] Ignoring invalid shader cache entry '%s'\n", path);
+        unmap_file(&mapping);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, (GLenum)header->binary_format,
+                    (const unsigned char*)mapping.data + sizeof(ShaderCacheHeader), (GLsizei)header->binary_length);
+    unmap_file(&mapping);
+
+    // The driver may reject binaries of an older version of itself
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        printf("[INFO] Shader cache entry '%s' was rejected by the driver, recompiling\n", path);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void save_program_binary(GLuint program, uint64_t key)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    ArenaMark scratch = begin_scratch();
+    unsigned char* binary = (unsigned char*)scratch_alloc((size_t)length);
+    if (!binary) return;
+
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary);
+    if (written <= 0) {
+        end_scratch(scratch);
+        return;
+    }
+
+    ShaderCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SHADER_CACHE_MAGIC;
+    header.version = SHADER_CACHE_VERSION;
+    header.key = key;
+    header.binary_format = (uint32_t)format;
+    header.binary_length = (uint32_t)written;
+
+    char path[ASSET_PATH_MAX];
+    get_cache_path(key, path, sizeof(path));
+    make_directory(SHADER_CACHE_DIR); // Fails harmlessly if it exists
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("[WARN] Cannot write shader cache entry '%s'\n", path);
+        end_scratch(scratch);
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(binary, 1, (size_t)written, file) == (size_t)written;
+    if (fclose(file) != 0) ok = false;
+    if (!ok) remove(path); // Never leave a truncated entry behind
+    end_scratch(scratch);
+}
+
+// --- Building ---
+
+static const char* const shader_feature_names[SHADER_FEATURE_BITS] = {
+    "UNLIT",
+    "SHADOWS",
+    "POINT_LIGHTS"
+};
+
+static const char* const shader_uniform_names[SHADER_UNIFORM_COUNT] = {
+    "texture1",
+    "materialDiffuseColor",
+    "materialSpecularColor",
+    "materialShininess",
+    "shadowMap",
+    "boardState",
+    "fontAtlas"
+};
+
+static const char* const shader_block_names[SHADER_BLOCK_COUNT] = {
+    "FrameUniforms",
+    "PointLightUniforms"
+};
+
+static void build_feature_defines(uint32_t features, char* out_defines, size_t out_size)
+{
+    size_t length = 0;
+    out_defines[0] = '\0';
+    for (int bit = 0; bit < SHADER_FEATURE_BITS; ++bit) {
+        if (!(features & (1u << bit))) continue;
+        int written = snprintf(out_defines + length, out_size - length, "#define %s 1\n", shader_feature_names[bit]);
+        if (written < 0 || (size_t)written >= out_size - length) break;
+        length += (size_t)written;
+    }
+}
+
+static GLuint build_program(const ShaderManager* manager, const ManagedShader* shader, uint32_t features)
+{
+    AssetData vertex_source;
+    if (!open_asset(shader->vertex_path, &vertex_source)) {
+        fprintf(stderr, "ERROR: Could not open shader file: %s\n", shader->vertex_path);
+        return 0;
+    }
+    AssetData fragment_source;
+    if (!open_asset(shader->fragment_path, &fragment_source)) {
+        fprintf(stderr, "ERROR: Could not open shader file: %s\n", shader->fragment_path);
+        close_asset(&vertex_source);
+        return 0;
+    }
+
+    char defines[256];
+    build_feature_defines(features, defines, sizeof(defines));
+
+    uint64_t key = FNV1A64_OFFSET_BASIS;
+    key = hash_fnv1a64(key, vertex_source.data, vertex_source.size);
+    key = hash_fnv1a64(key, "", 1); // Separator, so moving text between the stages changes the key
+    key = hash_fnv1a64(key, fragment_source.data, fragment_source.size);
+    key = hash_fnv1a64(key, defines, strlen(defines) + 1);
+    key = hash_fnv1a64(key, manager->driver_id, strlen(manager->driver_id));
+
+    GLuint program = 0;
+    if (manager->binary_cache_enabled) {
+        program = load_cached_program(key);
+        if (program != 0) {
+            printf("[INFO] Shader '%s' + '%s' (features 0x%x) loaded from the cache (Program ID: %u)\n",
+                   shader->vertex_path, shader->fragment_path, features, program);
+        }
+    }
+    if (program == 0) {
+        program = link_shader_program((const char*)vertex_source.data, (GLint)vertex_source.size,
+                                      (const char*)fragment_source.data, (GLint)fragment_source.size,
+                                      defines[0] ? defines : NULL);
+        if (program != 0) {
+            printf("[INFO] Shader '%s' + '%s' (features 0x%x) compiled (Program ID: %u)\n",
+                   shader->vertex_path, shader->fragment_path, features, program);
+            if (manager->binary_cache_enabled) save_program_binary(program, key);
+        }
+    }
+
+    close_asset(&vertex_source);
+    close_asset(&fragment_source);
+    return program;
+}
+
+static int find_name(const char* const* names, int count, const char* name)
+{
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+/**
+ * Fills the lookup table of a freshly built variant from the active uniforms and blocks of its program.
+ * This is the only place glGetUniformLocation is called.
+ */
+static void reflect_variant(ShaderVariant* variant)
+{
+    for (int i = 0; i < SHADER_UNIFORM_COUNT; ++i) variant->uniform_locations[i] = -1;
+    variant->active_blocks = 0;
+
+    GLchar name[128];
+    GLint uniform_count = 0;
+    glGetProgramiv(variant->program, GL_ACTIVE_UNIFORMS, &uniform_count);
+    for (GLint i = 0; i < uniform_count; ++i) {
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(variant->program, (GLuint)i, sizeof(name), NULL, &size, &type, name);
+        GLint location = glGetUniformLocation(variant->program, name);
+        if (location < 0) continue; // Member of a uniform block
+
+        char* array_suffix = strstr(name, "[0]");
+        if (array_suffix) *array_suffix = '\0';
+        int id = find_name(shader_uniform_names, SHADER_UNIFORM_COUNT, name);
+        if (id < 0) {
+            printf("[WARN] Shader uniform '%s' has no ShaderUniform ID, it cannot be set\n", name);
+            continue;
+        }
+        variant->uniform_locations[id] = location;
+    }
+
+    GLint block_count = 0;
+    glGetProgramiv(variant->program, GL_ACTIVE_UNIFORM_BLOCKS, &block_count);
+    for (GLint i = 0; i < block_count; ++i) {
+        glGetActiveUniformBlockName(variant->program, (GLuint)i, sizeof(name), NULL, name);
+        int id = find_name(shader_block_names, SHADER_BLOCK_COUNT, name);
+        if (id < 0) {
+            printf("[WARN] Uniform block '%s' has no ShaderBlock ID, it is never bound\n", name);
+            continue;
+        }
+        glUniformBlockBinding(variant->program, (GLuint)i, (GLuint)id);
+        variant->active_blocks |= 1u << id;
+    }
+    check_gl_error("reflect_variant");
+}
+
+static bool build_variant(const ShaderManager* manager, const ManagedShader* shader, ShaderVariant* variant)
+{
+    GLuint program = build_program(manager, shader, variant->features);
+    if (program == 0) return false;
+
+    if (variant->program != 0) glDeleteProgram(variant->program);
+    variant->program = program;
+    reflect_variant(variant);
+    return true;
+}
+
+// --- Watching ---
+
+static long long get_modification_time(const char* path)
+{
+    struct stat file_stat;
+    if (stat(path, &file_stat) != 0) return 0;
+    return (long long)file_stat.st_mtime;
+}
+
+// Splits "shaders/simple.vert" into "shaders" and returns "simple.vert"
+static const char* split_directory(const char* path, char* out_directory, size_t out_size)
+{
+    const char* slash = strrchr(path, '/');
+    if (!slash) {
+        snprintf(out_directory, out_size, ".");
+        return path;
+    }
+    snprintf(out_directory, out_size, "%.*s", (int)(slash - path), path);
+    return slash + 1;
+}
+
+static void watch_directory_of(ShaderManager* manager, const char* path)
+{
+#ifdef __linux__
+    if (manager->watch_fd < 0) return;
+
+    char directory[ASSET_PATH_MAX];
+    split_directory(path, directory, sizeof(directory));
+    for (int i = 0; i < manager->watch_count; ++i) {
+        if (strcmp(manager->watch_directories[i], directory) == 0) return; // Already watched
+    }
+    if (manager->watch_count >= MAX_SHADER_WATCHES) {
+        printf("[WARN] Too many shader directories, '%s' is not watched\n", directory);
+        return;
+    }
+
+    // Editors either rewrite the file or rename a temporary over it
+    int descriptor = inotify_add_watch(manager->watch_fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0) {
+        printf("[WARN] Cannot watch shader directory '%s'\n", directory);
+        return;
+    }
+    manager->watch_descriptors[manager->watch_count] = descriptor;
+    strcpy(manager->watch_directories[manager->watch_count], directory);
+    manager->watch_count++;
+#else
+    (void)manager;
+    (void)path;
+#endif
+}
+
+static void mark_changed_file(ShaderManager* manager, const char* directory, const char* name)
+{
+    char program_directory[ASSET_PATH_MAX];
+    for (int i = 0; i < manager->shader_count; ++i) {
+        ManagedShader* shader = &manager->shaders[i];
+        const char* paths[2] = {shader->vertex_path, shader->fragment_path};
+        for (int j = 0; j < 2; ++j) {
+            const char* file_name = split_directory(paths[j], program_directory, sizeof(program_directory));
+            if (strcmp(file_name, name) == 0 && strcmp(program_directory, directory) == 0) {
+                shader->needs_reload = true;
+            }
+        }
+    }
+}
+
+static void poll_changes(ShaderManager* manager)
+{
+#ifdef __linux__
+    if (manager->watch_fd >= 0) {
+        // Non-blocking, returns -1 once the queue is drained
+        char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t length;
+        while ((length = read(manager->watch_fd, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const struct inotify_event* event = (const struct inotify_event*)cursor;
+                for (int i = 0; i < manager->watch_count; ++i) {
+                    if (manager->watch_descriptors[i] == event->wd && event->len > 0) {
+                        mark_changed_file(manager, manager->watch_directories[i], event->name);
+                    }
+                }
+                cursor += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        return;
+    }
+#endif
+
+    // Fallback: compare modification times now and then
+    uint32_t now = SDL_GetTicks();
+    if (now - manager->last_poll_ticks < SHADER_POLL_INTERVAL) return;
+    manager->last_poll_ticks = now;
+
+    for (int i = 0; i < manager->shader_count; ++i) {
+        ManagedShader* shader = &manager->shaders[i];
+        long long vertex_mtime = get_modification_time(shader->vertex_path);
+        long long fragment_mtime = get_modification_time(shader->fragment_path);
+        if (vertex_mtime != shader->vertex_mtime || fragment_mtime != shader->fragment_mtime) {
+            shader->vertex_mtime = vertex_mtime;
+            shader->fragment_mtime = fragment_mtime;
+            shader->needs_reload = true;
+        }
+    }
+}
+
+// --- Public API ---
+
+void init_shader_manager(ShaderManager* manager, bool watch_files)
+{
+    memset(manager, 0, sizeof(ShaderManager));
+    manager->watch_fd = -1;
+
+    GLint format_count = 0;
+    if (GLAD_GL_VERSION_4_1) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    }
+    manager->binary_cache_enabled = format_count > 0;
+    snprintf(manager->driver_id, sizeof(manager->driver_id), "%s|%s|%s",
+             (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER),
+             (const char*)glGetString(GL_VERSION));
+
+    manager->watching = watch_files;
+#ifdef __linux__
+    if (watch_files) {
+        manager->watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (manager->watch_fd < 0) {
+            printf("[WARN] inotify unavailable, polling shader files instead\n");
+        }
+    }
+#endif
+
+    printf("[INFO] Shader manager: binary cache %s, hot reload %s\n",
+           manager->binary_cache_enabled ? "on" : "off (no program binary formats)",
+           !watch_files ? "off" : (manager->watch_fd >= 0 ? "on (inotify)" : "on (polling)"));
+}
+
+int load_shader(ShaderManager* manager, const char* vertex_path, const char* fragment_path)
+{
+    if (manager->shader_count >= MAX_SHADERS) {
+        fprintf(stderr, "ERROR: Too many shaders (limit %d)\n", MAX_SHADERS);
+        return -1;
+    }
+    if (strlen(vertex_path) >= ASSET_PATH_MAX || strlen(fragment_path) >= ASSET_PATH_MAX) {
+        fprintf(stderr, "ERROR: Shader path too long\n");
+        return -1;
+    }
+
+    ManagedShader* shader = &manager->shaders[manager->shader_count];
+    memset(shader, 0, sizeof(ManagedShader));
+    strcpy(shader->vertex_path, vertex_path);
+    strcpy(shader->fragment_path, fragment_path);
+
+    // The base variant doubles as the check that the sources build at all
+    ShaderVariant* base = &shader->variants[shader->variant_count++];
+    base->features = 0;
+    if (!build_variant(manager, shader, base)) {
+        return -1;
+    }
+
+    if (manager->watching) {
+        shader->vertex_mtime = get_modification_time(vertex_path);
+        shader->fragment_mtime = get_modification_time(fragment_path);
+        watch_directory_of(manager, vertex_path);
+        watch_directory_of(manager, fragment_path);
+    }
+    return manager->shader_count++;
+}
+
+const ShaderVariant* get_shader_variant(ShaderManager* manager, int shader_handle, uint32_t features)
+{
+    if (shader_handle < 0 || shader_handle >= manager->shader_count) return NULL;
+    ManagedShader* shader = &manager->shaders[shader_handle];
+
+    for (int i = 0; i < shader->variant_count; ++i) {
+        if (shader->variants[i].features == features) {
+            return shader->variants[i].program != 0 ? &shader->variants[i] : NULL;
+        }
+    }
+
+    if (shader->variant_count >= MAX_SHADER_VARIANTS) {
+        fprintf(stderr, "ERROR: Too many variants of '%s' (limit %d)\n", shader->fragment_path, MAX_SHADER_VARIANTS);
+        return NULL;
+    }
+    // Failures are remembered too (program 0), so a broken variant is not recompiled every frame
+    ShaderVariant* variant = &shader->variants[shader->variant_count++];
+    memset(variant, 0, sizeof(ShaderVariant));
+    variant->features = features;
+    return build_variant(manager, shader, variant) ? variant : NULL;
+}
+
+const ShaderVariant* use_shader_variant(ShaderManager* manager, int shader, uint32_t features)
+{
+    const ShaderVariant* variant = get_shader_variant(manager, shader, features);
+    if (variant) glUseProgram(variant->program);
+    return variant;
+}
+
+void set_shader_int(const ShaderVariant* variant, ShaderUniform uniform, int value)
+{
+    if (variant->uniform_locations[uniform] == -1) return;
+    glUniform1i(variant->uniform_locations[uniform], value);
+    count_uniform_upload();
+}
+
+void set_shader_float(const ShaderVariant* variant, ShaderUniform uniform, float value)
+{
+    if (variant->uniform_locations[uniform] == -1) return;
+    glUniform1f(variant->uniform_locations[uniform], value);
+    count_uniform_upload();
+}
+
+void set_shader_vec3(const ShaderVariant* variant, ShaderUniform uniform, const float* value)
+{
+    if (variant->uniform_locations[uniform] == -1) return;
+    glUniform3fv(variant->uniform_locations[uniform], 1, value);
+    count_uniform_upload();
+}
+
+bool update_shader_manager(ShaderManager* manager)
+{
+    if (!manager->watching) return false;
+    poll_changes(manager);
+
+    bool replaced = false;
+    for (int i = 0; i < manager->shader_count; ++i) {
+        ManagedShader* shader = &manager->shaders[i];
+        if (!shader->needs_reload) continue;
+        shader->needs_reload = false;
+
+        for (int j = 0; j < shader->variant_count; ++j) {
+            ShaderVariant* variant = &shader->variants[j];
+            if (build_variant(manager, shader, variant)) {
+                replaced = true;
+            } else {
+                printf("[WARN] Reloading '%s' + '%s' (features 0x%x) failed, keeping the previous program\n",
+                       shader->vertex_path, shader->fragment_path, variant->features);
+            }
+        }
+    }
+    return replaced;
+}
+
+void destroy_shader_manager(ShaderManager* manager)
+{
+    for (int i = 0; i < manager->shader_count; ++i) {
+        ManagedShader* shader = &manager->shaders[i];
+        for (int j = 0; j < shader->variant_count; ++j) {
+            if (shader->variants[j].program != 0) glDeleteProgram(shader->variants[j].program);
+        }
+        shader->variant_count = 0;
+    }
+    manager->shader_count = 0;
+
+#ifdef __linux__
+    if (manager->watch_fd >= 0) close(manager->watch_fd);
+#endif
+    manager->watch_fd = -1;
+    manager->watch_count = 0;
+    manager->watching = false;
+}
@@ -0,0 +1,169 @@
+#include "shadow_map.h"
+#include "board.h"
+#include "render_stats.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool create_depth_target(GLuint* texture, GLuint* framebuffer)
+{
+    glGenTextures(1, texture);
+    glBindTexture(GL_TEXTURE_2D, *texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 0,
+                 GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+    // Hardware depth comparison with bilinear PCF; outside the map everything is lit
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, (const GLfloat[]){1.0f, 1.0f, 1.0f, 1.0f});
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, *framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, *texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    check_gl_error("create_depth_target");
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "ERROR: Shadow map framebuffer incomplete (0x%x)\n", status);
+        return false;
+    }
+    return true;
+}
+
+bool init_shadow_map(ShadowMap* shadow_map)
+{
+    if (!shadow_map) return false;
+    memset(shadow_map, 0, sizeof(ShadowMap));
+
+    if (!create_depth_target(&shadow_map->static_texture, &shadow_map->static_framebuffer) ||
+        !create_depth_target(&shadow_map->shadow_texture, &shadow_map->shadow_framebuffer)) {
+        destroy_shadow_map(shadow_map);
+        return false;
+    }
+    printf("[INFO] Shadow map created: %dx%d, 2 layers\n", SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+    return true;
+}
+
+void destroy_shadow_map(ShadowMap* shadow_map)
+{
+    if (!shadow_map) return;
+    GLuint framebuffers[2] = {shadow_map->static_framebuffer, shadow_map->shadow_framebuffer};
+    GLuint textures[2] = {shadow_map->static_texture, shadow_map->shadow_texture};
+    glDeleteFramebuffers(2, framebuffers); // Zero names are ignored
+    glDeleteTextures(2, textures);
+    memset(shadow_map, 0, sizeof(ShadowMap));
+}
+
+void compute_shadow_light_matrix(const vec3 light_direction, mat4 out_light_space)
+{
+    vec3 center = {
+        (BOARD_GRID_WIDTH * BOARD_TILE_SIZE) / 2.0f,
+        0.0f,
+        (BOARD_GRID_HEIGHT * BOARD_TILE_SIZE) / 2.0f
+    };
+    // Half diagonal of the board plus room for the unit heights
+    float radius = 0.75f * (BOARD_GRID_WIDTH + BOARD_GRID_HEIGHT) * BOARD_TILE_SIZE / 2.0f + 2.0f;
+
+    vec3 direction;
+    glm_vec3_normalize_to((float*)light_direction, direction);
+    vec3 eye;
+    glm_vec3_scale(direction, radius * 2.0f, eye);
+    glm_vec3_add(center, eye, eye);
+    vec3 up = {0.0f, 1.0f, 0.0f};
+    if (fabsf(direction[1]) > 0.99f) glm_vec3_copy((vec3){0.0f, 0.0f, 1.0f}, up);
+
+    mat4 view;
+    mat4 projection;
+    glm_lookat(eye, center, up, view);
+    glm_ortho(-radius, radius, -radius, radius, 0.1f, radius * 4.0f, projection);
+    glm_mat4_mul(projection, view, out_light_space);
+}
+
+static uint64_t hash_casters(const InstanceBuffer* instances, const MeshDraw* draws, int draw_count)
+{
+    uint64_t hash = FNV1A64_OFFSET_BASIS;
+    for (int i = 0; i < draw_count; ++i) {
+        hash = hash_fnv1a64(hash, &draws[i].mesh, sizeof(int));
+        for (int j = 0; j < draws[i].instance_count; ++j) {
+            // Only the transform matters; tint flashes do not move shadows
+            hash = hash_fnv1a64(hash, instances->instances[draws[i].first_instance + j].model, sizeof(mat4));
+        }
+    }
+    return hash;
+}
+
+static void begin_depth_pass(GLuint framebuffer, bool clear)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+    if (clear) glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+bool update_shadow_map(ShadowMap* shadow_map, ShaderManager* shaders, int depth_shader, const vec3 light_direction,
+                       const MeshPool* pool, const InstanceBuffer* instances,
+                       const MeshDraw* static_draws, int static_draw_count,
+                       const MeshDraw* dynamic_draws, int dynamic_draw_count)
+{
+    if (!shadow_map || shadow_map->shadow_framebuffer == 0) return false;
+
+    bool light_changed = !glm_vec3_eqv((float*)light_direction, shadow_map->light_direction);
+    if (light_changed) {
+        shadow_map->static_valid = false;
+        glm_vec3_copy((float*)light_direction, shadow_map->light_direction);
+    }
+    uint64_t caster_hash = hash_casters(instances, dynamic_draws, dynamic_draw_count);
+    bool hit = shadow_map->static_valid && shadow_map->shadow_valid && caster_hash == shadow_map->caster_hash;
+    count_shadow_cache_lookup(hit);
+
+    if (!hit) {
+        const ShaderVariant* depth = use_shader_variant(shaders, depth_shader, 0);
+        if (depth) {
+            GLint previous_framebuffer = 0;
+            GLint previous_viewport[4];
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+            glGetIntegerv(GL_VIEWPORT, previous_viewport);
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(2.0f, 4.0f); // Against shadow acne
+
+            if (!shadow_map->static_valid) {
+                begin_depth_pass(shadow_map->static_framebuffer, true);
+                draw_mesh_pool(pool, instances, static_draws, static_draw_count);
+                shadow_map->static_valid = true;
+                count_shadow_layer_render();
+            }
+
+            // Shadow layer = static layer + units
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, shadow_map->static_framebuffer);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, shadow_map->shadow_framebuffer);
+            glBlitFramebuffer(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE,
+                              GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            begin_depth_pass(shadow_map->shadow_framebuffer, false);
+            draw_mesh_pool(pool, instances, dynamic_draws, dynamic_draw_count);
+            shadow_map->shadow_valid = true;
+            shadow_map->caster_hash = caster_hash;
+            count_shadow_layer_render();
+
+            glDisable(GL_POLYGON_OFFSET_FILL);
+            glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previous_framebuffer);
+            glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
+            check_gl_error("update_shadow_map");
+        }
+    }
+
+    if (!shadow_map->shadow_valid) return false;
+
+    glActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, shadow_map->shadow_texture);
+    glActiveTexture(GL_TEXTURE0);
+    count_texture_bind();
+    return true;
+}
@@ -4,15 +4,172 @@
 #include <SDL2/SDL_image.h> // Still using SDL_image for now
 #include <stdio.h>         // For error messages
 #include <glad/glad.h>     // Use GLAD
+#include <stdlib.h>
+#include <string.h>
 
-GLuint load_texture(const char* filename) // Use const char*
+#include "asset_paths.h"
+#include "job_system.h"
+#include "utils.h"
+
+bool open_texture_container(TextureContainer* container, const char* path)
+{
+    if (!container || !path) return false;
+    memset(container, 0, sizeof(TextureContainer));
+
+    if (!open_asset(path, &container->asset)) {
+        return false; // Not cooked (yet), caller falls back to the source image
+    }
+
+    const unsigned char* base = (const unsigned char*)container->asset.data;
+    size_t size = container->asset.size;
+    if (size < sizeof(TextureContainerHeader)) {
+        fprintf(stderr, "[ERROR] Texture container '%s' is truncated.\n", path);
+        close_texture_container(container);
+        return false;
+    }
+
+    const TextureContainerHeader* header = (const TextureContainerHeader*)base;
+    if (header->magic != TEXTURE_CONTAINER_MAGIC || header->version != TEXTURE_CONTAINER_VERSION) {
+        fprintf(stderr, "[ERROR] Texture container '%s' has a bad magic/version (re-cook it).\n", path);
+        close_texture_container(container);
+        return false;
+    }
+    if (header->level_count == 0 || header->level_count > TEXTURE_CONTAINER_MAX_LEVELS ||
+        size < sizeof(TextureContainerHeader) + header->level_count * sizeof(TextureContainerLevel)) {
+        fprintf(stderr, "[ERROR] Texture container '%s' has an invalid level table.\n", path);
+        close_texture_container(container);
+        return false;
+    }
+
+    // Only what the texture cooker writes: GL gets these values and reads the levels with them
+    bool is_compressed = (header->flags & TEXTURE_CONTAINER_FLAG_COMPRESSED) != 0;
+    uint64_t block_bytes = 0;
+    if (is_compressed) {
+        if (header->gl_internal_format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) {
+            block_bytes = 8;
+        } else if (header->gl_internal_format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+            block_bytes = 16;
+        }
+    } else if (header->gl_internal_format == GL_RGBA8 && header->gl_format == GL_RGBA &&
+               header->gl_type == GL_UNSIGNED_BYTE) {
+        block_bytes = 4; // Bytes per texel
+    }
+    if (block_bytes == 0) {
+        fprintf(stderr, "[ERROR] Texture container '%s' has an unsupported format (re-cook it).\n", path);
+        close_texture_container(container);
+        return false;
+    }
+
+    const TextureContainerLevel* levels = (const TextureContainerLevel*)(base + sizeof(TextureContainerHeader));
+    for (uint32_t i = 0; i < header->level_count; ++i) {
+        if (levels[i].offset > size || levels[i].size > size - levels[i].offset) {
+            fprintf(stderr, "[ERROR] Texture container '%s': level %u is out of bounds.\n", path, i);
+            close_texture_container(container);
+            return false;
+        }
+        uint64_t width = levels[i].width;
+        uint64_t height = levels[i].height;
+        bool size_matches = is_compressed ? levels[i].size == ((width + 3) / 4) * ((height + 3) / 4) * block_bytes
+                                          : levels[i].size >= width * height * block_bytes;
+        if (!size_matches) {
+            fprintf(stderr, "[ERROR] Texture container '%s': level %u has the wrong size for %ux%u.\n", path, i,
+                    levels[i].width, levels[i].height);
+            close_texture_container(container);
+            return false;
+        }
+    }
+
+    container->header = header;
+    container->levels = levels;
+    return true;
+}
+
+const void* get_texture_container_level(const TextureContainer* container, int level)
+{
+    if (!container || !container->header || level < 0 || (uint32_t)level >= container->header->level_count) {
+        return NULL;
+    }
+    return (const unsigned char*)container->asset.data + container->levels[level].offset;
+}
+
+void close_texture_container(TextureContainer* container)
+{
+    if (!container) return;
+    close_asset(&container->asset);
+    container->header = NULL;
+    container->levels = NULL;
+}
+
+GLuint upload_texture_container(const TextureContainer* container)
+{
+    if (!container || !container->header) return 0;
+    const TextureContainerHeader* header = container->header;
+    bool is_compressed = (header->flags & TEXTURE_CONTAINER_FLAG_COMPRESSED) != 0;
+
+    if (is_compressed && !has_gl_extension("GL_EXT_texture_compression_s3tc")) {
+        printf("[WARN] S3TC not supported by the context, cannot use compressed container.\n");
+        return 0;
+    }
+
+    GLuint texture_name = 0;
+    glGenTextures(1, &texture_name);
+    glBindTexture(GL_TEXTURE_2D, texture_name);
+
+    // Rows of the small mip levels are not 4-byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (uint32_t level = 0; level < header->level_count; ++level) {
+        const TextureContainerLevel* level_info = &container->levels[level];
+        const void* pixels = get_texture_container_level(container, (int)level);
+        if (is_compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, header->gl_internal_format,
+                                   level_info->width, level_info->height, 0,
+                                   (GLsizei)level_info->size, pixels);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, (GLint)level, (GLint)header->gl_internal_format,
+                         level_info->width, level_info->height, 0,
+                         header->gl_format, header->gl_type, pixels);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // All levels come from the file, no glGenerateMipmap
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)header->level_count - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    header->level_count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    check_gl_error("upload_texture_container");
+    return texture_name;
+}
+
+// Decodes an image straight from the asset pack (or the mapped loose file)
+static SDL_Surface* load_image_surface(const char* filename)
+{
+    AssetData asset;
+    if (!open_asset(filename, &asset)) {
+        fprintf(stderr, "[ERROR] Texture '%s' not found.\n", filename);
+        return NULL;
+    }
+    SDL_Surface* surface = IMG_Load_RW(SDL_RWFromConstMem(asset.data, (int)asset.size), 1);
+    close_asset(&asset);
+    if (!surface) {
+        fprintf(stderr, "[ERROR] IMG_Load: %s\n", IMG_GetError());
+    }
+    return surface;
+}
+
+// Slow path: decode the source image and let the driver build the mip chain
+static GLuint load_texture_from_image(const char* filename)
 {
     SDL_Surface* surface;
     GLuint texture_name = 0; // Initialize to 0 (error indicator)
 
-    surface = IMG_Load(filename);
+    surface = load_image_surface(filename);
     if (!surface) {
-        fprintf(stderr, "[ERROR] IMG_Load: %s\n", IMG_GetError());
         return 0;
     }
 
@@ -76,4 +233,230 @@ GLuint load_texture(const char* filename) // Use const char*
     printf("[INFO] Texture loaded via SDL_image: '%s' (ID: %u)\n", filename, texture_name);
 
     return texture_name;
-}
\ No newline at end of file
+}
+
+GLuint load_texture(const char* filename) // Use const char*
+{
+    char cooked_path[ASSET_PATH_MAX];
+    if (get_cooked_asset_path(filename, ".tex", cooked_path, sizeof(cooked_path))) {
+        TextureContainer container;
+        if (open_texture_container(&container, cooked_path)) {
+            GLuint texture_name = upload_texture_container(&container);
+            close_texture_container(&container);
+            if (texture_name != 0) {
+                printf("[INFO] Texture loaded from container: '%s' (ID: %u)\n", cooked_path, texture_name);
+                return texture_name;
+            }
+        }
+    }
+
+    return load_texture_from_image(filename);
+}
+
+// --- Texture array ---
+
+static int count_mip_levels(int size)
+{
+    int levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+// Bilinear resample of a tightly packed RGBA8 image
+static void resample_rgba(const unsigned char* src, int src_w, int src_h, unsigned char* dst, int dst_w, int dst_h)
+{
+    for (int y = 0; y < dst_h; ++y) {
+        float fy = ((float)y + 0.5f) * (float)src_h / (float)dst_h - 0.5f;
+        if (fy < 0.0f) fy = 0.0f;
+        int y0 = (int)fy;
+        int y1 = (y0 + 1 < src_h) ? y0 + 1 : y0;
+        float ty = fy - (float)y0;
+        for (int x = 0; x < dst_w; ++x) {
+            float fx = ((float)x + 0.5f) * (float)src_w / (float)dst_w - 0.5f;
+            if (fx < 0.0f) fx = 0.0f;
+            int x0 = (int)fx;
+            int x1 = (x0 + 1 < src_w) ? x0 + 1 : x0;
+            float tx = fx - (float)x0;
+            for (int c = 0; c < 4; ++c) {
+                float top = src[(y0 * src_w + x0) * 4 + c] * (1.0f - tx) + src[(y0 * src_w + x1) * 4 + c] * tx;
+                float bottom = src[(y1 * src_w + x0) * 4 + c] * (1.0f - tx) + src[(y1 * src_w + x1) * 4 + c] * tx;
+                dst[(y * dst_w + x) * 4 + c] = (unsigned char)(top * (1.0f - ty) + bottom * ty + 0.5f);
+            }
+        }
+    }
+}
+
+// Copies the matching level (and the ones below it) of an RGBA8 container into the layer.
+// Returns false if the container has no level of the layer size.
+static bool upload_container_layer(const TextureContainer* container, int layer, int array_levels)
+{
+    const TextureContainerHeader* header = container->header;
+    if ((header->flags & TEXTURE_CONTAINER_FLAG_COMPRESSED) || header->gl_format != GL_RGBA ||
+        header->gl_type != GL_UNSIGNED_BYTE) {
+        return false;
+    }
+
+    uint32_t first_level = 0;
+    while (first_level < header->level_count &&
+           (container->levels[first_level].width != TEXTURE_ARRAY_LAYER_SIZE ||
+            container->levels[first_level].height != TEXTURE_ARRAY_LAYER_SIZE)) {
+        first_level++;
+    }
+    if (first_level == header->level_count || header->level_count - first_level < (uint32_t)array_levels) {
+        return false;
+    }
+
+    for (int level = 0; level < array_levels; ++level) {
+        const TextureContainerLevel* level_info = &container->levels[first_level + level];
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+                        level_info->width, level_info->height, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                        get_texture_container_level(container, (int)first_level + level));
+    }
+    return true;
+}
+
+// Source image of a layer without a usable cooked container
+typedef struct ImageLayer
+{
+    const char* filename;
+    int layer;
+    AssetData asset;       // Opened on the main thread (asset lookups update the metrics)
+    unsigned char* pixels; // RGBA8 at the layer size, NULL if decoding failed
+} ImageLayer;
+
+// Decodes the source image resampled to the layer size (level 0 only). Runs on the job workers: no GL here.
+static unsigned char* decode_image_layer(const ImageLayer* image)
+{
+    SDL_Surface* loaded = IMG_Load_RW(SDL_RWFromConstMem(image->asset.data, (int)image->asset.size), 1);
+    if (!loaded) {
+        fprintf(stderr, "[ERROR] IMG_Load '%s': %s\n", image->filename, IMG_GetError());
+        return NULL;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) {
+        fprintf(stderr, "[ERROR] Texture '%s': cannot convert to RGBA: %s\n", image->filename, SDL_GetError());
+        return NULL;
+    }
+
+    size_t source_size = (size_t)surface->w * surface->h * 4;
+    size_t layer_size = (size_t)TEXTURE_ARRAY_LAYER_SIZE * TEXTURE_ARRAY_LAYER_SIZE * 4;
+    unsigned char* source_pixels = (unsigned char*)malloc(source_size);
+    unsigned char* layer_pixels = (unsigned char*)malloc(layer_size);
+    if (!source_pixels || !layer_pixels) {
+        fprintf(stderr, "[ERROR] Texture '%s': out of memory while resampling.\n", image->filename);
+        free(source_pixels);
+        free(layer_pixels);
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y) {
+        memcpy(source_pixels + (size_t)y * surface->w * 4,
+               (const unsigned char*)surface->pixels + (size_t)y * surface->pitch, (size_t)surface->w * 4);
+    }
+    SDL_UnlockSurface(surface);
+    resample_rgba(source_pixels, surface->w, surface->h, layer_pixels, TEXTURE_ARRAY_LAYER_SIZE, TEXTURE_ARRAY_LAYER_SIZE);
+
+    free(source_pixels);
+    SDL_FreeSurface(surface);
+    return layer_pixels;
+}
+
+static void decode_image_layers(int begin, int end, void* data)
+{
+    ImageLayer* images = (ImageLayer*)data;
+    for (int i = begin; i < end; ++i) {
+        images[i].pixels = decode_image_layer(&images[i]);
+    }
+}
+
+GLuint load_texture_array(const char* const* filenames, int layer_count)
+{
+    if (!filenames || layer_count <= 0) return 0;
+
+    int array_levels = count_mip_levels(TEXTURE_ARRAY_LAYER_SIZE);
+    GLuint texture_name = 0;
+    glGenTextures(1, &texture_name);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_name);
+
+    // Allocate the whole chain up front, layers are filled with sub-image uploads
+    int level_size = TEXTURE_ARRAY_LAYER_SIZE;
+    for (int level = 0; level < array_levels; ++level) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, level_size, level_size, layer_count, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        level_size = level_size > 1 ? level_size / 2 : 1;
+    }
+
+    ImageLayer* images = (ImageLayer*)calloc((size_t)layer_count, sizeof(ImageLayer));
+    if (!images) {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glDeleteTextures(1, &texture_name);
+        return 0;
+    }
+    int image_count = 0;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    bool ok = true;
+    for (int layer = 0; layer < layer_count && ok; ++layer) {
+        bool uploaded = false;
+        char cooked_path[ASSET_PATH_MAX];
+        TextureContainer container;
+        if (get_cooked_asset_path(filenames[layer], ".tex", cooked_path, sizeof(cooked_path)) &&
+            open_texture_container(&container, cooked_path)) {
+            uploaded = upload_container_layer(&container, layer, array_levels);
+            close_texture_container(&container);
+        }
+        if (!uploaded) { // Decoded below, all such layers at once on the job workers
+            ImageLayer* image = &images[image_count++];
+            image->filename = filenames[layer];
+            image->layer = layer;
+            if (!open_asset(filenames[layer], &image->asset)) {
+                fprintf(stderr, "[ERROR] Texture '%s' not found.\n", filenames[layer]);
+                ok = false;
+            }
+        }
+        printf("[INFO] Texture array layer %d: '%s' (%s)\n", layer, filenames[layer], uploaded ? "cooked" : "decoded");
+    }
+
+    if (ok) {
+        parallel_for(image_count, 1, decode_image_layers, images);
+    }
+    for (int i = 0; i < image_count; ++i) {
+        if (images[i].pixels) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, images[i].layer,
+                            TEXTURE_ARRAY_LAYER_SIZE, TEXTURE_ARRAY_LAYER_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE, images[i].pixels);
+            free(images[i].pixels);
+        } else {
+            ok = false;
+        }
+        close_asset(&images[i].asset);
+    }
+    bool needs_mipmaps = image_count > 0;
+    free(images);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (!ok) {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glDeleteTextures(1, &texture_name);
+        return 0;
+    }
+    if (needs_mipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    check_gl_error("load_texture_array");
+
+    printf("[INFO] Texture array created: %d layers of %dx%d (ID: %u)\n",
+           layer_count, TEXTURE_ARRAY_LAYER_SIZE, TEXTURE_ARRAY_LAYER_SIZE, texture_name);
+    return texture_name;
+}
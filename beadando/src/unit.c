@@ -9,6 +9,27 @@
 
 #define ATTACK_VISUAL_DURATION 0.15f
 
+// Point lights of combat events (see point_lights.h)
+#define HIT_LIGHT_RADIUS 1.5f
+#define HIT_LIGHT_LIFETIME 0.35f
+#define DEATH_LIGHT_RADIUS 2.5f
+#define DEATH_LIGHT_LIFETIME 0.8f
+#define COMBAT_LIGHT_HEIGHT 0.6f
+
+// Particle bursts of combat events (see particles.h)
+#define HIT_SPARK_COUNT 24
+#define DEATH_BURST_COUNT 200
+
+#define COMBAT_TEXT_HEIGHT 1.7f // Damage numbers start just above the HP bar
+
+// Per-tick combat log (targets, attacks, deaths). The stress build compiles it out with
+// UNIT_QUIET_COMBAT_LOG, otherwise formatting it is part of every measured tick (see tools/stress.c)
+#ifdef UNIT_QUIET_COMBAT_LOG
+#define COMBAT_LOG(...) ((void)0)
+#else
+#define COMBAT_LOG(...) printf(__VA_ARGS__)
+#endif
+
 void init_unit(Unit* unit, UnitType type, int grid_x, int grid_y, bool is_player, UnitLocation initial_location) {
     if (!unit) return;
 
@@ -66,6 +87,9 @@ void init_unit(Unit* unit, UnitType type, int grid_x, int grid_y, bool is_player
     unit->is_attacking_visual_active = false;
     unit->attack_visual_timer = 0.0f;
     unit->is_alive = true; // Unit starts alive
+    unit->animation = UNIT_ANIM_IDLE;
+    unit->animation_start = 0.0f;
+    unit->instance_valid = false;
 
     unit->aggro_range = unit->attack_range * 2.5f; // Example: aggro is 2.5x attack range
     if (type == UNIT_RANGED_ARCHER) { // Archers might have same aggro as attack range or slightly more
@@ -86,54 +110,47 @@ void init_unit(Unit* unit, UnitType type, int grid_x, int grid_y, bool is_player
 }
 
 
-void render_unit(const Unit* unit, const struct Scene* scene, GLuint shader_program, const struct App* app) {
-    if (!unit || !scene || !app || !unit->is_alive || unit->location != LOC_BOARD || scene->unit_vaos[unit->type] == 0) {
+void fill_unit_instance(Unit* unit, const struct Scene* scene, InstanceData* instance) {
+    if (!unit || !scene || !instance) {
         return;
     }
 
-    mat4 model_matrix;
-    glm_mat4_identity(model_matrix);
-
-    // --- Make a non-const copy for glm_translate ---
-    vec3 temp_world_pos;
-    glm_vec3_copy(unit->world_pos, temp_world_pos);
-    glm_translate(model_matrix, temp_world_pos); // Pass the non-const copy
-
-    // --- Make a non-const copy for glm_vec3_norm2 ---
-    vec3 temp_facing_direction;
-    glm_vec3_copy(unit->facing_direction, temp_facing_direction);
-    if (glm_vec3_norm2(temp_facing_direction) > 0.001f) {
-        float yaw_angle_rad = atan2f(temp_facing_direction[0], temp_facing_direction[2]); // Use temp copy
-        glm_rotate_y(model_matrix, yaw_angle_rad, model_matrix);
-    }
-
-    mat4 scale_matrix;
-    glm_mat4_identity(scale_matrix);
-    float current_display_scale = 0.8f; // Base display scale for units
-    if (unit->is_attacking_visual_active) {
-        current_display_scale *= 1.20f;
+    // Reuse the cached record while the unit stands still; bobbing, lunges and flashes run in simple.vert
+    if (unit->instance_valid &&
+        glm_vec3_eqv(unit->instance_position, unit->world_pos) &&
+        glm_vec3_eqv(unit->instance_facing, unit->facing_direction) &&
+        unit->instance.animation == (float)unit->animation &&
+        unit->instance.animation_start == unit->animation_start) {
+        *instance = unit->instance;
+        return;
     }
-    glm_scale(scale_matrix, (vec3){current_display_scale, current_display_scale, current_display_scale});
-    glm_mat4_mul(model_matrix, scale_matrix, model_matrix); // Apply final scale
-
 
-    GLint model_uloc = app->shader_uloc_model;
-    if (model_uloc != -1) {
-        glUniformMatrix4fv(model_uloc, 1, GL_FALSE, (const GLfloat*)model_matrix);
+    InstanceData* cached = &unit->instance;
+    glm_mat4_identity(cached->model);
+    glm_translate(cached->model, unit->world_pos);
+    if (glm_vec3_norm2(unit->facing_direction) > 0.001f) {
+        float yaw_angle_rad = atan2f(unit->facing_direction[0], unit->facing_direction[2]);
+        glm_rotate_y(cached->model, yaw_angle_rad, cached->model);
     }
+    float display_scale = 0.8f; // Base display scale for units
+    glm_scale(cached->model, (vec3){display_scale, display_scale, display_scale});
+
+    glm_vec4_one(cached->color_tint);
+    cached->texture_layer = (float)scene->unit_texture_layers[unit->type];
+    cached->animation = (float)unit->animation;
+    cached->animation_start = unit->animation_start;
+    cached->padding = 0.0f;
+
+    glm_vec3_copy(unit->world_pos, unit->instance_position);
+    glm_vec3_copy(unit->facing_direction, unit->instance_facing);
+    unit->instance_valid = true;
+    *instance = *cached;
+}
 
-    if (app->shader_uloc_materialDiffuse != -1) glUniform3fv(app->shader_uloc_materialDiffuse, 1, scene->material.diffuse);
-    if (app->shader_uloc_materialSpecular != -1) glUniform3fv(app->shader_uloc_materialSpecular, 1, scene->material.specular);
-    if (app->shader_uloc_materialShininess != -1) glUniform1f(app->shader_uloc_materialShininess, scene->material.shininess);
-    check_gl_error("Set unit material uniforms");
-
-    glBindTexture(GL_TEXTURE_2D, scene->unit_textures[unit->type]);
-    glBindVertexArray(scene->unit_vaos[unit->type]);
-    GLsizei index_count = scene->unit_index_counts[unit->type];
-    if (index_count > 0) {
-        glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, NULL);
-    }
-    glBindVertexArray(0);
+void start_unit_animation(Unit* unit, UnitAnimation animation, float time) {
+    if (!unit) return;
+    unit->animation = animation;
+    unit->animation_start = time;
 }
 
 
@@ -250,10 +267,10 @@ void update_unit(Unit* unit, struct Scene* scene, float dt, GamePhase current_ph
     // 3.4 Assign new_target_candidate
     if (current_attacker_priority && current_attacker_priority != unit->current_target_ptr) {
         new_target_candidate = current_attacker_priority;
-        printf("DEBUG: Unit %d (ID %d) SWITCHING TARGET to attacker %d (ID %d).\n", unit->type, unit->id, new_target_candidate->type, new_target_candidate->id);
+        COMBAT_LOG("DEBUG: Unit %d (ID %d) SWITCHING TARGET to attacker %d (ID %d).\n", unit->type, unit->id, new_target_candidate->type, new_target_candidate->id);
     } else if (unit->current_target_ptr == NULL && closest_enemy_in_aggro != NULL) {
         new_target_candidate = closest_enemy_in_aggro;
-        printf("DEBUG: Unit %d (ID %d) acquired NEW TARGET (closest in aggro) -> Unit %d (ID %d)\n", unit->type, unit->id, new_target_candidate->type, new_target_candidate->id);
+        COMBAT_LOG("DEBUG: Unit %d (ID %d) acquired NEW TARGET (closest in aggro) -> Unit %d (ID %d)\n", unit->type, unit->id, new_target_candidate->type, new_target_candidate->id);
     }
     // If new_target_candidate is set, update the unit's actual target
     if (new_target_candidate) {
@@ -330,7 +347,23 @@ void update_unit(Unit* unit, struct Scene* scene, float dt, GamePhase current_ph
             unit->is_attacking_visual_active = true;
             unit->attack_visual_timer = ATTACK_VISUAL_DURATION;
             unit->current_target_ptr->current_hp -= unit->attack_damage;
-            printf("DEBUG: Unit %d (P%d, T%d) ATTACKS Unit %d (P%d, T%d) for %.1f dmg. Target HP: %.1f\n",
+            start_unit_animation(unit, UNIT_ANIM_ATTACK, scene->time);
+            start_unit_animation(unit->current_target_ptr, UNIT_ANIM_HIT, scene->time);
+            bool killing_blow = unit->current_target_ptr->current_hp <= 0.0f;
+            vec3 text_pos;
+            glm_vec3_copy(unit->current_target_ptr->world_pos, text_pos);
+            text_pos[1] += COMBAT_TEXT_HEIGHT;
+            spawn_combat_text(&scene->combat_text, text_pos, (int)(unit->attack_damage + 0.5f),
+                              killing_blow ? COMBAT_TEXT_KILL : COMBAT_TEXT_DAMAGE);
+
+            vec3 hit_light_pos;
+            glm_vec3_copy(unit->current_target_ptr->world_pos, hit_light_pos);
+            hit_light_pos[1] += COMBAT_LIGHT_HEIGHT;
+            vec3 hit_light_color = {1.0f, 0.6f, 0.2f}; // Melee: orange
+            if (unit->type == UNIT_RANGED_ARCHER) glm_vec3_copy((vec3){0.3f, 0.6f, 1.0f}, hit_light_color); // Ranged: blue
+            spawn_point_light(&scene->point_lights, hit_light_pos, hit_light_color, HIT_LIGHT_RADIUS, HIT_LIGHT_LIFETIME);
+            emit_particles(&scene->particles, PARTICLE_HIT_SPARK, hit_light_pos, HIT_SPARK_COUNT);
+            COMBAT_LOG("DEBUG: Unit %d (P%d, T%d) ATTACKS Unit %d (P%d, T%d) for %.1f dmg. Target HP: %.1f\n",
                    unit->id, unit->is_player_unit, unit->type,
                    unit->current_target_ptr->id, unit->current_target_ptr->is_player_unit, unit->current_target_ptr->type,
                    unit->attack_damage, unit->current_target_ptr->current_hp);
@@ -338,7 +371,11 @@ void update_unit(Unit* unit, struct Scene* scene, float dt, GamePhase current_ph
             if (unit->current_target_ptr->current_hp <= 0.0f) {
                 unit->current_target_ptr->current_hp = 0.0f;
                 unit->current_target_ptr->is_alive = false;
-                printf("DEBUG: Unit %d (ID %d) has died!\n", unit->current_target_ptr->type, unit->current_target_ptr->id);
+                start_unit_animation(unit->current_target_ptr, UNIT_ANIM_DEATH, scene->time);
+                spawn_point_light(&scene->point_lights, hit_light_pos, (vec3){1.0f, 0.15f, 0.1f},
+                                  DEATH_LIGHT_RADIUS, DEATH_LIGHT_LIFETIME);
+                emit_particles(&scene->particles, PARTICLE_DEATH_BURST, hit_light_pos, DEATH_BURST_COUNT);
+                COMBAT_LOG("DEBUG: Unit %d (ID %d) has died!\n", unit->current_target_ptr->type, unit->current_target_ptr->id);
                 unit->current_target_ptr = NULL;
                 unit->current_combat_state = UNIT_STATE_IDLE; // Re-evaluate next frame
             }
@@ -3,6 +3,7 @@
 // #include <math.h>      // Not directly needed by this function
 #include <glad/glad.h> // For GL types and glGetError()
 #include <stdio.h>     // For fprintf, stderr
+#include <string.h>    // For strcmp
 
 void _check_gl_error(const char *file, int line, const char* operation_name) { // Changed signature
     GLenum err;
@@ -19,4 +20,28 @@ void _check_gl_error(const char *file, int line, const char* operation_name) { /
             default: fprintf(stderr, "Unknown error\n"); break;
         }
     }
-}
\ No newline at end of file
+}
+
+uint64_t hash_fnv1a64(uint64_t seed, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull; // FNV-1a 64 prime
+    }
+    return hash;
+}
+
+bool has_gl_extension(const char* name) {
+    if (!name) return false;
+
+    GLint extension_count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+    for (GLint i = 0; i < extension_count; ++i) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
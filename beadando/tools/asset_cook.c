@@ -0,0 +1,381 @@
+#include "mesh_cook.h"
+#include "texture_cook.h"
+#include "asset_paths.h"
+#include "utils.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+/**
+ * Offline asset cooker.
+ * Usage: assetcook [--compress] [--force] [-j <threads>] [assets directory]
+ * Walks the asset tree (default "assets") and cooks every source into its cooked/ subdirectory, in parallel:
+ *   models/<name>.obj   -> cooked/models/<name>.mesh  (see mesh_cook.c)
+ *   textures/<name>.png -> cooked/textures/<name>.tex (see texture_cook.c)
+ * Inputs whose content hash matches the manifest of the previous run are skipped.
+ */
+
+#define MAX_COOK_JOBS 256
+#define MAX_COOK_THREADS 16
+#define COOKED_SUBDIR "cooked"
+#define COOK_MANIFEST_NAME "manifest.txt"
+
+// Bump when a cooker's output changes, so every asset of that kind is re-cooked
+#define MESH_COOK_VERSION 1
+#define TEXTURE_COOK_VERSION 1
+
+typedef enum {
+    COOK_MESH,
+    COOK_TEXTURE
+} CookKind;
+
+typedef enum {
+    COOK_PENDING,
+    COOK_SKIPPED,
+    COOK_DONE,
+    COOK_FAILED
+} CookResult;
+
+typedef struct CookJob
+{
+    CookKind kind;
+    char source_path[ASSET_PATH_MAX];
+    char output_path[ASSET_PATH_MAX];
+    uint64_t hash;
+    CookResult result;
+} CookJob;
+
+typedef struct ManifestEntry
+{
+    char source_path[ASSET_PATH_MAX];
+    uint64_t hash;
+} ManifestEntry;
+
+typedef struct CookContext
+{
+    CookJob jobs[MAX_COOK_JOBS];
+    int job_count;
+    SDL_atomic_t next_job;
+
+    ManifestEntry manifest[MAX_COOK_JOBS];
+    int manifest_count;
+
+    char asset_dir[ASSET_PATH_MAX];     // Without the trailing slash
+    char cooked_dir[ASSET_PATH_MAX];    // <asset_dir>/cooked
+    char manifest_path[ASSET_PATH_MAX]; // <asset_dir>/cooked/manifest.txt
+
+    bool compress;
+    bool force;
+} CookContext;
+
+// --- Content hashes ---
+
+static bool hash_file(const char* path, uint64_t seed, uint64_t* out_hash)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    uint64_t hash = FNV1A64_OFFSET_BASIS ^ seed;
+    unsigned char buffer[64 * 1024];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        hash = hash_fnv1a64(hash, buffer, read);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    *out_hash = hash;
+    return ok;
+}
+
+static bool file_exists(const char* path)
+{
+    struct stat file_stat;
+    return stat(path, &file_stat) == 0;
+}
+
+// --- Manifest ---
+
+static void load_manifest(CookContext* context)
+{
+    context->manifest_count = 0;
+    FILE* file = fopen(context->manifest_path, "r");
+    if (!file) return; // First run
+
+    char line[ASSET_PATH_MAX + 32];
+    while (context->manifest_count < MAX_COOK_JOBS && fgets(line, sizeof(line), file)) {
+        ManifestEntry* entry = &context->manifest[context->manifest_count];
+        unsigned long long hash = 0;
+        char path[ASSET_PATH_MAX];
+        if (sscanf(line, "%16llx %511s", &hash, path) == 2) {
+            entry->hash = (uint64_t)hash;
+            strcpy(entry->source_path, path);
+            context->manifest_count++;
+        }
+    }
+    fclose(file);
+}
+
+static const ManifestEntry* find_manifest_entry(const CookContext* context, const char* source_path)
+{
+    for (int i = 0; i < context->manifest_count; ++i) {
+        if (strcmp(context->manifest[i].source_path, source_path) == 0) return &context->manifest[i];
+    }
+    return NULL;
+}
+
+static bool save_manifest(const CookContext* context)
+{
+    if (!make_parent_directories(context->manifest_path)) return false;
+    FILE* file = fopen(context->manifest_path, "w");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot write '%s'\n", context->manifest_path);
+        return false;
+    }
+    // Failed jobs are left out so they are retried on the next run
+    for (int i = 0; i < context->job_count; ++i) {
+        const CookJob* job = &context->jobs[i];
+        if (job->result == COOK_DONE || job->result == COOK_SKIPPED) {
+            fprintf(file, "%016llx %s\n", (unsigned long long)job->hash, job->source_path);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+// --- Asset tree walk ---
+
+static bool has_extension(const char* path, const char* extension)
+{
+    size_t path_length = strlen(path);
+    size_t extension_length = strlen(extension);
+    if (path_length < extension_length) return false;
+    const char* tail = path + path_length - extension_length;
+    for (size_t i = 0; i < extension_length; ++i) {
+        char c = tail[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != extension[i]) return false;
+    }
+    return true;
+}
+
+// <asset_dir>/models/x.obj -> <asset_dir>/cooked/models/x.mesh, the layout get_cooked_asset_path looks up
+static bool get_output_path(const CookContext* context, const char* source_path, const char* cooked_extension,
+                            char* out_path, size_t out_size)
+{
+    const char* relative_path = source_path + strlen(context->asset_dir); // collect_jobs joins onto asset_dir
+    size_t stem_length = strlen(relative_path);
+    const char* last_dot = strrchr(relative_path, '.');
+    const char* last_slash = strrchr(relative_path, '/');
+    if (last_dot && (!last_slash || last_dot > last_slash)) {
+        stem_length = (size_t)(last_dot - relative_path);
+    }
+    int written = snprintf(out_path, out_size, "%s%.*s%s",
+                           context->cooked_dir, (int)stem_length, relative_path, cooked_extension);
+    return written > 0 && (size_t)written < out_size;
+}
+
+static void add_job(CookContext* context, const char* source_path)
+{
+    CookKind kind;
+    const char* cooked_extension;
+    if (has_extension(source_path, ".obj")) {
+        kind = COOK_MESH;
+        cooked_extension = ".mesh";
+    } else if (has_extension(source_path, ".png") || has_extension(source_path, ".jpg")) {
+        kind = COOK_TEXTURE;
+        cooked_extension = ".tex";
+    } else {
+        return; // Not a cookable source (.mtl etc.)
+    }
+
+    if (context->job_count >= MAX_COOK_JOBS) {
+        fprintf(stderr, "[WARN] Too many assets, skipping '%s' (limit %d)\n", source_path, MAX_COOK_JOBS);
+        return;
+    }
+    CookJob* job = &context->jobs[context->job_count];
+    memset(job, 0, sizeof(CookJob));
+    job->kind = kind;
+    if (strlen(source_path) >= sizeof(job->source_path) ||
+        !get_output_path(context, source_path, cooked_extension, job->output_path, sizeof(job->output_path))) {
+        fprintf(stderr, "ERROR: Path too long: '%s'\n", source_path);
+        return;
+    }
+    strcpy(job->source_path, source_path);
+    job->result = COOK_PENDING;
+    context->job_count++;
+}
+
+// Never descend into the output tree
+static bool is_cooked_directory(const CookContext* context, const char* path)
+{
+    return strcmp(path, context->cooked_dir) == 0;
+}
+
+static void collect_jobs(CookContext* context, const char* directory)
+{
+    char path[ASSET_PATH_MAX];
+
+#ifdef _WIN32
+    char pattern[ASSET_PATH_MAX];
+    snprintf(pattern, sizeof(pattern), "%s/*", directory);
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE) return;
+    do {
+        const char* name = entry.cFileName;
+        if (name[0] == '.') continue;
+        if ((size_t)snprintf(path, sizeof(path), "%s/%s", directory, name) >= sizeof(path)) continue;
+        if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (!is_cooked_directory(context, path)) {
+                collect_jobs(context, path);
+            }
+        } else {
+            add_job(context, path);
+        }
+    } while (FindNextFileA(find, &entry));
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory);
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char* name = entry->d_name;
+        if (name[0] == '.') continue;
+        if ((size_t)snprintf(path, sizeof(path), "%s/%s", directory, name) >= sizeof(path)) continue;
+
+        struct stat file_stat;
+        if (stat(path, &file_stat) != 0) continue;
+        if (S_ISDIR(file_stat.st_mode)) {
+            if (!is_cooked_directory(context, path)) {
+                collect_jobs(context, path);
+            }
+        } else {
+            add_job(context, path);
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+// --- Workers ---
+
+static void run_job(CookContext* context, CookJob* job)
+{
+    uint64_t seed = job->kind == COOK_MESH ? (uint64_t)MESH_COOK_VERSION << 8
+                                           : ((uint64_t)TEXTURE_COOK_VERSION << 8) | (context->compress ? 1u : 0u);
+    seed |= (uint64_t)job->kind << 32;
+    if (!hash_file(job->source_path, seed, &job->hash)) {
+        fprintf(stderr, "ERROR: Cannot read '%s'\n", job->source_path);
+        job->result = COOK_FAILED;
+        return;
+    }
+
+    const ManifestEntry* previous = find_manifest_entry(context, job->source_path);
+    if (!context->force && previous && previous->hash == job->hash && file_exists(job->output_path)) {
+        job->result = COOK_SKIPPED;
+        return;
+    }
+
+    bool ok = job->kind == COOK_MESH ? cook_mesh(job->source_path, job->output_path)
+                                     : cook_texture(job->source_path, job->output_path, context->compress);
+    job->result = ok ? COOK_DONE : COOK_FAILED;
+}
+
+static int cook_worker(void* data)
+{
+    CookContext* context = (CookContext*)data;
+    for (;;) {
+        int index = SDL_AtomicAdd(&context->next_job, 1);
+        if (index >= context->job_count) break;
+        run_job(context, &context->jobs[index]);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    static CookContext context; // Too big for the stack
+    const char* asset_dir = "assets";
+    int thread_count = SDL_GetCPUCount();
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--compress") == 0) {
+            context.compress = true;
+        } else if (strcmp(argv[i], "--force") == 0) {
+            context.force = true;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            thread_count = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            asset_dir = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [--compress] [--force] [-j <threads>] [assets directory]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > MAX_COOK_THREADS) thread_count = MAX_COOK_THREADS;
+
+    // Every path below is built from the asset directory, so "assets", "assets/" and "../game/assets" all work
+    size_t asset_dir_length = strlen(asset_dir);
+    while (asset_dir_length > 1 && asset_dir[asset_dir_length - 1] == '/') asset_dir_length--;
+    if (asset_dir_length >= sizeof(context.asset_dir) ||
+        (size_t)snprintf(context.cooked_dir, sizeof(context.cooked_dir), "%.*s/" COOKED_SUBDIR,
+                         (int)asset_dir_length, asset_dir) >= sizeof(context.cooked_dir) ||
+        (size_t)snprintf(context.manifest_path, sizeof(context.manifest_path), "%s/" COOK_MANIFEST_NAME,
+                         context.cooked_dir) >= sizeof(context.manifest_path)) {
+        fprintf(stderr, "ERROR: Path too long: '%s'\n", asset_dir);
+        return 1;
+    }
+    memcpy(context.asset_dir, asset_dir, asset_dir_length);
+    context.asset_dir[asset_dir_length] = '\0';
+
+    collect_jobs(&context, context.asset_dir);
+    load_manifest(&context);
+    if (thread_count > context.job_count) thread_count = context.job_count > 0 ? context.job_count : 1;
+    printf("[INFO] %d cookable assets in '%s', %d threads\n", context.job_count, context.asset_dir, thread_count);
+
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    SDL_AtomicSet(&context.next_job, 0);
+    SDL_Thread* threads[MAX_COOK_THREADS];
+    int started = 0;
+    for (int i = 1; i < thread_count; ++i) { // The main thread is worker 0
+        threads[started] = SDL_CreateThread(cook_worker, "cook_worker", &context);
+        if (threads[started]) started++;
+    }
+    cook_worker(&context);
+    for (int i = 0; i < started; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    IMG_Quit();
+
+    int cooked = 0, skipped = 0, failed = 0;
+    for (int i = 0; i < context.job_count; ++i) {
+        switch (context.jobs[i].result) {
+            case COOK_DONE: cooked++; break;
+            case COOK_SKIPPED: skipped++; break;
+            default:
+                failed++;
+                fprintf(stderr, "ERROR: Failed to cook '%s'\n", context.jobs[i].source_path);
+                break;
+        }
+    }
+    save_manifest(&context);
+
+    printf("[INFO] Cooked %d, up to date %d, failed %d (%.2f s)\n", cooked, skipped, failed, seconds);
+    return failed == 0 ? 0 : 1;
+}
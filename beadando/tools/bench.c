@@ -0,0 +1,854 @@
+#include "board.h"
+#include "job_system.h"
+#include "scene.h"
+#include "unit.h"
+#include "matrix.h"
+
+#include <obj/load.h>
+#include <obj/model.h>
+
+#include <SDL2/SDL.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * Microbenchmarks of the engine's hot functions.
+ * Usage: enginebench [-o <results.json>] [--baseline <baseline.json>] [--threshold <percent>]
+ *                    [--filter <text>] [--repetitions <n>] [--model <file.obj>] [--verbose]
+ *        enginebench --selftest
+ * Every benchmark is calibrated so one repetition takes about BENCH_TARGET_REPETITION_NS, warmed up,
+ * then measured; the median and p95 per call are reported and written as JSON together with the
+ * machine info. With --baseline the medians are compared to a saved run and any benchmark slower
+ * than the threshold fails the run (exit code 1).
+ * The engine's debug output is discarded while measuring unless --verbose is given.
+ * --selftest checks the job system instead of timing it (see run_job_selftest); exit code 1 on a failure.
+ */
+
+#define BENCH_WARMUP_REPETITIONS 3
+#define BENCH_DEFAULT_REPETITIONS 31
+#define BENCH_TARGET_REPETITION_NS 2000000.0 // Calibrated inner loop length (2 ms)
+#define BENCH_MAX_ITERATIONS (1 << 20)
+#define BENCH_DEFAULT_THRESHOLD 10.0         // Percent slower than the baseline that counts as a regression
+#define BENCH_DEFAULT_OUTPUT "bench_results.json"
+#define BENCH_GENERATED_MODEL "bench_sphere.obj"
+#define BENCH_TIME_STEP (1.0f / 60.0f)
+#define BENCH_PICK_POINTS 1024
+#define BENCH_JOB_COUNT 1024
+#define BENCH_FOR_ITEMS (1 << 16)
+#define SELFTEST_FOR_ITEMS 100003   // Prime, so the last batch is a partial one
+#define SELFTEST_CHAINS 64
+#define SELFTEST_MAIN_JOBS 64
+#define SELFTEST_OUTER_JOBS 256     // Each spawns SELFTEST_INNER_JOBS and waits on them inside the job
+#define SELFTEST_INNER_JOBS 16
+#define SELFTEST_MIN_WORKERS 3      // The self-test needs real workers even on a small machine
+
+#define MAX_BENCH_RESULTS 64
+#define MAX_BENCH_NAME 64
+
+typedef void (*BenchFunction)(void* context, int iterations);
+
+typedef struct BenchResult
+{
+    char name[MAX_BENCH_NAME];
+    int iterations;  // Calls per repetition
+    int repetitions;
+    double median_ns; // Per call
+    double p95_ns;
+    double min_ns;
+    double mean_ns;
+} BenchResult;
+
+typedef struct BenchSuite
+{
+    BenchResult results[MAX_BENCH_RESULTS];
+    int result_count;
+    int repetitions;
+    const char* filter;
+} BenchSuite;
+
+static volatile float bench_sink; // Keeps results alive so the optimizer cannot drop the work
+
+// --- Harness ---
+
+static double elapsed_ns(Uint64 start, Uint64 end)
+{
+    return (double)(end - start) * 1.0e9 / (double)SDL_GetPerformanceFrequency();
+}
+
+static double time_iterations(BenchFunction function, void* context, int iterations)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    function(context, iterations);
+    return elapsed_ns(start, SDL_GetPerformanceCounter());
+}
+
+static int compare_doubles(const void* a, const void* b)
+{
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static void run_benchmark(BenchSuite* suite, const char* name, BenchFunction function, void* context)
+{
+    if (suite->filter && !strstr(name, suite->filter)) return;
+    if (suite->result_count >= MAX_BENCH_RESULTS) {
+        fprintf(stderr, "[WARN] Too many benchmarks, skipping '%s' (limit %d)\n", name, MAX_BENCH_RESULTS);
+        return;
+    }
+
+    // Grow the inner loop until a repetition is long enough for the timer resolution
+    int iterations = 1;
+    while (iterations < BENCH_MAX_ITERATIONS && time_iterations(function, context, iterations) < BENCH_TARGET_REPETITION_NS / 2.0) {
+        iterations *= 2;
+    }
+    for (int i = 0; i < BENCH_WARMUP_REPETITIONS; ++i) {
+        time_iterations(function, context, iterations);
+    }
+
+    double* samples = (double*)malloc((size_t)suite->repetitions * sizeof(double));
+    if (!samples) return;
+    double sum = 0.0;
+    for (int i = 0; i < suite->repetitions; ++i) {
+        samples[i] = time_iterations(function, context, iterations) / iterations;
+        sum += samples[i];
+    }
+    qsort(samples, (size_t)suite->repetitions, sizeof(double), compare_doubles);
+
+    BenchResult* result = &suite->results[suite->result_count++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->iterations = iterations;
+    result->repetitions = suite->repetitions;
+    result->median_ns = samples[suite->repetitions / 2];
+    result->p95_ns = samples[(int)(suite->repetitions * 0.95)];
+    result->min_ns = samples[0];
+    result->mean_ns = sum / suite->repetitions;
+    free(samples);
+
+    fprintf(stderr, "%-32s %12.1f ns  p95 %12.1f ns  (%d x %d)\n",
+            result->name, result->median_ns, result->p95_ns, result->repetitions, result->iterations);
+}
+
+// --- Model loading ---
+
+typedef struct ModelBench
+{
+    const char* path;
+    Model model; // Loaded once for the vertex data benchmark
+} ModelBench;
+
+/**
+ * UV sphere, so the loader has a fixed workload when no model is given (assets ship without .obj sources).
+ */
+static bool write_sphere_model(const char* path, int slices, int stacks)
+{
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    for (int stack = 0; stack <= stacks; ++stack) {
+        float phi = GLM_PIf * (float)stack / (float)stacks;
+        for (int slice = 0; slice <= slices; ++slice) {
+            float theta = 2.0f * GLM_PIf * (float)slice / (float)slices;
+            float x = sinf(phi) * cosf(theta), y = cosf(phi), z = sinf(phi) * sinf(theta);
+            fprintf(file, "v %f %f %f\nvt %f %f\nvn %f %f %f\n", x, y, z,
+                    (float)slice / (float)slices, (float)stack / (float)stacks, x, y, z);
+        }
+    }
+    for (int stack = 0; stack < stacks; ++stack) {
+        for (int slice = 0; slice < slices; ++slice) {
+            int a = stack * (slices + 1) + slice + 1; // OBJ indices start at 1
+            int b = a + slices + 1;
+            fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, a + 1, a + 1, a + 1);
+            fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a + 1, a + 1, a + 1, b, b, b, b + 1, b + 1, b + 1);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+static void bench_load_model(void* context, int iterations)
+{
+    ModelBench* bench = (ModelBench*)context;
+    for (int i = 0; i < iterations; ++i) {
+        Model model;
+        init_model(&model);
+        if (load_model(&model, bench->path)) bench_sink += (float)model.n_triangles;
+        free_model(&model);
+    }
+}
+
+static void bench_model_vertex_data(void* context, int iterations)
+{
+    ModelBench* bench = (ModelBench*)context;
+    for (int i = 0; i < iterations; ++i) {
+        VertexData* vertices = NULL;
+        GLuint* indices = NULL;
+        GLsizei index_count = 0;
+        if (build_model_vertex_data(&bench->model, &vertices, &indices, &index_count)) {
+            bench_sink += vertices[index_count / 2].position[0];
+        }
+        free(vertices);
+        free(indices);
+    }
+}
+
+// --- Units ---
+
+typedef struct UnitBench
+{
+    Scene* scene;
+    Unit units[MAX_UNITS]; // Starting line-up, restored before every step
+    int unit_count;
+} UnitBench;
+
+/**
+ * Fills both halves of the board row by row, mixing tanks and archers.
+ */
+static void setup_unit_bench(UnitBench* bench, Scene* scene, int unit_count)
+{
+    memset(scene, 0, sizeof(Scene));
+    bench->scene = scene;
+    bench->unit_count = 0;
+    int half = BOARD_GRID_HEIGHT / 2;
+    for (int n = 0; n < unit_count && n < MAX_UNITS; ++n) {
+        bool player = (n % 2) == 0;
+        int slot = n / 2;
+        int x = slot % BOARD_GRID_WIDTH;
+        int row = slot / BOARD_GRID_WIDTH;
+        int y = player ? half - 1 - row : half + row;
+        if (y < 0 || y >= BOARD_GRID_HEIGHT) break;
+        UnitType type = (slot % 3 == 2) ? UNIT_RANGED_ARCHER : UNIT_MELEE_TANK;
+        init_unit(&bench->units[bench->unit_count++], type, x, y, player, LOC_BOARD);
+    }
+}
+
+static void reset_unit_bench(UnitBench* bench)
+{
+    Scene* scene = bench->scene;
+    memcpy(scene->units, bench->units, (size_t)bench->unit_count * sizeof(Unit));
+    scene->unit_count = bench->unit_count;
+    scene->combat_text.count = 0;
+    scene->point_lights.count = 0;
+}
+
+static void bench_update_units(void* context, int iterations)
+{
+    UnitBench* bench = (UnitBench*)context;
+    for (int i = 0; i < iterations; ++i) {
+        reset_unit_bench(bench);
+        for (int u = 0; u < bench->scene->unit_count; ++u) {
+            update_unit(&bench->scene->units[u], bench->scene, BENCH_TIME_STEP, PHASE_COMBAT);
+        }
+    }
+    bench_sink += bench->scene->units[0].facing_direction[0];
+}
+
+static void bench_try_move_step(void* context, int iterations)
+{
+    UnitBench* bench = (UnitBench*)context;
+    for (int i = 0; i < iterations; ++i) {
+        reset_unit_bench(bench);
+        for (int u = 0; u < bench->scene->unit_count; ++u) {
+            Unit* unit = &bench->scene->units[u];
+            int target_y = unit->is_player_unit ? BOARD_GRID_HEIGHT - 1 : 0; // Toward the other side
+            bench_sink += try_move_step(bench->scene, unit, BOARD_GRID_WIDTH - 1 - unit->grid_x, target_y) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+static void bench_is_tile_walkable(void* context, int iterations)
+{
+    UnitBench* bench = (UnitBench*)context;
+    reset_unit_bench(bench);
+    const Unit* mover = &bench->scene->units[0];
+    int walkable = 0;
+    for (int i = 0; i < iterations; ++i) {
+        for (int y = 0; y < BOARD_GRID_HEIGHT; ++y) {
+            for (int x = 0; x < BOARD_GRID_WIDTH; ++x) {
+                walkable += is_tile_walkable(bench->scene, x, y, mover);
+            }
+        }
+    }
+    bench_sink += (float)walkable;
+}
+
+// --- Picking ---
+
+typedef struct PickBench
+{
+    vec3 points[BENCH_PICK_POINTS]; // Spread over the board and a margin around it
+} PickBench;
+
+static void bench_world_to_grid_pos(void* context, int iterations)
+{
+    PickBench* bench = (PickBench*)context;
+    int hits = 0;
+    for (int i = 0; i < iterations; ++i) {
+        for (int p = 0; p < BENCH_PICK_POINTS; ++p) {
+            int grid_x, grid_y;
+            if (world_to_grid_pos(bench->points[p], &grid_x, &grid_y)) hits += grid_x + grid_y;
+        }
+    }
+    bench_sink += (float)hits;
+}
+
+// --- Matrices (feladatok/02) ---
+
+typedef struct MatrixBench
+{
+    float a[3][3];
+    float b[3][3];
+    float points[BENCH_PICK_POINTS][3];
+    MatrixStack stack;
+} MatrixBench;
+
+static void bench_multiply_matrices(void* context, int iterations)
+{
+    MatrixBench* bench = (MatrixBench*)context;
+    float c[3][3];
+    for (int i = 0; i < iterations; ++i) {
+        multiply_matrices(bench->a, bench->b, c);
+        bench->a[0][0] = c[0][0] * 0.5f; // Chain the calls so they cannot be hoisted
+    }
+    bench_sink += c[1][1];
+}
+
+static void bench_transform_point(void* context, int iterations)
+{
+    MatrixBench* bench = (MatrixBench*)context;
+    float result[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < iterations; ++i) {
+        for (int p = 0; p < BENCH_PICK_POINTS; ++p) {
+            transform_point(bench->b, bench->points[p], result);
+        }
+    }
+    bench_sink += result[0];
+}
+
+static void bench_matrix_transforms(void* context, int iterations)
+{
+    (void)context;
+    float m[3][3];
+    for (int i = 0; i < iterations; ++i) {
+        init_identity_matrix(m);
+        scale(m, 1.5f, 0.5f);
+        rotate(m, 0.3f);
+        shift(m, 2.0f, -1.0f);
+    }
+    bench_sink += m[0][2];
+}
+
+static void bench_matrix_stack(void* context, int iterations)
+{
+    MatrixBench* bench = (MatrixBench*)context;
+    float m[3][3];
+    for (int i = 0; i < iterations; ++i) {
+        init_stack(&bench->stack);
+        for (int d = 0; d < MAX_STACK_DEPTH; ++d) push_matrix(&bench->stack, bench->a);
+        for (int d = 0; d < MAX_STACK_DEPTH; ++d) pop_matrix(&bench->stack, m);
+    }
+    bench_sink += m[2][2];
+}
+
+// --- Job system ---
+
+typedef struct JobBench
+{
+    float values[BENCH_FOR_ITEMS];
+    float results[BENCH_FOR_ITEMS];
+} JobBench;
+
+static void empty_job(void* data)
+{
+    (void)data;
+}
+
+static void bench_empty_jobs(void* context, int iterations)
+{
+    (void)context;
+    for (int i = 0; i < iterations; ++i) {
+        JobCounter counter = {{0}};
+        for (int j = 0; j < BENCH_JOB_COUNT; ++j) {
+            run_job(empty_job, NULL, &counter);
+        }
+        wait_for_job_counter(&counter);
+    }
+}
+
+static void transform_values(int begin, int end, void* data)
+{
+    JobBench* bench = (JobBench*)data;
+    for (int i = begin; i < end; ++i) {
+        bench->results[i] = sqrtf(bench->values[i]) * sinf(bench->values[i]);
+    }
+}
+
+static void bench_serial_for(void* context, int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        transform_values(0, BENCH_FOR_ITEMS, context);
+    }
+    bench_sink += ((JobBench*)context)->results[BENCH_FOR_ITEMS / 2];
+}
+
+static void bench_parallel_for(void* context, int iterations)
+{
+    for (int i = 0; i < iterations; ++i) {
+        parallel_for(BENCH_FOR_ITEMS, 1024, transform_values, context);
+    }
+    bench_sink += ((JobBench*)context)->results[BENCH_FOR_ITEMS / 2];
+}
+
+// --- Job system self-test ---
+
+typedef struct ForCoverage
+{
+    unsigned char hits[SELFTEST_FOR_ITEMS];
+    SDL_atomic_t items; // Sum of the batch sizes
+} ForCoverage;
+
+typedef struct JobChain
+{
+    SDL_atomic_t step; // 0 -> A -> 1 -> B -> 2 -> C -> 3
+    SDL_atomic_t out_of_order;
+    JobCounter a, b, c;
+} JobChain;
+
+typedef struct MainThreadCheck
+{
+    SDL_threadID main_thread;
+    SDL_atomic_t inside_run;       // Set by the test around run_main_thread_jobs
+    SDL_atomic_t ran;
+    SDL_atomic_t wrong_place;      // Ran off the main thread or outside run_main_thread_jobs
+    JobCounter counter;
+} MainThreadCheck;
+
+typedef struct LoadCheck
+{
+    SDL_threadID main_thread;
+    SDL_atomic_t inner_ran;
+    SDL_atomic_t off_main_thread; // Jobs pushed by the main thread and stolen by a worker
+} LoadCheck;
+
+static void spin_briefly(int rounds)
+{
+    volatile float value = 1.0f; // Local: bench_sink is not safe to write from several jobs
+    for (int i = 0; i < rounds; ++i) value = value * 1.0001f + 0.5f;
+}
+
+static void cover_range(int begin, int end, void* data)
+{
+    ForCoverage* coverage = (ForCoverage*)data;
+    for (int i = begin; i < end; ++i) coverage->hits[i]++;
+    SDL_AtomicAdd(&coverage->items, end - begin);
+}
+
+static void advance_chain(JobChain* chain, int expected_step)
+{
+    if (SDL_AtomicGet(&chain->step) != expected_step) SDL_AtomicIncRef(&chain->out_of_order);
+    SDL_AtomicSet(&chain->step, expected_step + 1);
+}
+
+static void chain_a(void* data)
+{
+    spin_briefly(20000); // Keeps A running while B and C are submitted, so they wait in the pending list
+    advance_chain((JobChain*)data, 0);
+}
+
+static void chain_b(void* data)
+{
+    advance_chain((JobChain*)data, 1);
+}
+
+static void chain_c(void* data)
+{
+    advance_chain((JobChain*)data, 2);
+}
+
+static void record_main_thread_job(void* data)
+{
+    MainThreadCheck* check = (MainThreadCheck*)data;
+    if (SDL_ThreadID() != check->main_thread || !SDL_AtomicGet(&check->inside_run)) {
+        SDL_AtomicIncRef(&check->wrong_place);
+    }
+    SDL_AtomicIncRef(&check->ran);
+}
+
+static void queue_main_thread_job(void* data)
+{
+    MainThreadCheck* check = (MainThreadCheck*)data;
+    run_main_thread_job(record_main_thread_job, check, &check->counter);
+}
+
+static void inner_load_job(void* data)
+{
+    spin_briefly(2000);
+    SDL_AtomicIncRef(&((LoadCheck*)data)->inner_ran);
+}
+
+static void outer_load_job(void* data)
+{
+    LoadCheck* check = (LoadCheck*)data;
+    if (SDL_ThreadID() != check->main_thread) SDL_AtomicIncRef(&check->off_main_thread);
+    JobCounter counter = {{0}};
+    for (int i = 0; i < SELFTEST_INNER_JOBS; ++i) {
+        run_job(inner_load_job, check, &counter);
+    }
+    wait_for_job_counter(&counter);
+}
+
+static bool report_check(bool passed, const char* what)
+{
+    fprintf(stderr, "%s %s\n", passed ? "[ OK ]" : "[FAIL]", what);
+    return passed;
+}
+
+/**
+ * Exercises every path of the job system: parallel_for coverage, dependency chains through the
+ * pending list, the main-thread queue and stealing with nested waits under load.
+ * @return Number of failed checks.
+ */
+static int run_job_selftest(void)
+{
+    int failures = 0;
+    char what[128];
+
+    static ForCoverage coverage; // Too big for the stack
+    parallel_for(SELFTEST_FOR_ITEMS, 1000, cover_range, &coverage);
+    int wrong_hits = 0;
+    for (int i = 0; i < SELFTEST_FOR_ITEMS; ++i) {
+        if (coverage.hits[i] != 1) wrong_hits++;
+    }
+    snprintf(what, sizeof(what), "parallel_for covers %d items exactly once (%d covered, %d wrong)",
+             SELFTEST_FOR_ITEMS, SDL_AtomicGet(&coverage.items), wrong_hits);
+    failures += !report_check(wrong_hits == 0 && SDL_AtomicGet(&coverage.items) == SELFTEST_FOR_ITEMS, what);
+
+    static JobChain chains[SELFTEST_CHAINS];
+    for (int i = 0; i < SELFTEST_CHAINS; ++i) {
+        run_job(chain_a, &chains[i], &chains[i].a);
+        run_job_after(chain_b, &chains[i], &chains[i].a, &chains[i].b);
+        run_job_after(chain_c, &chains[i], &chains[i].b, &chains[i].c);
+    }
+    int broken_chains = 0;
+    for (int i = 0; i < SELFTEST_CHAINS; ++i) {
+        wait_for_job_counter(&chains[i].c);
+        if (SDL_AtomicGet(&chains[i].step) != 3 || SDL_AtomicGet(&chains[i].out_of_order) != 0) broken_chains++;
+    }
+    snprintf(what, sizeof(what), "run_job_after runs %d A->B->C chains in order (%d broken)", SELFTEST_CHAINS,
+             broken_chains);
+    failures += !report_check(broken_chains == 0, what);
+
+    // Workers queue the main-thread jobs; the main thread only polls until it calls run_main_thread_jobs
+    static MainThreadCheck main_check;
+    main_check.main_thread = SDL_ThreadID();
+    JobCounter queued = {{0}};
+    for (int i = 0; i < SELFTEST_MAIN_JOBS; ++i) {
+        run_job(queue_main_thread_job, &main_check, &queued);
+    }
+    while (!is_job_counter_done(&queued)) SDL_Delay(1); // Not wait_for_job_counter: it runs main-thread jobs
+    int ran_early = SDL_AtomicGet(&main_check.ran);
+    SDL_AtomicSet(&main_check.inside_run, 1);
+    int run_count = run_main_thread_jobs();
+    SDL_AtomicSet(&main_check.inside_run, 0);
+    snprintf(what, sizeof(what), "run_main_thread_job runs %d jobs only in run_main_thread_jobs on the main thread "
+             "(%d early, %d run, %d misplaced)", SELFTEST_MAIN_JOBS, ran_early, run_count,
+             SDL_AtomicGet(&main_check.wrong_place));
+    failures += !report_check(ran_early == 0 && run_count == SELFTEST_MAIN_JOBS &&
+                              SDL_AtomicGet(&main_check.wrong_place) == 0 && is_job_counter_done(&main_check.counter),
+                              what);
+
+    static LoadCheck load_check;
+    load_check.main_thread = SDL_ThreadID();
+    JobCounter outer = {{0}};
+    for (int i = 0; i < SELFTEST_OUTER_JOBS; ++i) {
+        run_job(outer_load_job, &load_check, &outer);
+    }
+    wait_for_job_counter(&outer);
+    int inner_ran = SDL_AtomicGet(&load_check.inner_ran);
+    int stolen = SDL_AtomicGet(&load_check.off_main_thread);
+    snprintf(what, sizeof(what), "counters reach zero under load with stealing (%d of %d inner jobs, %d stolen)",
+             inner_ran, SELFTEST_OUTER_JOBS * SELFTEST_INNER_JOBS, stolen);
+    failures += !report_check(is_job_counter_done(&outer) && inner_ran == SELFTEST_OUTER_JOBS * SELFTEST_INNER_JOBS &&
+                              stolen > 0, what);
+    return failures;
+}
+
+// --- Report ---
+
+static void write_machine_info(FILE* file)
+{
+    char cpu_name[128] = "unknown";
+#ifdef __linux__
+    FILE* cpuinfo = fopen("/proc/cpuinfo", "r");
+    if (cpuinfo) {
+        char line[256];
+        while (fgets(line, sizeof(line), cpuinfo)) {
+            char* colon = strchr(line, ':');
+            if (strncmp(line, "model name", 10) == 0 && colon) {
+                snprintf(cpu_name, sizeof(cpu_name), "%s", colon + 2);
+                cpu_name[strcspn(cpu_name, "\r\n\"\\")] = '\0';
+                break;
+            }
+        }
+        fclose(cpuinfo);
+    }
+#endif
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(file, "  \"machine\": {\n");
+    fprintf(file, "    \"platform\": \"%s\",\n", SDL_GetPlatform());
+    fprintf(file, "    \"cpu\": \"%s\",\n", cpu_name);
+    fprintf(file, "    \"cpu_count\": %d,\n", SDL_GetCPUCount());
+    fprintf(file, "    \"cache_line\": %d,\n", SDL_GetCPUCacheLineSize());
+    fprintf(file, "    \"ram_mb\": %d,\n", SDL_GetSystemRAM());
+#ifdef __VERSION__
+    fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    fprintf(file, "    \"date\": \"%s\"\n", date);
+    fprintf(file, "  },\n");
+}
+
+static bool write_results(const BenchSuite* suite, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot open '%s' for writing\n", path);
+        return false;
+    }
+    fprintf(file, "{\n");
+    write_machine_info(file);
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (int i = 0; i < suite->result_count; ++i) {
+        const BenchResult* result = &suite->results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %d, \"repetitions\": %d, "
+                      "\"median_ns\": %.2f, \"p95_ns\": %.2f, \"min_ns\": %.2f, \"mean_ns\": %.2f}%s\n",
+                result->name, result->iterations, result->repetitions,
+                result->median_ns, result->p95_ns, result->min_ns, result->mean_ns,
+                i + 1 < suite->result_count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = fclose(file) == 0;
+    if (ok) fprintf(stderr, "[INFO] Results written to '%s'\n", path);
+    return ok;
+}
+
+/**
+ * Reads the median of a benchmark from a results file written by write_results.
+ * @return false if the baseline has no such benchmark.
+ */
+static bool find_baseline_median(const char* json, const char* name, double* median_ns)
+{
+    char key[MAX_BENCH_NAME + 16];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+    const char* entry = strstr(json, key);
+    if (!entry) return false;
+    const char* end = strchr(entry, '}');
+    const char* median = strstr(entry, "\"median_ns\":");
+    if (!median || (end && median > end)) return false;
+    *median_ns = strtod(median + strlen("\"median_ns\":"), NULL);
+    return *median_ns > 0.0;
+}
+
+/**
+ * @return Number of benchmarks slower than the baseline by more than the threshold, -1 if it cannot be read.
+ */
+static int compare_with_baseline(const BenchSuite* suite, const char* path, double threshold)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot read baseline '%s'\n", path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* json = (char*)malloc((size_t)size + 1);
+    if (!json || fread(json, 1, (size_t)size, file) != (size_t)size) {
+        fprintf(stderr, "ERROR: Cannot read baseline '%s'\n", path);
+        free(json);
+        fclose(file);
+        return -1;
+    }
+    json[size] = '\0';
+    fclose(file);
+
+    int regressions = 0;
+    fprintf(stderr, "\nAgainst '%s' (regression threshold %.1f%%):\n", path, threshold);
+    for (int i = 0; i < suite->result_count; ++i) {
+        const BenchResult* result = &suite->results[i];
+        double baseline_ns;
+        if (!find_baseline_median(json, result->name, &baseline_ns)) {
+            fprintf(stderr, "%-32s %12.1f ns  (new)\n", result->name, result->median_ns);
+            continue;
+        }
+        double change = 100.0 * (result->median_ns - baseline_ns) / baseline_ns;
+        bool regressed = change > threshold;
+        if (regressed) regressions++;
+        fprintf(stderr, "%-32s %12.1f ns  was %12.1f ns  %+7.1f%%%s\n", result->name, result->median_ns,
+                baseline_ns, change, regressed ? "  REGRESSION" : (change < -threshold ? "  faster" : ""));
+    }
+    free(json);
+    return regressions;
+}
+
+// --- Suite ---
+
+static void run_suite(BenchSuite* suite, const char* model_path)
+{
+    static ModelBench model_bench;
+    static Scene scene; // Too big for the stack
+    static UnitBench unit_bench;
+    static PickBench pick_bench;
+    static MatrixBench matrix_bench;
+    static JobBench job_bench;
+    char name[MAX_BENCH_NAME];
+
+    // Model loading and the vertex data setup_model_buffers uploads
+    model_bench.path = model_path;
+    init_model(&model_bench.model);
+    if (load_model(&model_bench.model, model_path)) {
+        run_benchmark(suite, "load_model", bench_load_model, &model_bench);
+        run_benchmark(suite, "build_model_vertex_data", bench_model_vertex_data, &model_bench);
+    } else {
+        fprintf(stderr, "[WARN] Cannot load '%s', skipping the model benchmarks\n", model_path);
+    }
+    free_model(&model_bench.model);
+
+    // Unit targeting and movement at growing crowd sizes
+    static const int unit_counts[] = {8, 16, 32, MAX_UNITS};
+    for (int i = 0; i < (int)(sizeof(unit_counts) / sizeof(unit_counts[0])); ++i) {
+        setup_unit_bench(&unit_bench, &scene, unit_counts[i]);
+        snprintf(name, sizeof(name), "update_unit/%d", unit_bench.unit_count);
+        run_benchmark(suite, name, bench_update_units, &unit_bench);
+        snprintf(name, sizeof(name), "try_move_step/%d", unit_bench.unit_count);
+        run_benchmark(suite, name, bench_try_move_step, &unit_bench);
+        snprintf(name, sizeof(name), "is_tile_walkable/%d", unit_bench.unit_count);
+        run_benchmark(suite, name, bench_is_tile_walkable, &unit_bench);
+    }
+
+    // Picking
+    unsigned int random_state = 0x9E3779B9u;
+    float extent = BOARD_GRID_WIDTH * BOARD_TILE_SIZE;
+    for (int p = 0; p < BENCH_PICK_POINTS; ++p) {
+        for (int c = 0; c < 3; c += 2) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 17;
+            random_state ^= random_state << 5;
+            pick_bench.points[p][c] = ((float)(random_state & 0xFFFF) / 65535.0f - 0.5f) * extent * 1.25f;
+        }
+        pick_bench.points[p][1] = 0.0f;
+    }
+    run_benchmark(suite, "world_to_grid_pos", bench_world_to_grid_pos, &pick_bench);
+
+    // 2D homogeneous matrices
+    init_identity_matrix(matrix_bench.a);
+    init_identity_matrix(matrix_bench.b);
+    rotate(matrix_bench.b, 0.7f);
+    shift(matrix_bench.b, 1.0f, 2.0f);
+    for (int p = 0; p < BENCH_PICK_POINTS; ++p) {
+        matrix_bench.points[p][0] = (float)p;
+        matrix_bench.points[p][1] = (float)(BENCH_PICK_POINTS - p);
+        matrix_bench.points[p][2] = 1.0f;
+    }
+    run_benchmark(suite, "matrix/multiply_matrices", bench_multiply_matrices, &matrix_bench);
+    run_benchmark(suite, "matrix/transform_point", bench_transform_point, &matrix_bench);
+    run_benchmark(suite, "matrix/scale_rotate_shift", bench_matrix_transforms, &matrix_bench);
+    run_benchmark(suite, "matrix/push_pop", bench_matrix_stack, &matrix_bench);
+
+    // Scheduling overhead, and the same loop serial and spread over the workers
+    for (int i = 0; i < BENCH_FOR_ITEMS; ++i) {
+        job_bench.values[i] = (float)i * 0.01f;
+    }
+    snprintf(name, sizeof(name), "jobs/empty_jobs_%d", BENCH_JOB_COUNT);
+    run_benchmark(suite, name, bench_empty_jobs, NULL);
+    run_benchmark(suite, "jobs/serial_for", bench_serial_for, &job_bench);
+    run_benchmark(suite, "jobs/parallel_for", bench_parallel_for, &job_bench);
+}
+
+int main(int argc, char* argv[])
+{
+    static BenchSuite suite; // Too big for the stack
+    const char* output_path = BENCH_DEFAULT_OUTPUT;
+    const char* baseline_path = NULL;
+    const char* model_path = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    bool verbose = false;
+    bool selftest = false;
+    suite.repetitions = BENCH_DEFAULT_REPETITIONS;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[i], "--selftest") == 0) {
+            selftest = true;
+        } else if (value && strcmp(argv[i], "-o") == 0) {
+            output_path = argv[++i];
+        } else if (value && strcmp(argv[i], "--baseline") == 0) {
+            baseline_path = argv[++i];
+        } else if (value && strcmp(argv[i], "--threshold") == 0) {
+            threshold = atof(argv[++i]);
+        } else if (value && strcmp(argv[i], "--filter") == 0) {
+            suite.filter = argv[++i];
+        } else if (value && strcmp(argv[i], "--repetitions") == 0) {
+            suite.repetitions = atoi(argv[++i]);
+        } else if (value && strcmp(argv[i], "--model") == 0) {
+            model_path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-o <results.json>] [--baseline <baseline.json>] [--threshold <percent>]\n"
+                            "       [--filter <text>] [--repetitions <n>] [--model <file.obj>] [--verbose]\n"
+                            "       %s --selftest\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+    if (suite.repetitions < 1) suite.repetitions = 1;
+
+    if (selftest) {
+        int worker_count = SDL_GetCPUCount() - 1;
+        init_job_system(worker_count < SELFTEST_MIN_WORKERS ? SELFTEST_MIN_WORKERS : worker_count);
+        fprintf(stderr, "Job system self-test, %d job threads\n", get_job_thread_count());
+        int failures = run_job_selftest();
+        shutdown_job_system();
+        if (failures > 0) fprintf(stderr, "[ERROR] %d job system check(s) failed\n", failures);
+        return failures == 0 ? 0 : 1;
+    }
+
+    bool generated_model = false;
+    if (!model_path) {
+        if (!write_sphere_model(BENCH_GENERATED_MODEL, 64, 32)) {
+            fprintf(stderr, "ERROR: Cannot write '%s'\n", BENCH_GENERATED_MODEL);
+            return 1;
+        }
+        model_path = BENCH_GENERATED_MODEL;
+        generated_model = true;
+    }
+
+    // The engine logs to stdout on hot paths; the report goes to stderr
+    if (!verbose) {
+#ifdef _WIN32
+        freopen("NUL", "w", stdout);
+#else
+        freopen("/dev/null", "w", stdout);
+#endif
+    }
+
+    init_job_system(0);
+    fprintf(stderr, "%d repetitions per benchmark, %s, %d job threads\n", suite.repetitions, SDL_GetPlatform(), get_job_thread_count());
+    run_suite(&suite, model_path);
+    shutdown_job_system();
+    if (generated_model) remove(BENCH_GENERATED_MODEL);
+
+    if (!write_results(&suite, output_path)) return 1;
+    if (baseline_path) {
+        int regressions = compare_with_baseline(&suite, baseline_path, threshold);
+        if (regressions != 0) {
+            if (regressions > 0) fprintf(stderr, "[ERROR] %d benchmark(s) regressed\n", regressions);
+            return 1;
+        }
+    }
+    return 0;
+}
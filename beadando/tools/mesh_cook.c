@@ -0,0 +1,224 @@
+#include "mesh_cook.h"
+#include "mesh_container.h"
+#include "texture_cook.h" // make_parent_directories
+#include "utils.h"
+
+#include <obj/load.h>
+#include <obj/model.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Welding ---
+
+/**
+ * Maps every item to the first bitwise-identical item (open addressing hash table).
+ * remap[i] receives the index of the unique item in the compacted order,
+ * unique_items (if not NULL) receives the index of the first occurrence of each unique item.
+ * @return The number of unique items, or -1 on allocation failure.
+ */
+static int weld_items(const void* items, size_t stride, int count, int* remap, int* unique_items)
+{
+    const unsigned char* bytes = (const unsigned char*)items;
+    int table_size = 1;
+    while (table_size < count * 2) table_size *= 2;
+
+    int* table = (int*)malloc((size_t)table_size * sizeof(int)); // Unique index, -1 if free
+    int* first_occurrence = (int*)malloc((size_t)count * sizeof(int));
+    if (!table || !first_occurrence) {
+        free(table);
+        free(first_occurrence);
+        return -1;
+    }
+    for (int i = 0; i < table_size; ++i) table[i] = -1;
+
+    int unique_count = 0;
+    for (int i = 0; i < count; ++i) {
+        const unsigned char* item = bytes + (size_t)i * stride;
+        uint32_t slot = (uint32_t)hash_fnv1a64(FNV1A64_OFFSET_BASIS, item, stride) & (uint32_t)(table_size - 1);
+        while (table[slot] != -1 &&
+               memcmp(bytes + (size_t)first_occurrence[table[slot]] * stride, item, stride) != 0) {
+            slot = (slot + 1) & (uint32_t)(table_size - 1);
+        }
+        if (table[slot] == -1) {
+            table[slot] = unique_count;
+            first_occurrence[unique_count++] = i;
+        }
+        remap[i] = table[slot];
+    }
+
+    if (unique_items) memcpy(unique_items, first_occurrence, (size_t)unique_count * sizeof(int));
+    free(table);
+    free(first_occurrence);
+    return unique_count;
+}
+
+// Folds -0.0 into 0.0 so the bitwise compare of the welder treats them as equal
+static void canonicalize_floats(float* values, int count)
+{
+    for (int i = 0; i < count; ++i) values[i] += 0.0f;
+}
+
+/**
+ * Replaces the flat normals with area weighted averages over all corners sharing a position.
+ */
+static bool smooth_normals(VertexData* vertices, int count)
+{
+    float (*positions)[3] = malloc((size_t)count * sizeof(*positions));
+    int* position_of_corner = (int*)malloc((size_t)count * sizeof(int));
+    float (*sums)[3] = calloc((size_t)count, sizeof(*sums));
+    if (!positions || !position_of_corner || !sums) {
+        free(positions);
+        free(position_of_corner);
+        free(sums);
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) memcpy(positions[i], vertices[i].position, sizeof(positions[i]));
+    int position_count = weld_items(positions, sizeof(positions[0]), count, position_of_corner, NULL);
+    if (position_count < 0) {
+        free(positions);
+        free(position_of_corner);
+        free(sums);
+        return false;
+    }
+
+    // The un-normalized cross product is proportional to the triangle area
+    for (int i = 0; i + 2 < count; i += 3) {
+        const float* a = vertices[i].position;
+        const float* b = vertices[i + 1].position;
+        const float* c = vertices[i + 2].position;
+        float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        float face[3] = {
+            ab[1] * ac[2] - ab[2] * ac[1],
+            ab[2] * ac[0] - ab[0] * ac[2],
+            ab[0] * ac[1] - ab[1] * ac[0]
+        };
+        for (int j = 0; j < 3; ++j) {
+            float* sum = sums[position_of_corner[i + j]];
+            sum[0] += face[0];
+            sum[1] += face[1];
+            sum[2] += face[2];
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const float* sum = sums[position_of_corner[i]];
+        float length = sqrtf(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+        if (length > 1e-12f) {
+            vertices[i].normal[0] = sum[0] / length;
+            vertices[i].normal[1] = sum[1] / length;
+            vertices[i].normal[2] = sum[2] / length;
+        } // else keep the flat normal of the corner
+    }
+
+    free(positions);
+    free(position_of_corner);
+    free(sums);
+    return true;
+}
+
+// --- Container ---
+
+static uint64_t align_offset(uint64_t offset)
+{
+    return (offset + MESH_CONTAINER_ALIGNMENT - 1) & ~(uint64_t)(MESH_CONTAINER_ALIGNMENT - 1);
+}
+
+static bool write_container(const char* output_path, const MeshContainerHeader* header,
+                            const VertexData* vertices, const uint32_t* indices)
+{
+    if (!make_parent_directories(output_path)) return false;
+
+    FILE* file = fopen(output_path, "wb");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot open '%s' for writing\n", output_path);
+        return false;
+    }
+
+    static const unsigned char zeros[MESH_CONTAINER_ALIGNMENT] = {0};
+    size_t vertex_padding = (size_t)(header->vertex_offset - sizeof(MeshContainerHeader));
+    size_t index_padding = (size_t)(header->index_offset - (header->vertex_offset + (uint64_t)header->vertex_count * sizeof(VertexData)));
+
+    bool ok = fwrite(header, sizeof(MeshContainerHeader), 1, file) == 1 &&
+              fwrite(zeros, 1, vertex_padding, file) == vertex_padding &&
+              fwrite(vertices, sizeof(VertexData), header->vertex_count, file) == header->vertex_count &&
+              fwrite(zeros, 1, index_padding, file) == index_padding &&
+              fwrite(indices, sizeof(uint32_t), header->index_count, file) == header->index_count;
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "ERROR: Failed to write mesh container '%s'\n", output_path);
+        remove(output_path);
+    }
+    return ok;
+}
+
+bool cook_mesh(const char* source_path, const char* output_path)
+{
+    Model model;
+    if (!load_model(&model, source_path)) {
+        return false;
+    }
+    bool has_normals = model.normals != NULL;
+
+    VertexData* corners = NULL;
+    GLuint* corner_indices = NULL;
+    GLsizei corner_count = 0;
+    int ok = build_model_vertex_data(&model, &corners, &corner_indices, &corner_count);
+    free_model(&model);
+    if (!ok) {
+        return false;
+    }
+    free(corner_indices); // One vertex per corner, rebuilt below by the welder
+
+    for (GLsizei i = 0; i < corner_count; ++i) {
+        canonicalize_floats((float*)&corners[i], (int)(sizeof(VertexData) / sizeof(float)));
+    }
+    if (!has_normals && !smooth_normals(corners, corner_count)) {
+        fprintf(stderr, "ERROR: Out of memory generating normals for '%s'\n", source_path);
+        free(corners);
+        return false;
+    }
+
+    // Weld corners with identical position, normal and UV
+    uint32_t* indices = (uint32_t*)malloc((size_t)corner_count * sizeof(uint32_t));
+    int* remap = (int*)malloc((size_t)corner_count * sizeof(int));
+    int* unique_corners = (int*)malloc((size_t)corner_count * sizeof(int));
+    VertexData* vertices = (VertexData*)malloc((size_t)corner_count * sizeof(VertexData));
+    int vertex_count = -1;
+    if (indices && remap && unique_corners && vertices) {
+        vertex_count = weld_items(corners, sizeof(VertexData), corner_count, remap, unique_corners);
+    }
+    if (vertex_count < 0) {
+        fprintf(stderr, "ERROR: Out of memory welding '%s'\n", source_path);
+        free(indices); free(remap); free(unique_corners); free(vertices); free(corners);
+        return false;
+    }
+    for (int i = 0; i < vertex_count; ++i) vertices[i] = corners[unique_corners[i]];
+    for (GLsizei i = 0; i < corner_count; ++i) indices[i] = (uint32_t)remap[i];
+
+    MeshContainerHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MESH_CONTAINER_MAGIC;
+    header.version = MESH_CONTAINER_VERSION;
+    header.vertex_count = (uint32_t)vertex_count;
+    header.index_count = (uint32_t)corner_count;
+    header.vertex_stride = sizeof(VertexData);
+    compute_vertex_bounds(vertices, vertex_count, header.bounds_min, header.bounds_max);
+    header.vertex_offset = align_offset(sizeof(MeshContainerHeader));
+    header.index_offset = align_offset(header.vertex_offset + (uint64_t)vertex_count * sizeof(VertexData));
+
+    bool written = write_container(output_path, &header, vertices, indices);
+    if (written) {
+        printf("[INFO] Cooked mesh '%s' -> '%s' (%d corners -> %d vertices%s)\n",
+               source_path, output_path, corner_count, vertex_count, has_normals ? "" : ", generated normals");
+    }
+
+    free(indices); free(remap); free(unique_corners); free(vertices); free(corners);
+    return written;
+}
@@ -0,0 +1,16 @@
+#ifndef MESH_COOK_H
+#define MESH_COOK_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Cooks an OBJ model into a mesh container (.mesh).
+ * Flattens the faces, generates smooth normals when the OBJ has none, welds identical
+ * vertices and stores the bounds (see mesh_container.h).
+ * @param source_path Path of the OBJ file.
+ * @param output_path Path of the container to write.
+ * @return true on success.
+ */
+bool cook_mesh(const char* source_path, const char* output_path);
+
+#endif /* MESH_COOK_H */
@@ -0,0 +1,238 @@
+#include "asset_pack.h"
+#include "asset_paths.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+/**
+ * Offline asset packer.
+ * Usage: assetpack [-o <archive>] [directories...]
+ * Packs every file under the given directories (default: assets and shaders, cooked assets included)
+ * into a single archive the game maps at startup (see asset_pack.h). Paths are stored relative
+ * to the working directory with forward slashes, exactly as the game opens them.
+ */
+
+#define MAX_PACK_FILES 1024
+
+typedef struct PackFile
+{
+    char path[ASSET_PATH_MAX];
+    uint64_t hash;
+    uint64_t size;
+} PackFile;
+
+typedef struct PackContext
+{
+    PackFile files[MAX_PACK_FILES];
+    int file_count;
+} PackContext;
+
+// --- Directory walk ---
+
+static void add_file(PackContext* context, const char* path, uint64_t size)
+{
+    if (context->file_count >= MAX_PACK_FILES) {
+        fprintf(stderr, "[WARN] Too many files, skipping '%s' (limit %d)\n", path, MAX_PACK_FILES);
+        return;
+    }
+    PackFile* file = &context->files[context->file_count++];
+    strcpy(file->path, path);
+    for (char* c = file->path; *c; ++c) {
+        if (*c == '\\') *c = '/';
+    }
+    file->hash = hash_asset_path(file->path);
+    file->size = size;
+}
+
+static void collect_files(PackContext* context, const char* directory)
+{
+    char path[ASSET_PATH_MAX];
+
+#ifdef _WIN32
+    char pattern[ASSET_PATH_MAX];
+    snprintf(pattern, sizeof(pattern), "%s/*", directory);
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE) return;
+    do {
+        const char* name = entry.cFileName;
+        if (name[0] == '.') continue;
+        if ((size_t)snprintf(path, sizeof(path), "%s/%s", directory, name) >= sizeof(path)) continue;
+        if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            collect_files(context, path);
+        } else {
+            add_file(context, path, ((uint64_t)entry.nFileSizeHigh << 32) | entry.nFileSizeLow);
+        }
+    } while (FindNextFileA(find, &entry));
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory);
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char* name = entry->d_name;
+        if (name[0] == '.') continue;
+        if ((size_t)snprintf(path, sizeof(path), "%s/%s", directory, name) >= sizeof(path)) continue;
+
+        struct stat file_stat;
+        if (stat(path, &file_stat) != 0) continue;
+        if (S_ISDIR(file_stat.st_mode)) {
+            collect_files(context, path);
+        } else {
+            add_file(context, path, (uint64_t)file_stat.st_size);
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+static int compare_pack_files(const void* a, const void* b)
+{
+    const PackFile* file_a = (const PackFile*)a;
+    const PackFile* file_b = (const PackFile*)b;
+    if (file_a->hash != file_b->hash) return file_a->hash < file_b->hash ? -1 : 1;
+    return strcmp(file_a->path, file_b->path);
+}
+
+// --- Archive ---
+
+static uint64_t align_offset(uint64_t offset)
+{
+    return (offset + ASSET_PACK_ALIGNMENT - 1) & ~(uint64_t)(ASSET_PACK_ALIGNMENT - 1);
+}
+
+static bool write_padding(FILE* file, uint64_t from, uint64_t to)
+{
+    static const unsigned char zeros[ASSET_PACK_ALIGNMENT] = {0};
+    size_t padding = (size_t)(to - from);
+    return fwrite(zeros, 1, padding, file) == padding;
+}
+
+static bool copy_file_contents(FILE* output, const PackFile* pack_file)
+{
+    FILE* input = fopen(pack_file->path, "rb");
+    if (!input) {
+        fprintf(stderr, "ERROR: Cannot read '%s'\n", pack_file->path);
+        return false;
+    }
+    unsigned char buffer[64 * 1024];
+    uint64_t copied = 0;
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+        if (fwrite(buffer, 1, read, output) != read) break;
+        copied += read;
+    }
+    fclose(input);
+    if (copied != pack_file->size) {
+        fprintf(stderr, "ERROR: '%s' changed while packing\n", pack_file->path);
+        return false;
+    }
+    return true;
+}
+
+static bool write_pack(const PackContext* context, const char* output_path)
+{
+    AssetPackEntry* entries = (AssetPackEntry*)calloc((size_t)(context->file_count > 0 ? context->file_count : 1), sizeof(AssetPackEntry));
+    if (!entries) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        return false;
+    }
+
+    // Lay out the table, the path strings, then the aligned payloads
+    AssetPackHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entry_count = (uint32_t)context->file_count;
+    header.entries_offset = sizeof(AssetPackHeader);
+
+    uint64_t offset = header.entries_offset + (uint64_t)context->file_count * sizeof(AssetPackEntry);
+    for (int i = 0; i < context->file_count; ++i) {
+        entries[i].path_hash = context->files[i].hash;
+        entries[i].path_offset = offset;
+        entries[i].path_length = (uint32_t)strlen(context->files[i].path);
+        offset += entries[i].path_length;
+    }
+    for (int i = 0; i < context->file_count; ++i) {
+        offset = align_offset(offset);
+        entries[i].offset = offset;
+        entries[i].size = context->files[i].size;
+        offset += entries[i].size;
+    }
+
+    FILE* file = fopen(output_path, "wb");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot open '%s' for writing\n", output_path);
+        free(entries);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(entries, sizeof(AssetPackEntry), (size_t)context->file_count, file) == (size_t)context->file_count;
+    for (int i = 0; ok && i < context->file_count; ++i) {
+        ok = fwrite(context->files[i].path, 1, entries[i].path_length, file) == entries[i].path_length;
+    }
+    uint64_t position = context->file_count > 0 ? entries[context->file_count - 1].path_offset + entries[context->file_count - 1].path_length
+                                                : header.entries_offset;
+    for (int i = 0; ok && i < context->file_count; ++i) {
+        ok = write_padding(file, position, entries[i].offset) && copy_file_contents(file, &context->files[i]);
+        position = entries[i].offset + entries[i].size;
+    }
+
+    if (fclose(file) != 0) ok = false;
+    if (ok) {
+        printf("[INFO] Packed %d files into '%s' (%llu bytes)\n", context->file_count, output_path, (unsigned long long)offset);
+    } else {
+        fprintf(stderr, "ERROR: Failed to write asset pack '%s'\n", output_path);
+        remove(output_path);
+    }
+    free(entries);
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    static PackContext context; // Too big for the stack
+    const char* output_path = ASSET_PACK_PATH;
+    const char* directories[16];
+    int directory_count = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (argv[i][0] != '-' && directory_count < (int)(sizeof(directories) / sizeof(directories[0]))) {
+            directories[directory_count++] = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [-o <archive>] [directories...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (directory_count == 0) {
+        directories[directory_count++] = "assets";
+        directories[directory_count++] = "shaders";
+    }
+
+    for (int i = 0; i < directory_count; ++i) {
+        collect_files(&context, directories[i]);
+    }
+    qsort(context.files, (size_t)context.file_count, sizeof(PackFile), compare_pack_files);
+
+    // Equal paths sort next to each other (e.g. the same directory given twice)
+    for (int i = 1; i < context.file_count; ++i) {
+        if (strcmp(context.files[i - 1].path, context.files[i].path) == 0) {
+            fprintf(stderr, "ERROR: '%s' was collected twice\n", context.files[i].path);
+            return 1;
+        }
+    }
+
+    return write_pack(&context, output_path) ? 0 : 1;
+}
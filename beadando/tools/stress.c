@@ -0,0 +1,307 @@
+#include "board.h"
+#include "scene.h"
+#include "unit.h"
+
+#include <SDL2/SDL.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Combat scaling stress harness.
+ * Usage: combatstress [--counts 16,32,64,...] [--ticks <n>] [--archers <fraction>] [--seed <n>]
+ *                     [--max-exponent <k>] [--csv <file>] [--verbose]
+ * For every unit count a battle is generated (both halves of the board filled at random tiles with
+ * the given tank/archer mix) and simulated without rendering through update_scene at a fixed time step.
+ * The median and p95 tick time and the memory the battle's units use are reported per count, then
+ * the growth exponent k of time ~ N^k is fitted on a log-log scale. Anything above linear is flagged;
+ * a fit above --max-exponent fails the run (exit code 1).
+ *
+ * The game is 8x8 with MAX_UNITS 50, far too small to see a trend, so `make stress` builds this
+ * harness and the game objects it links with a larger board and unit limit (STRESS_DEFS). That build
+ * also compiles out the per-attack combat log, so the fit measures the simulation and not stdio.
+ * Combat does not allocate (the Scene is static and sized by MAX_UNITS), so the units are the whole
+ * per-count footprint; the process peak would be the same for every count.
+ */
+
+#define STRESS_TIME_STEP (1.0f / 60.0f)
+#define STRESS_DEFAULT_TICKS 300
+#define STRESS_DEFAULT_ARCHERS 0.33
+#define STRESS_DEFAULT_MAX_EXPONENT 2.2 // Targeting is quadratic today, this catches anything worse
+#define STRESS_LINEAR_EXPONENT 1.15     // Fits above this are reported as super-linear
+#define MAX_STRESS_COUNTS 32
+
+typedef struct StressOptions
+{
+    int counts[MAX_STRESS_COUNTS];
+    int count_count;
+    int ticks;
+    double archer_fraction;
+    unsigned int seed;
+    double max_exponent;
+    const char* csv_path;
+} StressOptions;
+
+typedef struct StressResult
+{
+    int unit_count;
+    int ticks;             // Ticks with both sides alive, the ones measured
+    double median_tick_ns;
+    double p95_tick_ns;
+    double unit_memory_kb; // Units of the battle, unit_count * sizeof(Unit)
+} StressResult;
+
+static unsigned int next_random(unsigned int* state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int compare_doubles(const void* a, const void* b)
+{
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// --- Battle ---
+
+/**
+ * Places half of the units on random free tiles of each side.
+ * @return Number of units placed (less than requested if a side runs out of tiles).
+ */
+static int generate_battle(Scene* scene, int unit_count, const StressOptions* options)
+{
+    static bool occupied[BOARD_GRID_HEIGHT][BOARD_GRID_WIDTH];
+    memset(scene, 0, sizeof(Scene));
+    memset(occupied, 0, sizeof(occupied));
+
+    unsigned int random_state = options->seed ? options->seed : 1u;
+    int half = BOARD_GRID_HEIGHT / 2;
+    int side_capacity = half * BOARD_GRID_WIDTH;
+    int placed_per_side[2] = {0, 0};
+
+    for (int n = 0; n < unit_count && scene->unit_count < MAX_UNITS; ++n) {
+        bool player = (n % 2) == 0;
+        if (placed_per_side[player] >= side_capacity) continue;
+
+        int x, y;
+        do {
+            x = (int)(next_random(&random_state) % BOARD_GRID_WIDTH);
+            y = (int)(next_random(&random_state) % half) + (player ? 0 : half);
+        } while (occupied[y][x]);
+        occupied[y][x] = true;
+        placed_per_side[player]++;
+
+        double roll = (double)(next_random(&random_state) & 0xFFFF) / 65536.0;
+        UnitType type = roll < options->archer_fraction ? UNIT_RANGED_ARCHER : UNIT_MELEE_TANK;
+        init_unit(&scene->units[scene->unit_count++], type, x, y, player, LOC_BOARD);
+    }
+    return scene->unit_count;
+}
+
+static bool both_sides_alive(const Scene* scene)
+{
+    bool player_alive = false, ai_alive = false;
+    for (int i = 0; i < scene->unit_count; ++i) {
+        const Unit* unit = &scene->units[i];
+        if (!unit->is_alive || unit->location != LOC_BOARD) continue;
+        if (unit->is_player_unit) player_alive = true;
+        else ai_alive = true;
+        if (player_alive && ai_alive) return true;
+    }
+    return false;
+}
+
+static bool run_battle(Scene* scene, int unit_count, const StressOptions* options, StressResult* result)
+{
+    memset(result, 0, sizeof(StressResult));
+    result->unit_count = generate_battle(scene, unit_count, options);
+    if (result->unit_count < unit_count) {
+        fprintf(stderr, "[WARN] Only %d of %d units fit (MAX_UNITS %d, board %dx%d)\n",
+                result->unit_count, unit_count, MAX_UNITS, BOARD_GRID_WIDTH, BOARD_GRID_HEIGHT);
+    }
+
+    double* samples = (double*)malloc((size_t)options->ticks * sizeof(double));
+    if (!samples) return false;
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    int ticks = 0;
+    while (ticks < options->ticks && both_sides_alive(scene)) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        update_scene(scene, STRESS_TIME_STEP, PHASE_COMBAT);
+        samples[ticks++] = (double)(SDL_GetPerformanceCounter() - start) * 1.0e9 / frequency;
+    }
+
+    if (ticks > 0) {
+        qsort(samples, (size_t)ticks, sizeof(double), compare_doubles);
+        result->median_tick_ns = samples[ticks / 2];
+        result->p95_tick_ns = samples[(int)(ticks * 0.95)];
+    }
+    result->ticks = ticks;
+    result->unit_memory_kb = (double)result->unit_count * sizeof(Unit) / 1024.0;
+    free(samples);
+    return ticks > 0;
+}
+
+// --- Growth fit ---
+
+/**
+ * Least squares slope of log(time) over log(N) between two result indices (inclusive).
+ */
+static double fit_exponent(const StressResult* results, int first, int last)
+{
+    double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+    int n = 0;
+    for (int i = first; i <= last; ++i) {
+        if (results[i].median_tick_ns <= 0.0) continue;
+        double x = log((double)results[i].unit_count);
+        double y = log(results[i].median_tick_ns);
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+        n++;
+    }
+    double denominator = n * sum_xx - sum_x * sum_x;
+    if (n < 2 || fabs(denominator) < 1e-12) return 0.0;
+    return (n * sum_xy - sum_x * sum_y) / denominator;
+}
+
+static void write_csv(const char* path, const StressResult* results, int count)
+{
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot open '%s' for writing\n", path);
+        return;
+    }
+    fprintf(file, "units,ticks,median_tick_ns,p95_tick_ns,unit_memory_kb\n");
+    for (int i = 0; i < count; ++i) {
+        fprintf(file, "%d,%d,%.1f,%.1f,%.1f\n", results[i].unit_count, results[i].ticks,
+                results[i].median_tick_ns, results[i].p95_tick_ns, results[i].unit_memory_kb);
+    }
+    fclose(file);
+    fprintf(stderr, "[INFO] Results written to '%s'\n", path);
+}
+
+// --- Options ---
+
+static void set_default_counts(StressOptions* options)
+{
+    // Doubling up to what the build allows: the unit limit and half the tiles per side
+    int limit = MAX_UNITS < BOARD_GRID_WIDTH * BOARD_GRID_HEIGHT ? MAX_UNITS : BOARD_GRID_WIDTH * BOARD_GRID_HEIGHT;
+    options->count_count = 0;
+    for (int count = 8; count <= limit && options->count_count < MAX_STRESS_COUNTS; count *= 2) {
+        options->counts[options->count_count++] = count;
+    }
+    if (options->count_count > 0 && options->counts[options->count_count - 1] != limit && options->count_count < MAX_STRESS_COUNTS) {
+        options->counts[options->count_count++] = limit;
+    }
+}
+
+static void parse_counts(StressOptions* options, const char* text)
+{
+    options->count_count = 0;
+    while (*text && options->count_count < MAX_STRESS_COUNTS) {
+        char* end;
+        long value = strtol(text, &end, 10);
+        if (end == text) break;
+        if (value > 1) options->counts[options->count_count++] = (int)value;
+        text = *end == ',' ? end + 1 : end;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    static Scene scene; // Far too big for the stack at stress sizes
+    static StressResult results[MAX_STRESS_COUNTS];
+    StressOptions options;
+    memset(&options, 0, sizeof(options));
+    options.ticks = STRESS_DEFAULT_TICKS;
+    options.archer_fraction = STRESS_DEFAULT_ARCHERS;
+    options.seed = 12345u;
+    options.max_exponent = STRESS_DEFAULT_MAX_EXPONENT;
+    set_default_counts(&options);
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (value && strcmp(argv[i], "--counts") == 0) {
+            parse_counts(&options, argv[++i]);
+        } else if (value && strcmp(argv[i], "--ticks") == 0) {
+            options.ticks = atoi(argv[++i]);
+        } else if (value && strcmp(argv[i], "--archers") == 0) {
+            options.archer_fraction = atof(argv[++i]);
+        } else if (value && strcmp(argv[i], "--seed") == 0) {
+            options.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (value && strcmp(argv[i], "--max-exponent") == 0) {
+            options.max_exponent = atof(argv[++i]);
+        } else if (value && strcmp(argv[i], "--csv") == 0) {
+            options.csv_path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--counts 16,32,64,...] [--ticks <n>] [--archers <fraction>] [--seed <n>]\n"
+                            "       [--max-exponent <k>] [--csv <file>] [--verbose]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.ticks < 1) options.ticks = 1;
+    if (options.count_count < 2) {
+        fprintf(stderr, "ERROR: At least two unit counts are needed for a fit\n");
+        return 1;
+    }
+
+    // The rest of the engine still logs to stdout (init_unit etc.); the report goes to stderr
+    if (!verbose) {
+#ifdef _WIN32
+        freopen("NUL", "w", stdout);
+#else
+        freopen("/dev/null", "w", stdout);
+#endif
+    }
+
+    fprintf(stderr, "Board %dx%d, MAX_UNITS %d, %d ticks of %.4f s, %.0f%% archers, seed %u\n",
+            BOARD_GRID_WIDTH, BOARD_GRID_HEIGHT, MAX_UNITS, options.ticks, STRESS_TIME_STEP,
+            100.0 * options.archer_fraction, options.seed);
+    fprintf(stderr, "%8s %8s %14s %14s %12s %10s\n", "units", "ticks", "median ns", "p95 ns", "unit KB", "local k");
+
+    int result_count = 0;
+    for (int i = 0; i < options.count_count; ++i) {
+        StressResult* result = &results[result_count];
+        if (!run_battle(&scene, options.counts[i], &options, result)) {
+            fprintf(stderr, "[WARN] Battle of %d units ended before the first tick, skipped\n", options.counts[i]);
+            continue;
+        }
+        result_count++;
+        if (result_count > 1) {
+            fprintf(stderr, "%8d %8d %14.1f %14.1f %12.1f %10.2f\n", result->unit_count, result->ticks,
+                    result->median_tick_ns, result->p95_tick_ns, result->unit_memory_kb,
+                    fit_exponent(results, result_count - 2, result_count - 1));
+        } else {
+            fprintf(stderr, "%8d %8d %14.1f %14.1f %12.1f %10s\n", result->unit_count, result->ticks,
+                    result->median_tick_ns, result->p95_tick_ns, result->unit_memory_kb, "-");
+        }
+    }
+    if (options.csv_path) write_csv(options.csv_path, results, result_count);
+    if (result_count < 2) {
+        fprintf(stderr, "ERROR: Not enough battles for a fit\n");
+        return 1;
+    }
+
+    double exponent = fit_exponent(results, 0, result_count - 1);
+    fprintf(stderr, "\nTick time grows as N^%.2f over %d..%d units\n", exponent,
+            results[0].unit_count, results[result_count - 1].unit_count);
+    if (exponent > STRESS_LINEAR_EXPONENT) {
+        fprintf(stderr, "[WARN] Super-linear scaling (k > %.2f)\n", STRESS_LINEAR_EXPONENT);
+    }
+    if (exponent > options.max_exponent) {
+        fprintf(stderr, "[ERROR] Scaling exponent %.2f exceeds the limit %.2f\n", exponent, options.max_exponent);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "texture_cook.h"
+#include "asset_paths.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Offline texture cooker.
+ * Usage: texcook [--compress] <input image> [output.tex]
+ * Without an explicit output the container goes to the cooked asset tree
+ * (assets/textures/grid.png -> assets/cooked/textures/grid.tex), where load_texture looks for it.
+ */
+int main(int argc, char* argv[])
+{
+    bool compress = false;
+    const char* input_path = NULL;
+    const char* output_path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+        } else if (!input_path) {
+            input_path = argv[i];
+        } else if (!output_path) {
+            output_path = argv[i];
+        } else {
+            input_path = NULL;
+            break;
+        }
+    }
+    if (!input_path) {
+        fprintf(stderr, "Usage: %s [--compress] <input image> [output.tex]\n", argv[0]);
+        return 1;
+    }
+
+    char default_output_path[ASSET_PATH_MAX];
+    if (!output_path) {
+        if (!get_cooked_asset_path(input_path, ".tex", default_output_path, sizeof(default_output_path))) {
+            fprintf(stderr, "ERROR: Output path for '%s' is too long\n", input_path);
+            return 1;
+        }
+        output_path = default_output_path;
+    }
+
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+    bool ok = cook_texture(input_path, output_path, compress);
+    IMG_Quit();
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,370 @@
+#include "texture_cook.h"
+#include "texture_container.h"
+
+#include <glad/glad.h> // For the GL enum values stored in the header
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define make_directory(path) _mkdir(path)
+#else
+#define make_directory(path) mkdir(path, 0755)
+#endif
+
+#define BLOCK_DIM 4
+#define DXT1_BLOCK_BYTES 8
+#define DXT5_BLOCK_BYTES 16
+
+typedef struct CookedLevel
+{
+    uint32_t width;
+    uint32_t height;
+    unsigned char* data;
+    size_t size;
+} CookedLevel;
+
+bool make_parent_directories(const char* file_path)
+{
+    char path[1024];
+    size_t length = strlen(file_path);
+    if (length >= sizeof(path)) return false;
+    memcpy(path, file_path, length + 1);
+
+    for (char* p = path + 1; *p; ++p) {
+        if (*p == '/' || *p == '\\') {
+            char separator = *p;
+            *p = '\0';
+            if (make_directory(path) != 0 && errno != EEXIST) {
+                fprintf(stderr, "ERROR: Cannot create directory '%s'\n", path);
+                return false;
+            }
+            *p = separator;
+        }
+    }
+    return true;
+}
+
+// --- Mip chain ---
+
+// 2x2 box filter, the odd row/column of non power of two levels is clamped
+static void downsample_rgba(const unsigned char* src, uint32_t src_w, uint32_t src_h,
+                            unsigned char* dst, uint32_t dst_w, uint32_t dst_h)
+{
+    for (uint32_t y = 0; y < dst_h; ++y) {
+        uint32_t y0 = y * 2;
+        uint32_t y1 = (y0 + 1 < src_h) ? y0 + 1 : y0;
+        for (uint32_t x = 0; x < dst_w; ++x) {
+            uint32_t x0 = x * 2;
+            uint32_t x1 = (x0 + 1 < src_w) ? x0 + 1 : x0;
+            for (int c = 0; c < 4; ++c) {
+                unsigned int sum = src[(y0 * src_w + x0) * 4 + c] + src[(y0 * src_w + x1) * 4 + c] +
+                                   src[(y1 * src_w + x0) * 4 + c] + src[(y1 * src_w + x1) * 4 + c];
+                dst[(y * dst_w + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+// --- S3TC encoding (bounding box endpoints, good enough for the game's textures) ---
+
+static uint16_t pack_rgb565(const unsigned char* rgb)
+{
+    return (uint16_t)((((rgb[0] * 31 + 127) / 255) << 11) |
+                      (((rgb[1] * 63 + 127) / 255) << 5) |
+                      ((rgb[2] * 31 + 127) / 255));
+}
+
+static void unpack_rgb565(uint16_t color, unsigned char* rgb)
+{
+    rgb[0] = (unsigned char)(((color >> 11) & 31) * 255 / 31);
+    rgb[1] = (unsigned char)(((color >> 5) & 63) * 255 / 63);
+    rgb[2] = (unsigned char)((color & 31) * 255 / 31);
+}
+
+static void encode_color_block(const unsigned char block[16][4], unsigned char* out)
+{
+    unsigned char min_rgb[3] = {255, 255, 255};
+    unsigned char max_rgb[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            if (block[i][c] < min_rgb[c]) min_rgb[c] = block[i][c];
+            if (block[i][c] > max_rgb[c]) max_rgb[c] = block[i][c];
+        }
+    }
+    // Pull the endpoints slightly inside the box to reduce the error of the bbox fit
+    for (int c = 0; c < 3; ++c) {
+        int inset = (max_rgb[c] - min_rgb[c]) / 16;
+        min_rgb[c] = (unsigned char)(min_rgb[c] + inset);
+        max_rgb[c] = (unsigned char)(max_rgb[c] - inset);
+    }
+
+    uint16_t color0 = pack_rgb565(max_rgb);
+    uint16_t color1 = pack_rgb565(min_rgb);
+    uint32_t indices = 0;
+
+    if (color0 < color1) {
+        uint16_t tmp = color0; color0 = color1; color1 = tmp;
+    }
+    if (color0 != color1) { // color0 > color1 selects the 4 colour mode
+        unsigned char palette[4][3];
+        unpack_rgb565(color0, palette[0]);
+        unpack_rgb565(color1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (unsigned char)((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = (unsigned char)((palette[0][c] + 2 * palette[1][c]) / 3);
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best_index = 0;
+            int best_distance = 0x7fffffff;
+            for (int p = 0; p < 4; ++p) {
+                int dr = block[i][0] - palette[p][0];
+                int dg = block[i][1] - palette[p][1];
+                int db = block[i][2] - palette[p][2];
+                int distance = dr * dr + dg * dg + db * db;
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best_index = p;
+                }
+            }
+            indices |= (uint32_t)best_index << (i * 2);
+        }
+    }
+
+    out[0] = (unsigned char)(color0 & 0xff);
+    out[1] = (unsigned char)(color0 >> 8);
+    out[2] = (unsigned char)(color1 & 0xff);
+    out[3] = (unsigned char)(color1 >> 8);
+    for (int i = 0; i < 4; ++i) out[4 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+static void encode_alpha_block(const unsigned char block[16][4], unsigned char* out)
+{
+    unsigned char alpha0 = 0;
+    unsigned char alpha1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        if (block[i][3] > alpha0) alpha0 = block[i][3];
+        if (block[i][3] < alpha1) alpha1 = block[i][3];
+    }
+
+    uint64_t indices = 0;
+    if (alpha0 > alpha1) { // 8 alpha mode
+        unsigned char palette[8];
+        palette[0] = alpha0;
+        palette[1] = alpha1;
+        for (int p = 1; p < 7; ++p) {
+            palette[p + 1] = (unsigned char)(((7 - p) * alpha0 + p * alpha1) / 7);
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best_index = 0;
+            int best_distance = 256;
+            for (int p = 0; p < 8; ++p) {
+                int distance = abs(block[i][3] - palette[p]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best_index = p;
+                }
+            }
+            indices |= (uint64_t)best_index << (i * 3);
+        }
+    }
+
+    out[0] = alpha0;
+    out[1] = alpha1;
+    for (int i = 0; i < 6; ++i) out[2 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+static size_t compressed_level_size(uint32_t width, uint32_t height, bool has_alpha)
+{
+    size_t blocks = (size_t)((width + BLOCK_DIM - 1) / BLOCK_DIM) * ((height + BLOCK_DIM - 1) / BLOCK_DIM);
+    return blocks * (has_alpha ? DXT5_BLOCK_BYTES : DXT1_BLOCK_BYTES);
+}
+
+static void compress_level(const unsigned char* rgba, uint32_t width, uint32_t height, bool has_alpha, unsigned char* out)
+{
+    unsigned char block[16][4];
+    for (uint32_t block_y = 0; block_y < height; block_y += BLOCK_DIM) {
+        for (uint32_t block_x = 0; block_x < width; block_x += BLOCK_DIM) {
+            // Gather the block, clamping at the edges of small levels
+            for (int i = 0; i < 16; ++i) {
+                uint32_t x = block_x + (uint32_t)(i % BLOCK_DIM);
+                uint32_t y = block_y + (uint32_t)(i / BLOCK_DIM);
+                if (x >= width) x = width - 1;
+                if (y >= height) y = height - 1;
+                memcpy(block[i], &rgba[(y * width + x) * 4], 4);
+            }
+            if (has_alpha) {
+                encode_alpha_block(block, out);
+                out += 8;
+            }
+            encode_color_block(block, out);
+            out += DXT1_BLOCK_BYTES;
+        }
+    }
+}
+
+// --- Container writer ---
+
+static bool write_padding(FILE* file, long* position)
+{
+    static const unsigned char zeros[TEXTURE_CONTAINER_ALIGNMENT] = {0};
+    long padding = (TEXTURE_CONTAINER_ALIGNMENT - (*position % TEXTURE_CONTAINER_ALIGNMENT)) % TEXTURE_CONTAINER_ALIGNMENT;
+    if (padding > 0 && fwrite(zeros, 1, (size_t)padding, file) != (size_t)padding) return false;
+    *position += padding;
+    return true;
+}
+
+static bool write_container(const char* output_path, const TextureContainerHeader* header, const CookedLevel* levels)
+{
+    if (!make_parent_directories(output_path)) return false;
+
+    FILE* file = fopen(output_path, "wb");
+    if (!file) {
+        fprintf(stderr, "ERROR: Cannot open '%s' for writing\n", output_path);
+        return false;
+    }
+
+    // Lay out the payload first so the level table can be written in one go
+    TextureContainerLevel table[TEXTURE_CONTAINER_MAX_LEVELS];
+    long position = (long)(sizeof(TextureContainerHeader) + header->level_count * sizeof(TextureContainerLevel));
+    for (uint32_t i = 0; i < header->level_count; ++i) {
+        position += (TEXTURE_CONTAINER_ALIGNMENT - (position % TEXTURE_CONTAINER_ALIGNMENT)) % TEXTURE_CONTAINER_ALIGNMENT;
+        table[i].width = levels[i].width;
+        table[i].height = levels[i].height;
+        table[i].offset = (uint64_t)position;
+        table[i].size = levels[i].size;
+        position += (long)levels[i].size;
+    }
+
+    bool ok = fwrite(header, sizeof(TextureContainerHeader), 1, file) == 1 &&
+              fwrite(table, sizeof(TextureContainerLevel), header->level_count, file) == header->level_count;
+    position = (long)(sizeof(TextureContainerHeader) + header->level_count * sizeof(TextureContainerLevel));
+    for (uint32_t i = 0; ok && i < header->level_count; ++i) {
+        ok = write_padding(file, &position) &&
+             fwrite(levels[i].data, 1, levels[i].size, file) == levels[i].size;
+        position += (long)levels[i].size;
+    }
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "ERROR: Failed to write texture container '%s'\n", output_path);
+        remove(output_path);
+    }
+    return ok;
+}
+
+bool cook_texture(const char* source_path, const char* output_path, bool compress)
+{
+    SDL_Surface* loaded = IMG_Load(source_path);
+    if (!loaded) {
+        fprintf(stderr, "ERROR: IMG_Load '%s': %s\n", source_path, IMG_GetError());
+        return false;
+    }
+    // Resolve the channel order once here instead of guessing from the masks at runtime
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) {
+        fprintf(stderr, "ERROR: Cannot convert '%s' to RGBA: %s\n", source_path, SDL_GetError());
+        return false;
+    }
+
+    TextureContainerHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = TEXTURE_CONTAINER_MAGIC;
+    header.version = TEXTURE_CONTAINER_VERSION;
+    header.width = (uint32_t)surface->w;
+    header.height = (uint32_t)surface->h;
+
+    CookedLevel rgba_levels[TEXTURE_CONTAINER_MAX_LEVELS];
+    CookedLevel output_levels[TEXTURE_CONTAINER_MAX_LEVELS];
+    memset(rgba_levels, 0, sizeof(rgba_levels));
+    memset(output_levels, 0, sizeof(output_levels));
+    bool ok = true;
+
+    // Level 0: tightly packed copy of the surface
+    rgba_levels[0].width = header.width;
+    rgba_levels[0].height = header.height;
+    rgba_levels[0].size = (size_t)header.width * header.height * 4;
+    rgba_levels[0].data = (unsigned char*)malloc(rgba_levels[0].size);
+    if (!rgba_levels[0].data) {
+        SDL_FreeSurface(surface);
+        return false;
+    }
+    SDL_LockSurface(surface);
+    for (uint32_t y = 0; y < header.height; ++y) {
+        memcpy(rgba_levels[0].data + (size_t)y * header.width * 4,
+               (const unsigned char*)surface->pixels + (size_t)y * surface->pitch, (size_t)header.width * 4);
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+
+    bool has_alpha = false;
+    for (size_t i = 3; i < rgba_levels[0].size; i += 4) {
+        if (rgba_levels[0].data[i] != 255) {
+            has_alpha = true;
+            break;
+        }
+    }
+
+    // Mip chain down to 1x1
+    header.level_count = 1;
+    while (ok && header.level_count < TEXTURE_CONTAINER_MAX_LEVELS) {
+        const CookedLevel* previous = &rgba_levels[header.level_count - 1];
+        if (previous->width == 1 && previous->height == 1) break;
+
+        CookedLevel* level = &rgba_levels[header.level_count];
+        level->width = previous->width > 1 ? previous->width / 2 : 1;
+        level->height = previous->height > 1 ? previous->height / 2 : 1;
+        level->size = (size_t)level->width * level->height * 4;
+        level->data = (unsigned char*)malloc(level->size);
+        if (!level->data) {
+            ok = false;
+            break;
+        }
+        downsample_rgba(previous->data, previous->width, previous->height, level->data, level->width, level->height);
+        header.level_count++;
+    }
+
+    if (ok && compress) {
+        header.flags = TEXTURE_CONTAINER_FLAG_COMPRESSED;
+        header.gl_internal_format = has_alpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        for (uint32_t i = 0; ok && i < header.level_count; ++i) {
+            output_levels[i].width = rgba_levels[i].width;
+            output_levels[i].height = rgba_levels[i].height;
+            output_levels[i].size = compressed_level_size(rgba_levels[i].width, rgba_levels[i].height, has_alpha);
+            output_levels[i].data = (unsigned char*)malloc(output_levels[i].size);
+            if (!output_levels[i].data) {
+                ok = false;
+                break;
+            }
+            compress_level(rgba_levels[i].data, rgba_levels[i].width, rgba_levels[i].height, has_alpha, output_levels[i].data);
+        }
+    } else if (ok) {
+        header.gl_internal_format = GL_RGBA8;
+        header.gl_format = GL_RGBA;
+        header.gl_type = GL_UNSIGNED_BYTE;
+    }
+    if (has_alpha) header.flags |= TEXTURE_CONTAINER_FLAG_HAS_ALPHA;
+
+    if (ok) {
+        ok = write_container(output_path, &header, compress ? output_levels : rgba_levels);
+    }
+    if (ok) {
+        printf("[INFO] Cooked '%s' -> '%s' (%ux%u, %u levels, %s)\n", source_path, output_path,
+               header.width, header.height, header.level_count,
+               compress ? (has_alpha ? "DXT5" : "DXT1") : "RGBA8");
+    }
+
+    for (int i = 0; i < TEXTURE_CONTAINER_MAX_LEVELS; ++i) {
+        free(rgba_levels[i].data);
+        free(output_levels[i].data);
+    }
+    return ok;
+}
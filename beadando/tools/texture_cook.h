@@ -0,0 +1,23 @@
+#ifndef TEXTURE_COOK_H
+#define TEXTURE_COOK_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Cooks a source image into a texture container (.tex).
+ * Decodes the image, converts it to RGBA8, builds the full mip chain on the CPU
+ * and writes every level in a GL-ready layout (see texture_container.h).
+ * @param source_path Path of the source image (anything SDL_image can read).
+ * @param output_path Path of the container to write.
+ * @param compress Store the levels as S3TC (DXT1 for opaque, DXT5 for images with alpha).
+ * @return true on success.
+ */
+bool cook_texture(const char* source_path, const char* output_path, bool compress);
+
+/**
+ * @brief Creates the missing parent directories of a file path (like mkdir -p on the dirname).
+ * @return true if the parent directory exists afterwards.
+ */
+bool make_parent_directories(const char* file_path);
+
+#endif /* TEXTURE_COOK_H */